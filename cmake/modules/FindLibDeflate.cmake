@@ -0,0 +1,42 @@
+# - Find libdeflate library
+# Find the native libdeflate includes and library
+# Once done this will define
+#
+#  LIBDEFLATE_INCLUDE_DIR    - Where to find libdeflate.h, etc.
+#  LIBDEFLATE_LIBRARIES      - Libraries to link against to use libdeflate.
+#  LIBDEFLATE_FOUND          - If false, do not try to use libdeflate.
+#
+# also defined, but not for general use are
+#  LIBDEFLATE_LIBRARY        - Where to find the libdeflate library.
+
+if (LIBDEFLATE_INCLUDE_DIR)
+  # Already in cache, be silent
+  set(LIBDEFLATE_FIND_QUIETLY TRUE)
+endif ()
+
+find_path(LIBDEFLATE_INCLUDE_DIR libdeflate.h)
+
+set(LIBDEFLATE_LIBRARY_NAMES_RELEASE ${LIBDEFLATE_LIBRARY_NAMES_RELEASE} ${LIBDEFLATE_LIBRARY_NAMES} deflate libdeflate)
+find_library(LIBDEFLATE_LIBRARY_RELEASE NAMES ${LIBDEFLATE_LIBRARY_NAMES_RELEASE})
+
+# Find a debug library if one exists and use that for debug builds.
+# This really only does anything for win32, but does no harm on other
+# platforms.
+set(LIBDEFLATE_LIBRARY_NAMES_DEBUG ${LIBDEFLATE_LIBRARY_NAMES_DEBUG} deflated libdeflated)
+find_library(LIBDEFLATE_LIBRARY_DEBUG NAMES ${LIBDEFLATE_LIBRARY_NAMES_DEBUG})
+
+include(LibraryDebugAndRelease)
+set_library_from_debug_and_release(LIBDEFLATE)
+
+# handle the QUIETLY and REQUIRED arguments and set LIBDEFLATE_FOUND to TRUE if 
+# all listed variables are TRUE
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LibDeflate DEFAULT_MSG LIBDEFLATE_LIBRARY LIBDEFLATE_INCLUDE_DIR)
+
+if(LIBDEFLATE_FOUND)
+  set(LIBDEFLATE_LIBRARIES ${LIBDEFLATE_LIBRARY})
+else()
+  set(LIBDEFLATE_LIBRARIES)
+endif()
+
+mark_as_advanced(LIBDEFLATE_INCLUDE_DIR LIBDEFLATE_LIBRARY)
@@ -11,6 +11,16 @@
 
 #include <podofo/private/FileSystem.h>
 
+#ifdef _WIN32
+#include <podofo/private/WindowsLeanMean.h>
+#include <podofo/private/utfcpp_extensions.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // _WIN32
+
 using namespace std;
 using namespace PoDoFo;
 
@@ -86,6 +96,8 @@ void seek(TStream& stream, ssize_t pos, SeekDirection direction)
 }
 
 static FILE* createFile(const string_view& filename, FileMode mode, DeviceAccess access);
+static const char* mapFile(const string_view& filepath, size_t& length);
+static void unmapFile(const char* buffer, size_t length);
 
 StreamDevice::StreamDevice(DeviceAccess access)
     : InputStreamDevice(false), OutputStreamDevice(false)
@@ -553,6 +565,279 @@ void FileStreamDevice::close()
     m_file = nullptr;
 }
 
+MappedFileStreamDevice::MappedFileStreamDevice(const string_view& filepath) :
+    StreamDevice(DeviceAccess::Read),
+    m_Position(0),
+    m_Filepath(filepath)
+{
+    m_buffer = mapFile(filepath, m_Length);
+}
+
+MappedFileStreamDevice::~MappedFileStreamDevice()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // Do nothing, it should not throw
+    }
+}
+
+size_t MappedFileStreamDevice::GetLength() const
+{
+    return m_Length;
+}
+
+size_t MappedFileStreamDevice::GetPosition() const
+{
+    return m_Position;
+}
+
+bool MappedFileStreamDevice::CanSeek() const
+{
+    return true;
+}
+
+bool MappedFileStreamDevice::Eof() const
+{
+    return m_Position == m_Length;
+}
+
+void MappedFileStreamDevice::writeBuffer(const char* buffer, size_t size)
+{
+    (void)buffer;
+    (void)size;
+    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Unsupported write operation on a mapped file");
+}
+
+size_t MappedFileStreamDevice::readBuffer(char* buffer, size_t size, bool& eof)
+{
+    size_t readCount = std::min(size, m_Length - m_Position);
+    if (readCount == 0)
+    {
+        // Empty files are not mapped at all
+        eof = true;
+        return 0;
+    }
+
+    std::memcpy(buffer, m_buffer + m_Position, readCount);
+    m_Position += readCount;
+    eof = m_Position == m_Length;
+    return readCount;
+}
+
+bool MappedFileStreamDevice::readChar(char& ch)
+{
+    if (m_Position == m_Length)
+    {
+        ch = '\0';
+        return false;
+    }
+
+    ch = m_buffer[m_Position];
+    m_Position++;
+    return true;
+}
+
+bool MappedFileStreamDevice::peek(char& ch) const
+{
+    if (m_Position == m_Length)
+    {
+        ch = '\0';
+        return false;
+    }
+
+    ch = m_buffer[m_Position];
+    return true;
+}
+
+void MappedFileStreamDevice::seek(ssize_t offset, SeekDirection direction)
+{
+    m_Position = SeekPosition(m_Position, m_Length, offset, direction);
+}
+
+void MappedFileStreamDevice::close()
+{
+    if (m_buffer == nullptr)
+        return;
+
+    unmapFile(m_buffer, m_Length);
+    m_buffer = nullptr;
+    m_Length = 0;
+    m_Position = 0;
+}
+
+BlockCacheStreamDevice::BlockCacheStreamDevice(size_t length, BlockReadFunc read,
+        size_t blockSize, unsigned cacheSize, unsigned readAhead) :
+    StreamDevice(DeviceAccess::Read),
+    m_read(std::move(read)),
+    m_Length(length),
+    m_Position(0),
+    m_BlockSize(blockSize),
+    m_CacheSize(cacheSize),
+    m_ReadAhead(readAhead),
+    m_current(nullptr),
+    m_ReadCount(0),
+    m_ReadLength(0)
+{
+    if (m_read == nullptr)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidHandle, "The read callback must be valid");
+
+    if (blockSize == 0 || cacheSize == 0)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "The block and the cache sizes must be greater than zero");
+
+    // Leave room in the cache for the missing block
+    if (m_ReadAhead >= m_CacheSize)
+        m_ReadAhead = m_CacheSize - 1;
+}
+
+size_t BlockCacheStreamDevice::GetLength() const
+{
+    return m_Length;
+}
+
+size_t BlockCacheStreamDevice::GetPosition() const
+{
+    return m_Position;
+}
+
+bool BlockCacheStreamDevice::CanSeek() const
+{
+    return true;
+}
+
+bool BlockCacheStreamDevice::Eof() const
+{
+    return m_Position == m_Length;
+}
+
+void BlockCacheStreamDevice::writeBuffer(const char* buffer, size_t size)
+{
+    (void)buffer;
+    (void)size;
+    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Unsupported write operation on a block cache device");
+}
+
+size_t BlockCacheStreamDevice::readBuffer(char* buffer, size_t size, bool& eof)
+{
+    size = std::min(size, m_Length - m_Position);
+    size_t readCount = 0;
+    while (readCount < size)
+    {
+        auto& block = getBlock();
+        size_t offset = m_Position - block.Index * m_BlockSize;
+        size_t count = std::min(size - readCount, block.Data.size() - offset);
+        std::memcpy(buffer + readCount, block.Data.data() + offset, count);
+        readCount += count;
+        m_Position += count;
+    }
+
+    eof = m_Position == m_Length;
+    return readCount;
+}
+
+bool BlockCacheStreamDevice::readChar(char& ch)
+{
+    if (!peek(ch))
+        return false;
+
+    m_Position++;
+    return true;
+}
+
+bool BlockCacheStreamDevice::peek(char& ch) const
+{
+    if (m_Position == m_Length)
+    {
+        ch = '\0';
+        return false;
+    }
+
+    auto& block = getBlock();
+    ch = block.Data[m_Position - block.Index * m_BlockSize];
+    return true;
+}
+
+void BlockCacheStreamDevice::seek(ssize_t offset, SeekDirection direction)
+{
+    m_Position = SeekPosition(m_Position, m_Length, offset, direction);
+}
+
+const BlockCacheStreamDevice::Block& BlockCacheStreamDevice::getBlock() const
+{
+    size_t index = m_Position / m_BlockSize;
+
+    // Sequential reads mostly hit the current block
+    if (m_current != nullptr && m_current->Index == index)
+        return *m_current;
+
+    auto found = m_blockMap.find(index);
+    if (found == m_blockMap.end())
+    {
+        fetchBlocks(index);
+        found = m_blockMap.find(index);
+    }
+    else
+    {
+        // Mark the block as the most recently used
+        m_blocks.splice(m_blocks.begin(), m_blocks, found->second);
+    }
+
+    m_current = &*found->second;
+    return *m_current;
+}
+
+void BlockCacheStreamDevice::fetchBlocks(size_t index) const
+{
+    // Extend the read to the following blocks not cached yet
+    size_t blockCount = (m_Length + m_BlockSize - 1) / m_BlockSize;
+    size_t count = 1;
+    while (count <= m_ReadAhead && index + count < blockCount
+        && m_blockMap.find(index + count) == m_blockMap.end())
+    {
+        count++;
+    }
+
+    size_t offset = index * m_BlockSize;
+    size_t length = std::min(count * m_BlockSize, m_Length - offset);
+    charbuff buffer(length);
+    size_t readLength = 0;
+    while (readLength < length)
+    {
+        size_t read = m_read(offset + readLength, buffer.data() + readLength, length - readLength);
+        m_ReadCount++;
+        if (read == 0)
+            break;
+
+        readLength += std::min(read, length - readLength);
+    }
+
+    m_ReadLength += readLength;
+    if (readLength != length)
+    {
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::UnexpectedEOF,
+            "Unable to read {} bytes at offset {} from the source", length, offset);
+    }
+
+    // Insert the blocks so the requested one is the most recently used
+    m_current = nullptr;
+    for (size_t i = count; i > 0; i--)
+    {
+        size_t blockOffset = (i - 1) * m_BlockSize;
+        m_blocks.push_front(Block{ index + i - 1, charbuff() });
+        m_blocks.front().Data.assign(buffer.data() + blockOffset, std::min(m_BlockSize, length - blockOffset));
+        m_blockMap[index + i - 1] = m_blocks.begin();
+    }
+
+    while (m_blocks.size() > m_CacheSize)
+    {
+        m_blockMap.erase(m_blocks.back().Index);
+        m_blocks.pop_back();
+    }
+}
+
 NullStreamDevice::NullStreamDevice()
     : StreamDevice(DeviceAccess::ReadWrite), m_Length(0), m_Position(0)
 {
@@ -858,3 +1143,91 @@ FILE* createFile(const string_view& filepath, FileMode mode, DeviceAccess access
 
     return stream;
 }
+
+#ifdef _WIN32
+
+const char* mapFile(const string_view& filepath, size_t& length)
+{
+    auto filepath16 = utf8::utf8to16((string)filepath);
+    HANDLE file = CreateFileW((LPCWSTR)filepath16.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Error accessing file {}", filepath);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to determine the length of file {}", filepath);
+    }
+
+    length = (size_t)size.QuadPart;
+    if (length == 0)
+    {
+        // Empty files can't be mapped
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // NOTE: The view keeps a reference to the mapping,
+    // which in turn keeps a reference to the file
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to map file {}", filepath);
+
+    auto ret = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (ret == nullptr)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to map file {}", filepath);
+
+    return ret;
+}
+
+void unmapFile(const char* buffer, size_t length)
+{
+    (void)length;
+    if (!UnmapViewOfFile(buffer))
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to unmap file");
+}
+
+#else // Unix
+
+const char* mapFile(const string_view& filepath, size_t& length)
+{
+    int fd = ::open(string(filepath).data(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Error accessing file {}", filepath);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to determine the length of file {}", filepath);
+    }
+
+    length = (size_t)st.st_size;
+    if (length == 0)
+    {
+        // Empty files can't be mapped
+        ::close(fd);
+        return nullptr;
+    }
+
+    // NOTE: The mapping stays valid after closing the descriptor
+    void* ret = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ret == MAP_FAILED)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to map file {}", filepath);
+
+    return (const char*)ret;
+}
+
+void unmapFile(const char* buffer, size_t length)
+{
+    if (::munmap(const_cast<char*>(buffer), length) != 0)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::IOError, "Failed to unmap file");
+}
+
+#endif // _WIN32
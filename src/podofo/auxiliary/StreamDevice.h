@@ -12,6 +12,9 @@
 #include <fstream>
 #include <cstdio>
 #include <vector>
+#include <list>
+#include <functional>
+#include <unordered_map>
 
 #include "basetypes.h"
 
@@ -140,6 +143,134 @@ private:
     std::string m_Filepath;
 };
 
+/** A read only device that maps an existing file in memory
+ *
+ * Reading, peeking and seeking operate directly on the
+ * mapped pages, without going through the C stdio library
+ * \remarks The file must not be truncated while it's mapped: reading
+ * the pages past the new end of the file raises a SIGBUS signal
+ * on POSIX systems, which can't be reported as a PdfError
+ */
+class PODOFO_API MappedFileStreamDevice : public StreamDevice
+{
+public:
+    /** Map for reading the supplied filepath
+     */
+    MappedFileStreamDevice(const std::string_view& filepath);
+
+    ~MappedFileStreamDevice();
+
+public:
+    const std::string& GetFilepath() const { return m_Filepath; }
+
+    /** Get a view of the whole mapped file
+     */
+    bufferview GetView() const { return bufferview(m_buffer, m_Length); }
+
+    size_t GetLength() const override;
+
+    size_t GetPosition() const override;
+
+    bool CanSeek() const override;
+
+    bool Eof() const override;
+
+protected:
+    void writeBuffer(const char* buffer, size_t size) override;
+    size_t readBuffer(char* buffer, size_t size, bool& eof) override;
+    bool readChar(char& ch) override;
+    bool peek(char& ch) const override;
+    void seek(ssize_t offset, SeekDirection direction) override;
+    void close() override;
+
+private:
+    const char* m_buffer;
+    size_t m_Length;
+    size_t m_Position;
+    std::string m_Filepath;
+};
+
+/** Callback reading a range of a source, eg. with a HTTP range request
+ * \param offset the offset in the source where to start reading
+ * \param buffer the buffer where to write the data
+ * \param size the count of bytes to read
+ * \returns the count of bytes actually read
+ */
+using BlockReadFunc = std::function<size_t(size_t offset, char* buffer, size_t size)>;
+
+/** A read only device that fetches fixed size blocks of a source
+ * on demand, keeping the most recently used ones in a cache
+ *
+ * It's suitable to open documents stored remotely without
+ * downloading them as a whole, as objects are loaded on demand
+ * when the document is parsed by PdfMemDocument
+ */
+class PODOFO_API BlockCacheStreamDevice : public StreamDevice
+{
+public:
+    /**
+     * \param length the total length of the source
+     * \param read the callback reading a range of the source
+     * \param blockSize the size of the blocks read from the source
+     * \param cacheSize the maximum count of blocks kept in memory
+     * \param readAhead the count of blocks fetched in the same
+     *     read following a missing one, if not already cached
+     */
+    BlockCacheStreamDevice(size_t length, BlockReadFunc read,
+        size_t blockSize = 64 * 1024, unsigned cacheSize = 64, unsigned readAhead = 1);
+
+public:
+    /** Get the count of reads done on the source so far
+     */
+    unsigned GetReadCount() const { return m_ReadCount; }
+
+    /** Get the count of bytes read from the source so far
+     */
+    size_t GetReadLength() const { return m_ReadLength; }
+
+    size_t GetLength() const override;
+
+    size_t GetPosition() const override;
+
+    bool CanSeek() const override;
+
+    bool Eof() const override;
+
+protected:
+    void writeBuffer(const char* buffer, size_t size) override;
+    size_t readBuffer(char* buffer, size_t size, bool& eof) override;
+    bool readChar(char& ch) override;
+    bool peek(char& ch) const override;
+    void seek(ssize_t offset, SeekDirection direction) override;
+
+private:
+    struct Block
+    {
+        size_t Index;
+        charbuff Data;
+    };
+
+    using BlockList = std::list<Block>;
+
+    // Get the block containing the current position,
+    // fetching it if needed. The position must be valid
+    const Block& getBlock() const;
+    void fetchBlocks(size_t index) const;
+
+private:
+    BlockReadFunc m_read;
+    size_t m_Length;
+    size_t m_Position;
+    size_t m_BlockSize;
+    unsigned m_CacheSize;
+    unsigned m_ReadAhead;
+    mutable BlockList m_blocks; // Most recently used first
+    mutable std::unordered_map<size_t, BlockList::iterator> m_blockMap;
+    mutable const Block* m_current;
+    mutable unsigned m_ReadCount;
+    mutable size_t m_ReadLength;
+};
+
 template <typename TContainer>
 class ContainerStreamDevice : public StreamDevice
 {
@@ -244,6 +375,10 @@ public:
         DeviceAccess access = DeviceAccess::ReadWrite);
 
 public:
+    /** Get a view of the whole underlying buffer
+     */
+    bufferview GetView() const { return bufferview(m_buffer, m_Length); }
+
     size_t GetLength() const override;
 
     size_t GetPosition() const override;
@@ -115,7 +115,7 @@ bool PdfContentStreamReader::tryReadNextContent(PdfContent& content)
 {
     while (true)
     {
-        bool gotToken = m_tokenizer.TryReadNext(*m_inputs.back().Device, m_temp.PsType, content.Keyword, m_temp.Variant);
+        bool gotToken = m_tokenizer.TryReadNext(*m_inputs.back().Device, m_temp.PsType, content.Keyword, content.Stack);
         if (!gotToken)
         {
             content.Type = PdfContentType::Unknown;
@@ -149,7 +149,7 @@ bool PdfContentStreamReader::tryReadNextContent(PdfContent& content)
             }
             case PdfPostScriptTokenType::Variant:
             {
-                content.Stack.Push(std::move(m_temp.Variant));
+                // The operand was pushed to the stack by the tokenizer
                 continue;
             }
             case PdfPostScriptTokenType::ProcedureEnter:
@@ -331,9 +331,15 @@ bool PdfContentStreamReader::tryHandleXObject(PdfContent& content)
     bool followFormXObjecs = (m_args.Flags & PdfContentReaderFlags::SkipFollowFormXObjects) == PdfContentReaderFlags::None;
     bool handleXObjects = (m_args.Flags & PdfContentReaderFlags::SkipHandleNonFormXObjects) == PdfContentReaderFlags::None;
     if (content.Stack.GetSize() != 1
-        || !content.Stack[0].TryGetName(content.Name)
-        || (resources = m_inputs.back().Canvas->GetResources()) == nullptr
-        || (xobjraw = resources->GetResource(PdfResourceType::XObject, *content.Name)) == nullptr)
+        || !content.Stack[0].TryGetName(m_temp.Name))
+    {
+        content.Name = nullptr;
+        goto InvalidXObj;
+    }
+
+    content.Name = &m_temp.Name;
+    if ((resources = m_inputs.back().Canvas->GetResources()) == nullptr
+        || (xobjraw = resources->GetResource(PdfResourceType::XObject, m_temp.Name)) == nullptr)
     {
         goto InvalidXObj;
     }
@@ -11,7 +11,7 @@
 #include "PdfCanvas.h"
 #include "PdfData.h"
 #include "PdfDictionary.h"
-#include "PdfVariantStack.h"
+#include "PdfOperandStack.h"
 #include "PdfPostScriptTokenizer.h"
 
 namespace PoDoFo {
@@ -47,7 +47,7 @@ struct PODOFO_API PdfContent final
 {
     PdfContentType Type = PdfContentType::Unknown;
     PdfContentWarnings Warnings = PdfContentWarnings::None;
-    PdfVariantStack Stack;
+    PdfOperandStack Stack;
     PdfOperator Operator = PdfOperator::Unknown;
     std::string_view Keyword;
     PdfDictionary InlineImageDictionary;
@@ -10,6 +10,7 @@
 #include "PdfDocument.h"
 #include "PdfObject.h"
 #include "PdfIndirectObjectList.h"
+#include <podofo/private/PdfArena.h>
 
 using namespace PoDoFo;
 
@@ -20,6 +21,16 @@ PdfDataContainer::PdfDataContainer()
 
 PdfDataContainer::~PdfDataContainer() { }
 
+void* PdfDataContainer::operator new(size_t size)
+{
+    return PdfArena::Allocate(size);
+}
+
+void PdfDataContainer::operator delete(void* ptr) noexcept
+{
+    PdfArena::Deallocate(ptr);
+}
+
 void PdfDataContainer::SetOwner(PdfObject& owner)
 {
     m_Owner = &owner;
@@ -35,6 +35,13 @@ private:
 public:
     virtual ~PdfDataContainer();
 
+    // Custom allocation functions, so dictionaries and arrays can be allocated
+    // in the arena of the document being loaded
+    static void* operator new(size_t size);
+    static void* operator new(size_t, void* ptr) noexcept { return ptr; }
+    static void operator delete(void* ptr) noexcept;
+    static void operator delete(void*, void*) noexcept { }
+
     /** \returns a pointer to a PdfObject that is the
      *           owner of this data type.
      *           Might be nullptr if the data type has no owner.
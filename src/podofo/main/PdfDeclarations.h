@@ -153,6 +153,7 @@ enum class PdfWriteFlags
     NoFlateCompress = 4,
     PdfAPreserve = 8,      ///< Preserve PDFA compliance during writing (NOTE: it does not itself convert the document to PDF/A)
     SkipDelimiters = 16,   ///< Skip delimiters in serialization of strings and outer dictionaries/arrays
+    HexStrings = 32,       ///< Write all strings in hexadecimal form, so their length doesn't depend on the contents
 };
 
 /**
@@ -490,6 +491,28 @@ enum class PdfSaveOptions
      * a regular save operation
      */
     SaveOnSigning = 64,
+    /** Pack objects without streams in flate compressed
+     * object streams, and write a XRef stream. It requires PDF 1.5
+     * \remarks It has no effect on incremental updates
+     * \see PdfMemDocument::SetObjectStreamSize
+     */
+    CompressObjects = 128,
+    /** Flate compress the streams on multiple threads before
+     * serializing the document. The output is identical to
+     * the one produced by compressing the streams while writing
+     * \remarks Only streams with data held in memory are
+     * compressed in advance
+     */
+    ParallelCompress = 256,
+    /** Write a linearized ("Fast Web View") document, see
+     * ISO 32000-2:2020 Annex F. The objects are renumbered and
+     * reordered so the first page can be displayed before the
+     * whole file is read
+     * \remarks Classic XRef tables are always written, so
+     * CompressObjects is ignored. It has no effect on incremental
+     * updates or documents with no pages
+     */
+    Linearize = 512,
 
     /**
       * \deprecated Use NoMetadataUpdate instead
@@ -497,6 +520,35 @@ enum class PdfSaveOptions
     NoModifyDateUpdate = NoMetadataUpdate
 };
 
+/** The default maximum number of objects packed in
+ *  a single object stream, see PdfSaveOptions::CompressObjects
+ */
+constexpr unsigned PdfObjectStreamSizeDefault = 100;
+
+/** Strategy used by the Flate compressor. The values
+ * match the zlib Z_DEFAULT_STRATEGY, Z_FILTERED, etc. constants
+ */
+enum class PdfFlateStrategy : uint8_t
+{
+    Default = 0,     ///< Use the default strategy, suitable for general data
+    Filtered = 1,    ///< Tuned for data produced by a filter or predictor
+    HuffmanOnly = 2, ///< Huffman encoding only, no string matching
+    RLE = 3,         ///< Limit match distances to one, fast for PNG image data
+    Fixed = 4,       ///< Don't use dynamic Huffman codes
+};
+
+/** Parameters of the Flate compression of streams
+ * \see PdfDocument::SetFlateParams
+ * \see PdfObjectStream::SetFlateParams
+ */
+struct PODOFO_API PdfFlateParams final
+{
+    int8_t Level = -1;          ///< Compression level, from 0 (none) to 9 (best). -1 selects the zlib default
+    PdfFlateStrategy Strategy = PdfFlateStrategy::Default;
+    uint8_t WindowBits = 15;    ///< Base two logarithm of the window size, from 9 to 15
+    uint8_t MemLevel = 8;       ///< Memory used for the compression state, from 1 to 9
+};
+
 enum class PdfAdditionalMetadata : uint8_t
 {
     PdfAIdAmd = 1,
@@ -9,6 +9,7 @@
 
 #include <podofo/auxiliary/OutputDevice.h>
 #include <podofo/auxiliary/StreamDevice.h>
+#include <podofo/private/PdfArena.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -16,13 +17,13 @@ using namespace PoDoFo;
 PdfDictionary::PdfDictionary() { }
 
 PdfDictionary::PdfDictionary(const PdfDictionary& rhs)
-    : m_Map(rhs.m_Map)
 {
+    copyEntriesFrom(rhs);
     setChildrenParent();
 }
 
 PdfDictionary::PdfDictionary(PdfDictionary&& rhs) noexcept
-    : m_Map(std::move(rhs.m_Map))
+    : m_Entries(std::move(rhs.m_Entries))
 {
     setChildrenParent();
     rhs.SetDirty();
@@ -31,7 +32,7 @@ PdfDictionary::PdfDictionary(PdfDictionary&& rhs) noexcept
 PdfDictionary& PdfDictionary::operator=(const PdfDictionary& rhs)
 {
     AssertMutable();
-    m_Map = rhs.m_Map;
+    copyEntriesFrom(rhs);
     setChildrenParent();
     return *this;
 }
@@ -39,7 +40,7 @@ PdfDictionary& PdfDictionary::operator=(const PdfDictionary& rhs)
 PdfDictionary& PdfDictionary::operator=(PdfDictionary&& rhs) noexcept
 {
     AssertMutable();
-    m_Map = std::move(rhs.m_Map);
+    m_Entries = std::move(rhs.m_Entries);
     setChildrenParent();
     rhs.SetDirty();
     return *this;
@@ -51,7 +52,10 @@ bool PdfDictionary::operator==(const PdfDictionary& rhs) const
         return true;
 
     // We don't check owner
-    return m_Map == rhs.m_Map;
+    return std::equal(m_Entries.begin(), m_Entries.end(), rhs.m_Entries.begin(), rhs.m_Entries.end(),
+        [](const unique_ptr<PdfDictionaryEntry>& lhs, const unique_ptr<PdfDictionaryEntry>& rhs) {
+            return *lhs == *rhs;
+        });
 }
 
 bool PdfDictionary::operator!=(const PdfDictionary& rhs) const
@@ -60,15 +64,15 @@ bool PdfDictionary::operator!=(const PdfDictionary& rhs) const
         return true;
 
     // We don't check owner
-    return m_Map != rhs.m_Map;
+    return !(*this == rhs);
 }
 
 void PdfDictionary::Clear()
 {
     AssertMutable();
-    if (!m_Map.empty())
+    if (!m_Entries.empty())
     {
-        m_Map.clear();
+        m_Entries.clear();
         SetDirty();
     }
 }
@@ -111,7 +115,7 @@ PdfObject& PdfDictionary::AddKeyIndirectSafe(const PdfName& key, const PdfObject
 PdfObject& PdfDictionary::addKey(const PdfName& key, PdfObject&& obj)
 {
     // NOTE: Empty PdfNames are legal. Don't check for it
-    pair<iterator, bool> inserted = m_Map.try_emplace(key, std::move(obj));
+    auto inserted = tryEmplace(key, std::move(obj));
     if (inserted.second)
     {
         SetDirty();
@@ -132,7 +136,7 @@ PdfObject& PdfDictionary::addKey(const PdfName& key, PdfObject&& obj)
 void PdfDictionary::AddKeyNoDirtySet(const PdfName& key, PdfVariant&& var)
 {
     // NOTE: Empty PdfNames are legal. Don't check for it
-    pair<iterator, bool> inserted = m_Map.try_emplace(key, std::move(var));
+    auto inserted = tryEmplace(key, std::move(var));
     if (!inserted.second)
         inserted.first->second.AssignNoDirtySet(std::move(var));
 
@@ -142,7 +146,7 @@ void PdfDictionary::AddKeyNoDirtySet(const PdfName& key, PdfVariant&& var)
 void PdfDictionary::AddKeyNoDirtySet(const PdfName& key, PdfObject&& obj)
 {
     // NOTE: Empty PdfNames are legal. Don't check for it
-    pair<iterator, bool> inserted = m_Map.try_emplace(key, std::move(obj));
+    auto inserted = tryEmplace(key, std::move(obj));
     if (!inserted.second)
         inserted.first->second.AssignNoDirtySet(std::move(obj));
 
@@ -151,26 +155,73 @@ void PdfDictionary::AddKeyNoDirtySet(const PdfName& key, PdfObject&& obj)
 
 void PdfDictionary::RemoveKeyNoDirtySet(const string_view& key)
 {
-    auto found = m_Map.find(key);
-    if (found == m_Map.end())
-        return;
-
-    m_Map.erase(found);
+    (void)removeKey(key);
 }
 
 PdfObject& PdfDictionary::EmplaceNoDirtySet(const PdfName& key)
 {
-    return m_Map.emplace(key, nullptr).first->second;
+    return tryEmplace(key, nullptr).first->second;
+}
+
+// Insert a new entry, keeping the entries sorted, unless
+// an entry with the same key already exists
+template <typename TValue>
+pair<PdfDictionaryEntry*, bool> PdfDictionary::tryEmplace(const PdfName& key, TValue&& value)
+{
+    auto it = lowerBound(key.GetRawData());
+    if (it != m_Entries.end() && (*it)->first.GetRawData() == key.GetRawData())
+        return { it->get(), false };
+
+    unique_ptr<PdfDictionaryEntry> entry(new PdfDictionaryEntry(key, std::forward<TValue>(value)));
+    auto ret = entry.get();
+    m_Entries.insert(it, std::move(entry));
+    return { ret, true };
+}
+
+PdfDictionaryEntries::iterator PdfDictionary::lowerBound(const string_view& key) const
+{
+    auto& entries = const_cast<PdfDictionaryEntries&>(m_Entries);
+    return std::lower_bound(entries.begin(), entries.end(), key,
+        [](const unique_ptr<PdfDictionaryEntry>& entry, const string_view& key) {
+            return entry->first.GetRawData() < key;
+        });
+}
+
+PdfDictionaryEntry* PdfDictionary::find(const string_view& key) const
+{
+    auto it = lowerBound(key);
+    if (it == m_Entries.end() || (*it)->first.GetRawData() != key)
+        return nullptr;
+
+    return it->get();
+}
+
+bool PdfDictionary::removeKey(const string_view& key)
+{
+    auto it = lowerBound(key);
+    if (it == m_Entries.end() || (*it)->first.GetRawData() != key)
+        return false;
+
+    m_Entries.erase(it);
+    return true;
+}
+
+void PdfDictionary::copyEntriesFrom(const PdfDictionary& rhs)
+{
+    m_Entries.clear();
+    m_Entries.reserve(rhs.m_Entries.size());
+    for (auto& entry : rhs.m_Entries)
+        m_Entries.emplace_back(new PdfDictionaryEntry(entry->first, entry->second));
 }
 
 PdfObject* PdfDictionary::getKey(const string_view& key) const
 {
     // NOTE: Empty PdfNames are legal. Don't check for it
-    auto it = m_Map.find(key);
-    if (it == m_Map.end())
+    auto entry = find(key);
+    if (entry == nullptr)
         return nullptr;
 
-    return &const_cast<PdfObject&>(it->second);
+    return &entry->second;
 }
 
 PdfObject* PdfDictionary::findKey(const string_view& key) const
@@ -214,17 +265,15 @@ PdfObject* PdfDictionary::findKeyParent(const string_view& key) const
 bool PdfDictionary::HasKey(const string_view& key) const
 {
     // NOTE: Empty PdfNames are legal. Don't check for it
-    return m_Map.find(key) != m_Map.end();
+    return find(key) != nullptr;
 }
 
 bool PdfDictionary::RemoveKey(const string_view& key)
 {
     AssertMutable();
-    iterator found = m_Map.find(key);
-    if (found == m_Map.end())
+    if (!removeKey(key))
         return false;
 
-    m_Map.erase(found);
     SetDirty();
 
     return true;
@@ -264,7 +313,7 @@ void PdfDictionary::write(OutputStream& device, PdfWriteFlags writeMode, bool ad
             device.Write('\n');
     }
 
-    for (auto& pair : m_Map)
+    for (auto& pair : *this)
     {
         if (pair.first != "Type")
         {
@@ -285,15 +334,15 @@ void PdfDictionary::write(OutputStream& device, PdfWriteFlags writeMode, bool ad
 void PdfDictionary::resetDirty()
 {
     // Propagate state to all sub objects
-    for (auto& pair : m_Map)
-        pair.second.ResetDirty();
+    for (auto& entry : m_Entries)
+        entry->second.ResetDirty();
 }
 
 void PdfDictionary::setChildrenParent()
 {
     // Set parent for all children
-    for (auto& pair : m_Map)
-        pair.second.SetParent(*this);
+    for (auto& entry : m_Entries)
+        entry->second.SetParent(*this);
 }
 
 const PdfObject* PdfDictionary::GetKey(const string_view& key) const
@@ -364,7 +413,7 @@ PdfObject& PdfDictionary::MustFindKeyParent(const string_view& key)
 
 unsigned PdfDictionary::GetSize() const
 {
-    return (unsigned)m_Map.size();
+    return (unsigned)m_Entries.size();
 }
 
 PdfDictionaryIndirectIterable PdfDictionary::GetIndirectIterator()
@@ -399,26 +448,46 @@ PdfObject& PdfDictionary::MustGetKey(const string_view& key)
 PdfDictionary::iterator PdfDictionary::begin()
 {
     AssertMutable();
-    return m_Map.begin();
+    return iterator(m_Entries.begin());
 }
 
 PdfDictionary::iterator PdfDictionary::end()
 {
     AssertMutable();
-    return m_Map.end();
+    return iterator(m_Entries.end());
 }
 
 PdfDictionary::const_iterator PdfDictionary::begin() const
 {
-    return m_Map.begin();
+    return const_iterator(m_Entries.begin());
 }
 
 PdfDictionary::const_iterator PdfDictionary::end() const
 {
-    return m_Map.end();
+    return const_iterator(m_Entries.end());
 }
 
 size_t PdfDictionary::size() const
 {
-    return m_Map.size();
+    return m_Entries.size();
+}
+
+void* PdfDictionaryEntry::operator new(size_t size)
+{
+    return PdfArena::Allocate(size);
+}
+
+void PdfDictionaryEntry::operator delete(void* ptr) noexcept
+{
+    PdfArena::Deallocate(ptr);
+}
+
+bool PdfDictionaryEntry::operator==(const PdfDictionaryEntry& rhs) const
+{
+    return first == rhs.first && second == rhs.second;
+}
+
+bool PdfDictionaryEntry::operator!=(const PdfDictionaryEntry& rhs) const
+{
+    return first != rhs.first || second != rhs.second;
 }
@@ -14,6 +14,86 @@ namespace PoDoFo {
 
 class PdfDictionary;
 
+/**
+ * A key/value entry of a PdfDictionary. The members are named
+ * after the ones of std::pair, so the entries can be iterated
+ * like the ones of a std::map
+ */
+class PODOFO_API PdfDictionaryEntry final
+{
+    friend class PdfDictionary;
+
+private:
+    template <typename TValue>
+    PdfDictionaryEntry(const PdfName& key, TValue&& value)
+        : first(key), second(std::forward<TValue>(value)) { }
+
+public:
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr) noexcept;
+
+public:
+    bool operator==(const PdfDictionaryEntry& rhs) const;
+    bool operator!=(const PdfDictionaryEntry& rhs) const;
+
+public:
+    const PdfName first;
+    PdfObject second;
+
+private:
+    PdfDictionaryEntry(const PdfDictionaryEntry&) = delete;
+    PdfDictionaryEntry& operator=(const PdfDictionaryEntry&) = delete;
+};
+
+/** The storage of PdfDictionary: a flat vector of entries sorted by
+ * key. Most dictionaries have just a few keys, so searching a contiguous
+ * vector is faster than walking a tree. The entries are allocated
+ * separately, so the values keep their address when keys are added
+ */
+using PdfDictionaryEntries = std::vector<std::unique_ptr<PdfDictionaryEntry>>;
+
+/**
+ * Iterator over the entries of a PdfDictionary
+ */
+template <typename TEntry, typename TVectorIterator>
+class PdfDictionaryIteratorBase final
+{
+    friend class PdfDictionary;
+    template <typename, typename>
+    friend class PdfDictionaryIteratorBase;
+
+public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = TEntry;
+    using pointer = TEntry*;
+    using reference = TEntry&;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+public:
+    PdfDictionaryIteratorBase() { }
+
+    template <typename TOtherEntry, typename TOtherVectorIterator>
+    PdfDictionaryIteratorBase(const PdfDictionaryIteratorBase<TOtherEntry, TOtherVectorIterator>& rhs)
+        : m_iterator(rhs.m_iterator) { }
+
+private:
+    PdfDictionaryIteratorBase(const TVectorIterator& iterator)
+        : m_iterator(iterator) { }
+
+public:
+    bool operator==(const PdfDictionaryIteratorBase& rhs) const { return m_iterator == rhs.m_iterator; }
+    bool operator!=(const PdfDictionaryIteratorBase& rhs) const { return m_iterator != rhs.m_iterator; }
+    PdfDictionaryIteratorBase& operator++() { m_iterator++; return *this; }
+    PdfDictionaryIteratorBase operator++(int) { auto copy = *this; m_iterator++; return copy; }
+    PdfDictionaryIteratorBase& operator--() { m_iterator--; return *this; }
+    PdfDictionaryIteratorBase operator--(int) { auto copy = *this; m_iterator--; return copy; }
+    reference operator*() const { return **m_iterator; }
+    pointer operator->() const { return m_iterator->get(); }
+
+private:
+    TVectorIterator m_iterator;
+};
+
 /**
  * Helper class to iterate through indirect objects
  */
@@ -67,8 +147,11 @@ private:
     PdfDictionary* m_dict;
 };
 
-using PdfDictionaryIndirectIterable = PdfDictionaryIndirectIterableBase<PdfObject, PdfNameMap<PdfObject>::iterator>;
-using PdfDictionaryConstIndirectIterable = PdfDictionaryIndirectIterableBase<const PdfObject, PdfNameMap<PdfObject>::const_iterator>;
+using PdfDictionaryIterator = PdfDictionaryIteratorBase<PdfDictionaryEntry, PdfDictionaryEntries::iterator>;
+using PdfDictionaryConstIterator = PdfDictionaryIteratorBase<const PdfDictionaryEntry, PdfDictionaryEntries::const_iterator>;
+
+using PdfDictionaryIndirectIterable = PdfDictionaryIndirectIterableBase<PdfObject, PdfDictionaryIterator>;
+using PdfDictionaryConstIndirectIterable = PdfDictionaryIndirectIterableBase<const PdfObject, PdfDictionaryConstIterator>;
 
 /** The PDF dictionary data type of PoDoFo (inherits from PdfDataContainer,
  * the base class for such representations)
@@ -311,7 +394,7 @@ public:
         const PdfStatefulEncrypt* encrypt, charbuff& buffer) const override;
 
     /**
-     * \returns the size of the internal map
+     * \returns the number of keys in the dictionary
      */
     unsigned GetSize() const;
 
@@ -320,8 +403,8 @@ public:
     PdfDictionaryConstIndirectIterable GetIndirectIterator() const;
 
 public:
-    using iterator = PdfNameMap<PdfObject>::iterator;
-    using const_iterator = PdfNameMap<PdfObject>::const_iterator;
+    using iterator = PdfDictionaryIterator;
+    using const_iterator = PdfDictionaryConstIterator;
 
 public:
     iterator begin();
@@ -344,6 +427,12 @@ private:
 
 private:
     PdfObject& addKey(const PdfName& key, PdfObject&& obj);
+    template <typename TValue>
+    std::pair<PdfDictionaryEntry*, bool> tryEmplace(const PdfName& key, TValue&& value);
+    PdfDictionaryEntries::iterator lowerBound(const std::string_view& key) const;
+    PdfDictionaryEntry* find(const std::string_view& key) const;
+    bool removeKey(const std::string_view& key);
+    void copyEntriesFrom(const PdfDictionary& rhs);
     PdfObject* getKey(const std::string_view& key) const;
     PdfObject* findKey(const std::string_view& key) const;
     PdfObject* findKeyParent(const std::string_view& key) const;
@@ -351,7 +440,7 @@ private:
         const PdfStatefulEncrypt* encrypt, charbuff& buffer) const;
 
 private:
-    PdfNameMap<PdfObject> m_Map;
+    PdfDictionaryEntries m_Entries;
 };
 
 template<typename T>
@@ -6,6 +6,7 @@
 
 #include <podofo/private/PdfDeclarationsPrivate.h>
 #include <podofo/private/XMPUtils.h>
+#include <podofo/private/PdfFiltersImpl.h>
 #include "PdfDocument.h"
 
 #include "PdfExtGState.h"
@@ -27,7 +28,8 @@ PdfDocument::PdfDocument(bool empty) :
 PdfDocument::PdfDocument(const PdfDocument& doc) :
     m_Objects(*this, doc.m_Objects),
     m_Metadata(*this),
-    m_FontManager(*this)
+    m_FontManager(*this),
+    m_FlateParams(doc.m_FlateParams)
 {
     SetTrailer(std::make_unique<PdfObject>(doc.GetTrailer().GetObject()));
     Init();
@@ -738,6 +740,12 @@ const PdfOutlines& PdfDocument::MustGetOutlines() const
     return **m_Outlines;
 }
 
+void PdfDocument::SetFlateParams(const PdfFlateParams& params)
+{
+    PdfFlateFilter::ValidateParams(params);
+    m_FlateParams = params;
+}
+
 PdfDocumentFieldIterable PdfDocument::GetFieldsIterator()
 {
     return PdfDocumentFieldIterable(*this);
@@ -150,6 +150,21 @@ public:
 
     void CollectGarbage();
 
+    /** Extract text from a range of pages, running the extraction
+     *  of the pages concurrently on multiple threads
+     *
+     *  The objects, content streams and fonts used by the pages are
+     *  loaded before starting the threads, so they are then only read
+     *  \param entries the extracted entries are appended here in page order
+     *  \param pageIndex index of the first page
+     *  \param pageCount count of pages. It's limited to the pages in the document
+     *  \param threadCount the count of threads to use, 0 to use the hardware concurrency
+     *  \remarks The document must not be modified during the extraction. The
+     *  PdfTextExtractParams::AbortCheck callback may be called concurrently
+     */
+    void ExtractTextTo(std::vector<PdfTextEntry>& entries, unsigned pageIndex, unsigned pageCount,
+        const PdfTextExtractParams& params = { }, unsigned threadCount = 0) const;
+
     /** Construct a new PdfImage object
      */
     std::unique_ptr<PdfImage> CreateImage();
@@ -386,6 +401,16 @@ public:
 
     PdfFontManager& GetFonts() { return m_FontManager; }
 
+    /** Set the parameters of the Flate compression of the
+     * document streams, both when writing to them and when
+     * they are compressed on save
+     * \remarks They can be overridden for a single stream
+     * with PdfObjectStream::SetFlateParams
+     */
+    void SetFlateParams(const PdfFlateParams& params);
+
+    const PdfFlateParams& GetFlateParams() const { return m_FlateParams; }
+
 protected:
     /** Set the trailer of this PdfDocument
      *  deleting the old one.
@@ -469,6 +494,7 @@ private:
     std::unique_ptr<PdfAcroForm> m_AcroForm;
     nullable<std::unique_ptr<PdfOutlines>> m_Outlines;
     std::unique_ptr<PdfNameTrees> m_NameTrees;
+    PdfFlateParams m_FlateParams;
 };
 
 template<typename TAction>
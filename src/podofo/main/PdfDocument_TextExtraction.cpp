@@ -0,0 +1,276 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <podofo/private/PdfDeclarationsPrivate.h>
+#include "PdfDocument.h"
+
+#include <thread>
+#include <atomic>
+#include "PdfFont.h"
+#include "PdfXObjectForm.h"
+#include <podofo/private/PdfPassthroughObjectStream.h>
+
+using namespace std;
+using namespace PoDoFo;
+
+namespace
+{
+    // Loads in advance all the state that text extraction would
+    // otherwise load lazily, so the pages can then be extracted
+    // concurrently only reading shared objects, fonts and streams
+    class TextExtractionPreloader final
+    {
+    public:
+        TextExtractionPreloader(const PdfDocument& doc);
+
+    public:
+        void PreloadPage(const PdfPage& page);
+
+    private:
+        void preloadResources(const PdfResources& resources);
+        void preloadObject(const PdfObject& obj);
+        static void preloadStream(const PdfObjectStream& stream);
+        static void preloadFont(const PdfFont& font);
+
+    private:
+        const PdfIndirectObjectList* m_objects;
+        unordered_set<const PdfObject*> m_visitedObjects;
+        unordered_set<const PdfObject*> m_visitedResources;
+        vector<const PdfObject*> m_stack;
+    };
+}
+
+void PdfDocument::ExtractTextTo(vector<PdfTextEntry>& entries, unsigned pageIndex, unsigned pageCount,
+    const PdfTextExtractParams& params, unsigned threadCount) const
+{
+    auto& pages = GetPages();
+    unsigned totalPageCount = pages.GetCount();
+    if (pageIndex > totalPageCount)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Page index {} is out of range", pageIndex);
+
+    pageCount = std::min(pageCount, totalPageCount - pageIndex);
+    if (pageCount == 0)
+        return;
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, thread::hardware_concurrency());
+
+    threadCount = std::min(threadCount, pageCount);
+    vector<const PdfPage*> extractPages(pageCount);
+    for (unsigned i = 0; i < pageCount; i++)
+        extractPages[i] = &pages.GetPageAt(pageIndex + i);
+
+    if (threadCount == 1)
+    {
+        for (auto page : extractPages)
+            page->ExtractTextTo(entries, params);
+
+        return;
+    }
+
+    TextExtractionPreloader preloader(*this);
+    for (auto page : extractPages)
+        preloader.PreloadPage(*page);
+
+    // Pages are picked in order by the first free
+    // thread, so costly pages don't stall the others
+    vector<vector<PdfTextEntry>> pageEntries(pageCount);
+    vector<exception_ptr> errors(threadCount);
+    atomic<unsigned> nextPage(0);
+    auto run = [&](unsigned threadIndex)
+    {
+        try
+        {
+            unsigned i;
+            while ((i = nextPage++) < pageCount)
+                extractPages[i]->ExtractTextTo(pageEntries[i], params);
+        }
+        catch (...)
+        {
+            errors[threadIndex] = std::current_exception();
+            // Make the other threads stop early
+            nextPage = pageCount;
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; i++)
+        threads.emplace_back(run, i);
+
+    // Use also the current thread
+    run(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors)
+    {
+        if (error != nullptr)
+            std::rethrow_exception(error);
+    }
+
+    for (auto& currEntries : pageEntries)
+    {
+        for (auto& entry : currEntries)
+            entries.push_back(std::move(entry));
+    }
+}
+
+TextExtractionPreloader::TextExtractionPreloader(const PdfDocument& doc)
+    : m_objects(&doc.GetObjects()) { }
+
+void TextExtractionPreloader::PreloadPage(const PdfPage& page)
+{
+    auto pageContents = page.GetContents();
+    if (pageContents != nullptr)
+        preloadObject(pageContents->GetObject());
+
+    preloadResources(page.GetResources());
+}
+
+void TextExtractionPreloader::preloadResources(const PdfResources& resources)
+{
+    if (!m_visitedResources.insert(&resources.GetObject()).second)
+        return;
+
+    preloadObject(resources.GetObject());
+
+    // Fonts are created and cached by the document on first use
+    for (auto pair : resources.GetResourceIterator(PdfResourceType::Font))
+    {
+        const PdfFont* font;
+        try
+        {
+            font = resources.GetFont(pair.first);
+        }
+        catch (PdfError&)
+        {
+            // Let the error be reported by the extraction, if the font is used
+            continue;
+        }
+
+        if (font != nullptr)
+            preloadFont(*font);
+    }
+
+    // Form XObjects are followed by the extraction, which reads their
+    // contents and their resources: the fonts they use are preloaded
+    for (auto pair : resources.GetResourceIterator(PdfResourceType::XObject))
+    {
+        unique_ptr<const PdfXObjectForm> form;
+        if (pair.second == nullptr || !PdfXObject::TryCreateFromObject(*pair.second, form))
+        {
+            continue;
+        }
+
+        auto formResources = form->GetResources();
+        if (formResources != nullptr)
+            preloadResources(*formResources);
+    }
+}
+
+// Load all the objects reachable from the given one
+void TextExtractionPreloader::preloadObject(const PdfObject& obj)
+{
+    m_stack.push_back(&obj);
+    while (m_stack.size() != 0)
+    {
+        auto curr = m_stack.back();
+        m_stack.pop_back();
+        if (curr->IsIndirect())
+        {
+            // Load also the stream, which may be a content stream, an
+            // image or a font program that the extraction reads
+            auto stream = curr->GetStream();
+            if (stream != nullptr)
+                preloadStream(*stream);
+        }
+
+        switch (curr->GetDataType())
+        {
+            case PdfDataType::Reference:
+            {
+                auto resolved = m_objects->GetObject(curr->GetReference());
+                if (resolved != nullptr && m_visitedObjects.insert(resolved).second)
+                    m_stack.push_back(resolved);
+
+                break;
+            }
+            case PdfDataType::Dictionary:
+            {
+                for (auto& pair : curr->GetDictionary())
+                {
+                    // Don't climb the page tree
+                    if (pair.first == "Parent")
+                        continue;
+
+                    m_stack.push_back(&pair.second);
+                }
+                break;
+            }
+            case PdfDataType::Array:
+            {
+                for (auto& item : curr->GetArray())
+                    m_stack.push_back(&item);
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+void TextExtractionPreloader::preloadStream(const PdfObjectStream& stream)
+{
+    auto passthrough = dynamic_cast<const PdfPassthroughObjectStream*>(&stream.GetProvider());
+    if (passthrough != nullptr)
+        const_cast<PdfPassthroughObjectStream&>(*passthrough).EnsureConcurrentRead();
+}
+
+void TextExtractionPreloader::preloadFont(const PdfFont& font)
+{
+    // Run the lazy initializations of the font, the encoding and
+    // the metrics that text extraction triggers by scanning a string
+    // with all the codes and querying the space lengths. Scanning all
+    // the codes of two bytes encodings decodes all the pages of
+    // their decode table, so they are never filled concurrently
+    PdfTextState state;
+    state.Font = &font;
+    (void)font.GetWordSpacingLength(state);
+    (void)font.GetSpaceCharLength(state);
+    (void)font.GetMetrics().GetAscent();
+    (void)font.GetMetrics().GetDescent();
+
+    string utf8;
+    vector<double> lengths;
+    vector<unsigned> positions;
+    auto& limits = font.GetEncoding().GetEncodingMap().GetLimits();
+    if (limits.MinCodeSize == 2 && limits.MaxCodeSize == 2)
+    {
+        // Scan a string for each high byte, so a page with
+        // invalid codes doesn't stop filling the others
+        charbuff probe(512);
+        for (unsigned high = 0; high < 256; high++)
+        {
+            for (unsigned low = 0; low < 256; low++)
+            {
+                probe[low * 2] = (char)high;
+                probe[low * 2 + 1] = (char)low;
+            }
+
+            (void)font.TryScanEncodedString(PdfString::FromRaw(probe), state, utf8, lengths, positions);
+        }
+    }
+    else
+    {
+        charbuff probe(256);
+        for (unsigned i = 0; i < 256; i++)
+            probe[i] = (char)i;
+
+        (void)font.TryScanEncodedString(PdfString::FromRaw(probe), state, utf8, lengths, positions);
+    }
+}
@@ -396,7 +396,12 @@ void PdfEncoding::exportToFont(PdfFont& font, const PdfCIDSystemInfo* cidInfo) c
 
 PdfStringScanContext PdfEncoding::StartStringScan(const PdfString& encodedStr)
 {
-    return PdfStringScanContext(encodedStr.GetRawData(), *this);
+    return startStringScan(encodedStr.GetRawData());
+}
+
+PdfStringScanContext PdfEncoding::startStringScan(const string_view& encoded) const
+{
+    return PdfStringScanContext(encoded, *this);
 }
 
 bool PdfEncoding::tryExportEncodingTo(PdfDictionary& dictionary, bool wantCIDMapping) const
@@ -45,6 +45,10 @@ static void AESEncrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned k
 static void RC4Encrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keylen,
     const unsigned char* textin, size_t textlen,
     unsigned char* textout, size_t textoutlen);
+static const EVP_CIPHER* getAESCipher(unsigned keylen);
+static const EVP_CIPHER* getCipher(EVP_CIPHER_CTX* ctx);
+static int initCipher(EVP_CIPHER_CTX* ctx, const EVP_CIPHER* cipher,
+    const unsigned char* key, const unsigned char* iv, int enc);
 
 namespace
 {
@@ -125,7 +129,7 @@ private:
 /** An OutputStream that encrypt all data written
  *  using the RC4 encryption algorithm
  */
-class PdfRC4OutputStream : public OutputStream
+class PdfRC4OutputStream : public PdfEncryptOutputStream
 {
 public:
     PdfRC4OutputStream(OutputStream& outputStream, unsigned char rc4key[256],
@@ -183,6 +187,8 @@ private:
  */
 class PdfAESInputStream : public InputStream
 {
+    static constexpr size_t CHUNK_SIZE = 4096;
+
 public:
     PdfAESInputStream(InputStream& inputStream, size_t inputLen, const unsigned char* key, unsigned keylen) :
         m_InputStream(&inputStream),
@@ -190,7 +196,7 @@ public:
         m_inputEof(false),
         m_init(true),
         m_keyLen(keylen),
-        m_drainLeft(0)
+        m_pendingOffset(0)
     {
         m_ctx = EVP_CIPHER_CTX_new();
         if (m_ctx == nullptr)
@@ -207,89 +213,75 @@ public:
 protected:
     size_t readBuffer(char* buffer, size_t len, bool& eof) override
     {
-        int outlen = 0;
-        size_t drainLen;
-        size_t read;
-        if (m_inputEof)
-            goto DrainBuffer;
+        // The decrypted data doesn't match the encrypted data block
+        // by block, so it's decrypted in chunks and kept pending
+        // until it's fully read
+        while (m_pendingOffset == m_pending.size() && !m_inputEof)
+            decryptChunk();
+
+        size_t count = std::min(len, m_pending.size() - m_pendingOffset);
+        std::memcpy(buffer, m_pending.data() + m_pendingOffset, count);
+        m_pendingOffset += count;
+        eof = m_inputEof && m_pendingOffset == m_pending.size();
+        return count;
+    }
 
+private:
+    void decryptChunk()
+    {
         int rc;
+        bool streameof;
+        size_t read;
         if (m_init)
         {
             // Read the initialization vector separately first
             char iv[AES_IV_LENGTH];
-            bool streameof;
             read = ReadBuffer(*m_InputStream, iv, AES_IV_LENGTH, streameof);
-            if (read != AES_IV_LENGTH)
+            if (read != AES_IV_LENGTH || m_inputLen < AES_IV_LENGTH)
                 PODOFO_RAISE_ERROR_INFO(PdfErrorCode::UnexpectedEOF, "Can't read enough bytes for AES IV");
 
-            const EVP_CIPHER* cipher;
-            switch (m_keyLen)
-            {
-                case (size_t)PdfKeyLength::L128 / 8:
-                {
-                    cipher = ssl::Aes128();
-                    break;
-                }
-                case (size_t)PdfKeyLength::L256 / 8:
-                {
-                    cipher = ssl::Aes256();
-                    break;
-                }
-                default:
-                    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Invalid AES key length");
-            }
-
-            rc = EVP_DecryptInit_ex(m_ctx, cipher, nullptr, m_key, (unsigned char*)iv);
+            rc = EVP_DecryptInit_ex(m_ctx, getAESCipher(m_keyLen), nullptr, m_key, (unsigned char*)iv);
             if (rc != 1)
                 PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing AES encryption engine");
 
             m_inputLen -= AES_IV_LENGTH;
             m_init = false;
+            if (m_inputLen == 0)
+            {
+                // There's no encrypted data, not even padding
+                m_inputEof = true;
+                return;
+            }
         }
 
-        bool streameof;
-        read = ReadBuffer(*m_InputStream, buffer, std::min(len, m_inputLen), streameof);
+        char encrypted[CHUNK_SIZE];
+        streameof = false;
+        read = m_inputLen == 0 ? 0 : ReadBuffer(*m_InputStream, encrypted, std::min(CHUNK_SIZE, m_inputLen), streameof);
         m_inputLen -= read;
 
         // Quote openssl.org: "the decrypted data buffer out passed to EVP_DecryptUpdate() should have sufficient room
         //  for (inl + cipher_block_size) bytes unless the cipher block size is 1 in which case inl bytes is sufficient."
-        // So we need to create a buffer that is bigger than len.
-        m_tempBuffer.resize(len + AES_BLOCK_SIZE);
-        rc = EVP_DecryptUpdate(m_ctx, m_tempBuffer.data(), &outlen, (unsigned char*)buffer, (int)read);
-
+        // The final block requires one more block
+        m_pending.resize(read + 2 * AES_BLOCK_SIZE);
+        m_pendingOffset = 0;
+        int outlen = 0;
+        rc = EVP_DecryptUpdate(m_ctx, m_pending.data(), &outlen, (unsigned char*)encrypted, (int)read);
         if (rc != 1)
             PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-decryption data");
 
-        PODOFO_ASSERT((size_t)outlen <= len);
-        std::memcpy(buffer, m_tempBuffer.data(), (size_t)outlen);
-
-        if (m_inputLen == 0 || streameof)
+        if (m_inputLen == 0 || streameof || read == 0)
         {
             m_inputEof = true;
 
             int drainLeft;
-            rc = EVP_DecryptFinal_ex(m_ctx, m_tempBuffer.data(), &drainLeft);
+            rc = EVP_DecryptFinal_ex(m_ctx, m_pending.data() + outlen, &drainLeft);
             if (rc != 1)
                 PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-decryption data padding");
 
-            m_drainLeft = (size_t)drainLeft;
-            goto DrainBuffer;
+            outlen += drainLeft;
         }
 
-        eof = false;
-        return outlen;
-
-    DrainBuffer:
-        drainLen = std::min(len - outlen, m_drainLeft);
-        std::memcpy(buffer + outlen, m_tempBuffer.data(), drainLen);
-        m_drainLeft -= (int)drainLen;
-        if (m_drainLeft == 0)
-            eof = true;
-        else
-            eof = false;
-
-        return outlen + drainLen;
+        m_pending.resize((size_t)outlen);
     }
 
 private:
@@ -300,8 +292,100 @@ private:
     bool m_init;
     unsigned char m_key[32];
     unsigned m_keyLen;
-    vector<unsigned char> m_tempBuffer;
-    size_t m_drainLeft;
+    vector<unsigned char> m_pending;
+    size_t m_pendingOffset;
+};
+
+/** An OutputStream that encrypts all data written using the
+ *  AES encryption algorithm in CBC mode. The initialization
+ *  vector is written first, while the last padded block is
+ *  written when the stream is closed
+ */
+class PdfAESOutputStream : public PdfEncryptOutputStream
+{
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+public:
+    PdfAESOutputStream(OutputStream& outputStream, const unsigned char* key, unsigned keylen,
+        const unsigned char iv[AES_IV_LENGTH]) :
+        m_OutputStream(&outputStream),
+        m_ivWritten(false)
+    {
+        auto cipher = getAESCipher(keylen);
+        m_ctx = EVP_CIPHER_CTX_new();
+        if (m_ctx == nullptr)
+            PODOFO_RAISE_ERROR(PdfErrorCode::OutOfMemory);
+
+        if (EVP_EncryptInit_ex(m_ctx, cipher, nullptr, key, iv) != 1)
+        {
+            EVP_CIPHER_CTX_free(m_ctx);
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing AES encryption engine");
+        }
+
+        // The IV is written together with the first encrypted
+        // data, since the stream may be created before the
+        // owning object header is written
+        std::memcpy(m_iv, iv, AES_IV_LENGTH);
+    }
+
+    ~PdfAESOutputStream()
+    {
+        EVP_CIPHER_CTX_free(m_ctx);
+    }
+
+protected:
+    void close() override
+    {
+        ensureIVWritten();
+
+        // Write the remaining data with the PKCS#7 padding
+        unsigned char buffer[AES_BLOCK_SIZE];
+        int outlen;
+        if (EVP_EncryptFinal_ex(m_ctx, buffer, &outlen) != 1)
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-encrypting data padding");
+
+        m_OutputStream->Write((const char*)buffer, (size_t)outlen);
+    }
+
+    void writeBuffer(const char* buffer, size_t size) override
+    {
+        // Encrypt in chunks, so the temporary buffer stays small
+        // regardless of the size of the written data
+        ensureIVWritten();
+        unsigned char encrypted[CHUNK_SIZE + AES_BLOCK_SIZE];
+        while (size != 0)
+        {
+            size_t chunkSize = std::min(size, CHUNK_SIZE);
+            int outlen;
+            if (EVP_EncryptUpdate(m_ctx, encrypted, &outlen, (const unsigned char*)buffer, (int)chunkSize) != 1)
+                PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-encrypting data");
+
+            m_OutputStream->Write((const char*)encrypted, (size_t)outlen);
+            buffer += chunkSize;
+            size -= chunkSize;
+        }
+    }
+
+    void flush() override
+    {
+        m_OutputStream->Flush();
+    }
+
+private:
+    void ensureIVWritten()
+    {
+        if (m_ivWritten)
+            return;
+
+        m_OutputStream->Write((const char*)m_iv, AES_IV_LENGTH);
+        m_ivWritten = true;
+    }
+
+private:
+    OutputStream* m_OutputStream;
+    EVP_CIPHER_CTX* m_ctx;
+    unsigned char m_iv[AES_IV_LENGTH];
+    bool m_ivWritten;
 };
 
 struct RC4EncryptContext
@@ -312,6 +396,29 @@ struct RC4EncryptContext
 
 }
 
+PdfEncryptOutputStream::PdfEncryptOutputStream()
+    : m_closed(false) { }
+
+void PdfEncryptOutputStream::Close()
+{
+    if (m_closed)
+        return;
+
+    close();
+    m_closed = true;
+}
+
+void PdfEncryptOutputStream::close()
+{
+    // Do nothing
+}
+
+void PdfEncryptOutputStream::checkWrite() const
+{
+    if (m_closed)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "The encryption stream is closed");
+}
+
 PdfEncrypt::~PdfEncrypt()
 {
     clearSensitiveInfo();
@@ -331,6 +438,7 @@ void PdfEncrypt::EnsureEncryptionInitialized(const PdfString& documentId, PdfEnc
 
     GenerateEncryptionKey(documentId.GetRawData(), context.GetAuthResult(), context.GetCryptCtx(),
         m_uValue, m_oValue, context.m_encryptionKey);
+    context.invalidateObjKey();
     context.m_documentId = documentId.GetRawData();
 
     PODOFO_INVARIANT(!m_initialized);
@@ -345,6 +453,7 @@ void PdfEncrypt::EnsureEncryptionInitialized(const PdfString& documentId, PdfEnc
 void PdfEncrypt::Authenticate(const string_view& password, const PdfString& documentId, PdfEncryptContext& context) const
 {
     context.m_AuthResult = Authenticate(password, documentId.GetRawData(), context.GetCryptCtx(), context.m_encryptionKey);
+    context.invalidateObjKey();
     context.m_documentId = documentId.GetRawData();
 }
 
@@ -615,7 +724,9 @@ PdfEncryptContext::PdfEncryptContext() :
     m_AuthResult(PdfAuthResult::Unkwnon),
     m_cryptCtx(nullptr),
     m_customCtx(nullptr),
-    m_customCtxSize(0)
+    m_customCtxSize(0),
+    m_objKey{ },
+    m_objKeyLength(0)
 {
 }
 
@@ -623,6 +734,7 @@ PdfEncryptContext::~PdfEncryptContext()
 {
     // Clear sensitive information to not leave traces in memory
     std::memset(m_encryptionKey, 0, std::size(m_encryptionKey));
+    std::memset(m_objKey, 0, std::size(m_objKey));
     if (m_customCtx != nullptr)
         std::memset(m_customCtx, 0, m_customCtxSize);
 
@@ -631,10 +743,13 @@ PdfEncryptContext::~PdfEncryptContext()
 }
 
 PdfEncryptContext::PdfEncryptContext(const PdfEncryptContext& rhs) :
+    m_documentId(rhs.m_documentId),
     m_AuthResult(rhs.m_AuthResult),
     m_cryptCtx(nullptr),
     m_customCtx(nullptr),
-    m_customCtxSize(0)
+    m_customCtxSize(0),
+    m_objKey{ },
+    m_objKeyLength(0)
 {
     std::memcpy(m_encryptionKey, rhs.m_encryptionKey, std::size(m_encryptionKey));
     if (rhs.m_customCtx != nullptr)
@@ -647,8 +762,10 @@ PdfEncryptContext::PdfEncryptContext(const PdfEncryptContext& rhs) :
 
 PdfEncryptContext& PdfEncryptContext::operator=(const PdfEncryptContext& rhs)
 {
+    m_documentId = rhs.m_documentId;
     m_AuthResult = rhs.m_AuthResult;
     std::memcpy(m_encryptionKey, rhs.m_encryptionKey, std::size(m_encryptionKey));
+    invalidateObjKey();
     EVP_CIPHER_CTX_free(m_cryptCtx);
     m_cryptCtx = nullptr;
     ::operator delete(m_customCtx);
@@ -680,6 +797,13 @@ EVP_CIPHER_CTX* PdfEncryptContext::GetCryptCtx()
     return m_cryptCtx;
 }
 
+void PdfEncryptContext::invalidateObjKey()
+{
+    std::memset(m_objKey, 0, std::size(m_objKey));
+    m_objKeyRef = { };
+    m_objKeyLength = 0;
+}
+
 PdfEncryptMD5Base::PdfEncryptMD5Base()
 {
 }
@@ -920,6 +1044,19 @@ void PdfEncryptMD5Base::CreateObjKey(unsigned char objkey[16], unsigned& pnKeyLe
     pnKeyLen = (keyLength <= 11) ? keyLength + 5 : 16;
 }
 
+void PdfEncryptMD5Base::GetObjKey(unsigned char objkey[16], unsigned& pnKeyLen,
+    PdfEncryptContext& context, const PdfReference& objref) const
+{
+    if (context.m_objKeyLength == 0 || context.m_objKeyRef != objref)
+    {
+        CreateObjKey(context.m_objKey, context.m_objKeyLength, context.GetEncryptionKey(), objref);
+        context.m_objKeyRef = objref;
+    }
+
+    std::memcpy(objkey, context.m_objKey, MD5_DIGEST_LENGTH);
+    pnKeyLen = context.m_objKeyLength;
+}
+
 void RC4Encrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keylen,
     const unsigned char* textin, size_t textlen,
     unsigned char* textout, size_t textoutlen)
@@ -933,16 +1070,22 @@ void RC4Encrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keylen,
         "legacy providers (e.g. legacy.dll)");
 #endif // OPENSSL_VERSION_MAJOR >= 3
 
-    // Don't set the key because we will modify the parameters
-    int status = EVP_EncryptInit_ex(ctx, ssl::Rc4(), nullptr, nullptr, nullptr);
-    if (status != 1)
-        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing RC4 encryption engine");
-
-    status = EVP_CIPHER_CTX_set_key_length(ctx, keylen);
-    if (status != 1)
-        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing RC4 encryption engine");
+    int status;
+    if (getCipher(ctx) != ssl::Rc4() || EVP_CIPHER_CTX_key_length(ctx) != (int)keylen)
+    {
+        // Don't set the key because we will modify the parameters
+        status = EVP_EncryptInit_ex(ctx, ssl::Rc4(), nullptr, nullptr, nullptr);
+        if (status != 1)
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing RC4 encryption engine");
+
+        status = EVP_CIPHER_CTX_set_key_length(ctx, keylen);
+        if (status != 1)
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing RC4 encryption engine");
+    }
 
-    // We finished modifying parameters so now we can set the key
+    // We finished modifying parameters so now we can set the key.
+    // The context is reused as is when it has been already
+    // set up for RC4 with the same key length
     status = EVP_EncryptInit_ex(ctx, nullptr, nullptr, key, nullptr);
     if (status != 1)
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing RC4 encryption engine");
@@ -1087,7 +1230,7 @@ void PdfEncryptRC4::Encrypt(const char* inStr, size_t inLen, PdfEncryptContext&
 {
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    GetObjKey(objkey, keylen, context, objref);
     RC4Encrypt(context.GetCryptCtx(), objkey, keylen, (const unsigned char*)inStr, inLen,
         (unsigned char*)outStr, outLen);
 }
@@ -1104,7 +1247,7 @@ unique_ptr<InputStream> PdfEncryptRC4::CreateEncryptionInputStream(InputStream&
     (void)inputLen;
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    this->CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    this->GetObjKey(objkey, keylen, context, objref);
     auto& rc4Ctx = context.GetCustomCtx<RC4EncryptContext>();
     return unique_ptr<InputStream>(new PdfRC4InputStream(inputStream, inputLen, rc4Ctx.Rc4key, rc4Ctx.Rc4last, objkey, keylen));
 }
@@ -1188,14 +1331,14 @@ PdfEncryptRC4::PdfEncryptRC4(const string_view& userPassword, const string_view&
     InitFromScratch(userPassword, ownerPassword, algorithm, keyLength, rValue, PERMS_DEFAULT | protection, true);
 }
 
-unique_ptr<OutputStream> PdfEncryptRC4::CreateEncryptionOutputStream(OutputStream& outputStream,
+unique_ptr<PdfEncryptOutputStream> PdfEncryptRC4::CreateEncryptionOutputStream(OutputStream& outputStream,
     PdfEncryptContext& context, const PdfReference& objref) const
 {
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    this->CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    this->GetObjKey(objkey, keylen, context, objref);
     auto& rc4Ctx = context.GetCustomCtx<RC4EncryptContext>();
-    return unique_ptr<OutputStream>(new PdfRC4OutputStream(outputStream, rc4Ctx.Rc4key, rc4Ctx.Rc4last, objkey, keylen));
+    return unique_ptr<PdfEncryptOutputStream>(new PdfRC4OutputStream(outputStream, rc4Ctx.Rc4key, rc4Ctx.Rc4last, objkey, keylen));
 }
 
 void AESDecrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keyLen, const unsigned char* iv,
@@ -1204,14 +1347,7 @@ void AESDecrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keyLen,
     if ((textlen % 16) != 0)
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-decryption data length not a multiple of 16");
 
-    int rc;
-    if (keyLen == (int)PdfKeyLength::L128 / 8)
-        rc = EVP_DecryptInit_ex(ctx, ssl::Aes128(), nullptr, key, iv);
-    else if (keyLen == (int)PdfKeyLength::L256 / 8)
-        rc = EVP_DecryptInit_ex(ctx, ssl::Aes256(), nullptr, key, iv);
-    else
-        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Invalid AES key length");
-
+    int rc = initCipher(ctx, getAESCipher(keyLen), key, iv, 0);
     if (rc != 1)
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing AES decryption engine");
 
@@ -1227,20 +1363,47 @@ void AESDecrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keyLen,
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error AES-decryption data final");
 }
 
+const EVP_CIPHER* getAESCipher(unsigned keylen)
+{
+    switch (keylen)
+    {
+        case (unsigned)PdfKeyLength::L128 / 8:
+            return ssl::Aes128();
+        case (unsigned)PdfKeyLength::L256 / 8:
+            return ssl::Aes256();
+        default:
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Invalid AES key length");
+    }
+}
+
+const EVP_CIPHER* getCipher(EVP_CIPHER_CTX* ctx)
+{
+#if OPENSSL_VERSION_MAJOR >= 3
+    return EVP_CIPHER_CTX_get0_cipher(ctx);
+#else // OPENSSL_VERSION_MAJOR < 3
+    return EVP_CIPHER_CTX_cipher(ctx);
+#endif // OPENSSL_VERSION_MAJOR >= 3
+}
+
+int initCipher(EVP_CIPHER_CTX* ctx, const EVP_CIPHER* cipher,
+    const unsigned char* key, const unsigned char* iv, int enc)
+{
+    // When the context is already set up with the same cipher
+    // just set the key and IV, which avoids recreating the
+    // cipher implementation state for every string or stream
+    if (getCipher(ctx) == cipher)
+        cipher = nullptr;
+
+    return EVP_CipherInit_ex(ctx, cipher, nullptr, key, iv, enc);
+}
+
 void AESEncrypt(EVP_CIPHER_CTX* ctx, const unsigned char* key, unsigned keyLen, const unsigned char* iv,
     const unsigned char* textin, size_t textlen,
     unsigned char* textout, size_t textoutlen)
 {
     (void)textoutlen;
 
-    int rc;
-    if (keyLen == (int)PdfKeyLength::L128 / 8)
-        rc = EVP_EncryptInit_ex(ctx, ssl::Aes128(), nullptr, key, iv);
-    else if (keyLen == (int)PdfKeyLength::L256 / 8)
-        rc = EVP_EncryptInit_ex(ctx, ssl::Aes256(), nullptr, key, iv);
-    else
-        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Invalid AES key length");
-
+    int rc = initCipher(ctx, getAESCipher(keyLen), key, iv, 1);
     if (rc != 1)
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Error initializing AES encryption engine");
 
@@ -1328,7 +1491,7 @@ void PdfEncryptAESV2::Encrypt(const char* inStr, size_t inLen, PdfEncryptContext
 {
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    GetObjKey(objkey, keylen, context, objref);
     size_t offset = CalculateStreamOffset();
     generateInitialVector(context.GetDocumentId(), (unsigned char *)outStr);
     AESEncrypt(context.GetCryptCtx(), objkey, keylen, (unsigned char*)outStr, (const unsigned char*)inStr,
@@ -1340,7 +1503,7 @@ void PdfEncryptAESV2::Decrypt(const char* inStr, size_t inLen, PdfEncryptContext
 {
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    GetObjKey(objkey, keylen, context, objref);
 
     size_t offset = CalculateStreamOffset();
     if (inLen <= offset)
@@ -1391,22 +1554,19 @@ unique_ptr<InputStream> PdfEncryptAESV2::CreateEncryptionInputStream(InputStream
 {
     unsigned char objkey[MD5_DIGEST_LENGTH];
     unsigned keylen;
-    this->CreateObjKey(objkey, keylen, context.GetEncryptionKey(), objref);
+    this->GetObjKey(objkey, keylen, context, objref);
     return unique_ptr<InputStream>(new PdfAESInputStream(inputStream, inputLen, objkey, keylen));
 }
     
-unique_ptr<OutputStream> PdfEncryptAESV2::CreateEncryptionOutputStream(OutputStream& outputStream,
+unique_ptr<PdfEncryptOutputStream> PdfEncryptAESV2::CreateEncryptionOutputStream(OutputStream& outputStream,
     PdfEncryptContext& context, const PdfReference& objref) const
 {
-    (void)outputStream;
-    (void)context;
-    (void)objref;
-    // unsigned char objkey[MD5_DIGEST_LENGTH];
-    // int keylen;
-
-    // this->CreateObjKey( objkey, &keylen );
-
-    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "CreateEncryptionOutputStream does not yet support AESV2");
+    unsigned char objkey[MD5_DIGEST_LENGTH];
+    unsigned keylen;
+    this->GetObjKey(objkey, keylen, context, objref);
+    unsigned char iv[AES_IV_LENGTH];
+    generateInitialVector(context.GetDocumentId(), iv);
+    return unique_ptr<PdfEncryptOutputStream>(new PdfAESOutputStream(outputStream, objkey, keylen, iv));
 }
 
 void PdfEncryptAESV3::computeHash(const unsigned char* pswd, unsigned pswdLen, unsigned revision,
@@ -1900,13 +2060,13 @@ unique_ptr<InputStream> PdfEncryptAESV3::CreateEncryptionInputStream(InputStream
     return unique_ptr<InputStream>(new PdfAESInputStream(inputStream, inputLen, context.GetEncryptionKey(), 32));
 }
 
-unique_ptr<OutputStream> PdfEncryptAESV3::CreateEncryptionOutputStream(OutputStream& outputStream,
+unique_ptr<PdfEncryptOutputStream> PdfEncryptAESV3::CreateEncryptionOutputStream(OutputStream& outputStream,
     PdfEncryptContext& context, const PdfReference& objref) const
 {
-    (void)outputStream;
-    (void)context;
     (void)objref;
-    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "CreateEncryptionOutputStream does not yet support AESV3");
+    unsigned char iv[AES_IV_LENGTH];
+    generateInitialVector(iv);
+    return unique_ptr<PdfEncryptOutputStream>(new PdfAESOutputStream(outputStream, context.GetEncryptionKey(), 32, iv));
 }
 
 void PdfEncryptAESV3::generateInitialVector(unsigned char iv[])
@@ -10,6 +10,8 @@
 #include "PdfString.h"
 #include "PdfReference.h"
 
+#include <podofo/auxiliary/OutputStream.h>
+
 // Define an opaque type for the internal PoDoFo encryption context
 #ifndef PODOFO_CRYPT_CTX
 #define PODOFO_CRYPT_CTX void
@@ -21,7 +23,6 @@ namespace PoDoFo
 class PdfDictionary;
 class InputStream;
 class PdfObject;
-class OutputStream;
 
 /* Class representing PDF encryption methods. (For internal use only)
  * Based on code from Ulrich Telle: http://wxcode.sourceforge.net/components/wxpdfdoc/
@@ -104,6 +105,33 @@ enum class PdfAuthResult : uint8_t
 
 class PdfEncryptContext;
 
+/** An OutputStream that encrypts all data written to it
+ */
+class PODOFO_API PdfEncryptOutputStream : public OutputStream
+{
+protected:
+    PdfEncryptOutputStream();
+
+public:
+    /** Write the remaining encrypted data, such as the last padded
+     * block with AES. It must be called after all the data has
+     * been written, and no more data can be written after it
+     * \remarks Destroying the stream without closing it leaves
+     * the encrypted data incomplete
+     */
+    void Close();
+
+protected:
+    /** Complete the encrypted data. By default does nothing
+     */
+    virtual void close();
+
+    void checkWrite() const override;
+
+private:
+    bool m_closed;
+};
+
 /** A class that is used to encrypt a PDF file and
  *  set document permissions on the PDF file.
  *
@@ -206,10 +234,9 @@ public:
     /** Create an InputStream that decrypts all data read from
      *  it using the current settings of the PdfEncrypt object.
      *
-     *  Warning: Currently only RC4 based encryption is supported using output streams!
-     *
      *  \param inputStream the created InputStream reads all decrypted
      *         data to this input stream.
+     *  \param inputLen the length of the encrypted data
      *
      *  \returns an InputStream that decrypts all data.
      */
@@ -219,14 +246,14 @@ public:
     /** Create an OutputStream that encrypts all data written to
      *  it using the current settings of the PdfEncrypt object.
      *
-     *  Warning: Currently only RC4 based encryption is supported using output streams!
-     *
      *  \param outputStream the created OutputStream writes all encrypted
      *         data to this output stream.
+     *  \remarks PdfEncryptOutputStream::Close() must be called
+     *         after all the data has been written
      *
      *  \returns a OutputStream that encrypts all data.
      */
-    virtual std::unique_ptr<OutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
+    virtual std::unique_ptr<PdfEncryptOutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
         PdfEncryptContext& context, const PdfReference& objref) const = 0;
 
     /** Get the encryption algorithm of this object.
@@ -450,6 +477,7 @@ private:
 class PODOFO_API PdfEncryptContext final
 {
     friend class PdfEncrypt;
+    friend class PdfEncryptMD5Base;
     friend class PdfEncryptRC4;
     friend class PdfEncryptAESV2;
     friend class PdfEncryptAESV3;
@@ -475,6 +503,8 @@ private:
 
     PODOFO_CRYPT_CTX* GetCryptCtx();
 
+    void invalidateObjKey();
+
     template <typename T>
     T& GetCustomCtx()
     {
@@ -494,6 +524,13 @@ private:
     PODOFO_CRYPT_CTX* m_cryptCtx;
     void* m_customCtx;
     size_t m_customCtxSize;
+
+    // Key of the last object encrypted/decrypted with
+    // RC4 or AESV2, so it's not derived again for every
+    // string and stream of the same object
+    PdfReference m_objKeyRef;
+    unsigned char m_objKey[16];
+    unsigned m_objKeyLength;           // 0 if no key is cached
 };
 
 
@@ -543,6 +580,12 @@ protected:
      */
     void CreateObjKey(unsigned char objkey[16], unsigned& pnKeyLen,
         const unsigned char m_encryptionKey[32], const PdfReference& objref) const;
+
+    /** Get the encryption key for the current object, reusing
+     *  the key cached in the context when the object is the same
+     */
+    void GetObjKey(unsigned char objkey[16], unsigned& pnKeyLen,
+        PdfEncryptContext& context, const PdfReference& objref) const;
 };
 
 /** A class that is used to encrypt a PDF file (AES-128)
@@ -564,7 +607,7 @@ private:
 public:
     std::unique_ptr<InputStream> CreateEncryptionInputStream(InputStream& inputStream, size_t inputLen,
         PdfEncryptContext& context, const PdfReference& objref) const override;
-    std::unique_ptr<OutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
+    std::unique_ptr<PdfEncryptOutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
         PdfEncryptContext& context, const PdfReference& objref) const override;
 
     size_t CalculateStreamOffset() const override;
@@ -607,7 +650,7 @@ private:
 public:
     std::unique_ptr<InputStream> CreateEncryptionInputStream(InputStream& inputStream, size_t inputLen,
         PdfEncryptContext& context, const PdfReference& objref) const override;
-    std::unique_ptr<OutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
+    std::unique_ptr<PdfEncryptOutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
         PdfEncryptContext& context, const PdfReference& objref) const override;
 
     size_t CalculateStreamOffset() const override;
@@ -693,7 +736,7 @@ public:
     std::unique_ptr<InputStream> CreateEncryptionInputStream(InputStream& inputStream, size_t inputLen,
         PdfEncryptContext& context, const PdfReference& objref) const override;
 
-    std::unique_ptr<OutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
+    std::unique_ptr<PdfEncryptOutputStream> CreateEncryptionOutputStream(OutputStream& outputStream,
         PdfEncryptContext& context, const PdfReference& objref) const override;
 
     size_t CalculateStreamOffset() const override;
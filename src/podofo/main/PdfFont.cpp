@@ -34,6 +34,35 @@ using namespace PoDoFo;
 static double getGlyphLength(double glyphLength, const PdfTextState& state, bool ignoreCharSpacing);
 static string_view toString(PdfFontStretch stretch);
 
+/** The codes of a decode table sharing the same high byte
+ */
+struct PdfFont::DecodeTablePage
+{
+    struct DecodedCharCode
+    {
+        double Width;                   ///< The raw width of the glyph mapped by the code
+        unsigned Utf8Offset;            ///< The offset of the decoded text in the page UTF-8 buffer
+        unsigned short Utf8Length;
+        bool Success;                   ///< False if the code has no CID or unicode mapping
+    };
+
+    bool Valid;                         ///< False if a code was not read as a whole
+    array<DecodedCharCode, 256> Codes;
+    string Utf8;
+};
+
+/** A two-level table of the codes of an encoding with a single
+ * code size of 1 or 2 bytes, so strings can be decoded without
+ * performing map lookups. Pages are decoded on first use, so
+ * only the code ranges actually used by the document are filled
+ */
+struct PdfFont::DecodeTable
+{
+    unsigned char CodeSize;
+    array<unique_ptr<DecodeTablePage>, 256> Pages;
+    array<once_flag, 256> PageInitFlags;
+};
+
 PdfFont::PdfFont(PdfDocument& doc, PdfFontType type, PdfFontMetricsConstPtr&& metrics,
         const PdfEncoding& encoding) :
     PdfDictionaryElement(doc, "Font"_n),
@@ -328,6 +357,57 @@ bool PdfFont::TryScanEncodedString(const PdfString& encodedStr, const PdfTextSta
     if (encodedStr.IsEmpty())
         return true;
 
+    auto table = const_cast<PdfFont&>(*this).getDecodeTable();
+    auto encoded = encodedStr.GetRawData();
+    if (table != nullptr && encoded.size() % table->CodeSize == 0)
+    {
+        bool success = true;
+        size_t count = encoded.size() / table->CodeSize;
+        lengths.reserve(count);
+        positions.reserve(count);
+        bool decoded = true;
+        for (size_t i = 0; i < encoded.size(); i += table->CodeSize)
+        {
+            unsigned char high;
+            unsigned char low;
+            if (table->CodeSize == 1)
+            {
+                high = 0;
+                low = (unsigned char)encoded[i];
+            }
+            else
+            {
+                high = (unsigned char)encoded[i];
+                low = (unsigned char)encoded[i + 1];
+            }
+
+            auto& page = const_cast<PdfFont&>(*this).getDecodeTablePage(
+                const_cast<DecodeTable&>(*table), high);
+            if (!page.Valid)
+            {
+                decoded = false;
+                break;
+            }
+
+            auto& code = page.Codes[low];
+            if (!code.Success)
+                success = false;
+
+            positions.push_back((unsigned)utf8str.length());
+            utf8str.append(page.Utf8.data() + code.Utf8Offset, code.Utf8Length);
+            lengths.push_back(getGlyphLength(code.Width, state, false));
+        }
+
+        if (decoded)
+            return success;
+
+        // Some codes can't be decoded with the table,
+        // the string must be scanned as usual
+        utf8str.clear();
+        lengths.clear();
+        positions.clear();
+    }
+
     auto context = m_Encoding->StartStringScan(encodedStr);
     CodePointSpan codepoints;
     PdfCID cid;
@@ -632,6 +712,75 @@ void PdfFont::initSpaceDescriptors()
     m_WordSpacingLengthRaw = m_SpaceCharLengthRaw / WORD_SPACING_FRACTIONAL_FACTOR;
 }
 
+// Create a table for the decoded text and the width of the codes of the
+// encoding. This is done only for fonts loaded from a document, which
+// have immutable maps, with a single code size of 1 or 2 bytes
+const PdfFont::DecodeTable* PdfFont::getDecodeTable()
+{
+    // NOTE: Fonts are shared by concurrent text extractions
+    std::call_once(m_decodeTableInitFlag, [this]()
+    {
+        if (!IsObjectLoaded())
+            return;
+
+        auto& limits = m_Encoding->GetEncodingMap().GetLimits();
+        if (limits.MinCodeSize == 0 || limits.MinCodeSize != limits.MaxCodeSize || limits.MaxCodeSize > 2)
+            return;
+
+        m_decodeTable.reset(new DecodeTable());
+        m_decodeTable->CodeSize = limits.MinCodeSize;
+    });
+
+    return m_decodeTable.get();
+}
+
+// Decode all the codes with the given high byte, which is
+// always 0 for encodings with a code size of 1 byte
+const PdfFont::DecodeTablePage& PdfFont::getDecodeTablePage(DecodeTable& table, unsigned char high)
+{
+    std::call_once(table.PageInitFlags[high], [&]()
+    {
+        auto page = std::make_unique<DecodeTablePage>();
+        page->Valid = true;
+        char code[2];
+        PdfCID cid;
+        CodePointSpan codepoints;
+        for (unsigned low = 0; low < 256; low++)
+        {
+            if (table.CodeSize == 1)
+            {
+                code[0] = (char)low;
+            }
+            else
+            {
+                code[0] = (char)high;
+                code[1] = (char)low;
+            }
+
+            auto context = m_Encoding->startStringScan(string_view(code, table.CodeSize));
+            unsigned offset = (unsigned)page->Utf8.length();
+            bool success = context.TryScan(cid, page->Utf8, codepoints);
+            if (!context.IsEndOfString())
+            {
+                // The code was not read as a whole, strings
+                // using this page must be scanned as usual
+                page->Valid = false;
+                break;
+            }
+
+            auto& decoded = page->Codes[low];
+            decoded.Width = GetCIDWidth(cid.Id);
+            decoded.Utf8Offset = offset;
+            decoded.Utf8Length = (unsigned short)(page->Utf8.length() - offset);
+            decoded.Success = success;
+        }
+
+        table.Pages[high] = std::move(page);
+    });
+
+    return *table.Pages[high];
+}
+
 void PdfFont::pushSubsetInfo(unsigned cid, const PdfGID& gid, const PdfCharCode& code)
 {
     auto& info = (*m_subsetCIDMap)[cid];
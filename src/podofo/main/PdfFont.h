@@ -9,6 +9,8 @@
 
 #include "PdfDeclarations.h"
 
+#include <mutex>
+
 #include "PdfTextState.h"
 #include "PdfName.h"
 #include "PdfEncoding.h"
@@ -434,6 +436,10 @@ private:
 
     using CIDSubsetMap = std::map<unsigned, CIDSubsetInfo>;
 
+    // Decode tables are defined in PdfFont.cpp
+    struct DecodeTable;
+    struct DecodeTablePage;
+
     bool tryConvertToGIDs(const std::string_view& utf8Str, PdfGlyphAccess access, std::vector<unsigned>& gids) const;
     bool tryAddSubsetGID(unsigned gid, const unicodeview& codePoints, PdfCID& cid);
 
@@ -449,6 +455,10 @@ private:
 
     void initSpaceDescriptors();
 
+    const DecodeTable* getDecodeTable();
+
+    const DecodeTablePage& getDecodeTablePage(DecodeTable& table, unsigned char high);
+
     void pushSubsetInfo(unsigned cid, const PdfGID& gid, const PdfCharCode& code);
 
 private:
@@ -464,6 +474,10 @@ private:
     const PdfCIDToGIDMap* m_fontProgCIDToGIDMap;
     double m_WordSpacingLengthRaw;
     double m_SpaceCharLengthRaw;
+    // NOTE: The decode table is built on first use by const methods,
+    // which may be called concurrently by parallel text extraction
+    std::once_flag m_decodeTableInitFlag;
+    std::unique_ptr<DecodeTable> m_decodeTable;
 
 protected:
     PdfFontMetricsConstPtr m_Metrics;
@@ -192,6 +192,7 @@ bool PdfFontMetrics::TryGetGlyphWidth(unsigned gid, double& width) const
         return true;
     }
 
+    std::lock_guard<std::mutex> lock(m_fontProgramMutex);
     return TryGetGlyphWidthFontProgram(gid, width);
 }
 
@@ -211,7 +212,10 @@ bool PdfFontMetrics::TryGetGlyphWidth(unsigned gid, PdfGlyphAccess access, doubl
             return true;
         }
         case PdfGlyphAccess::FontProgram:
+        {
+            std::lock_guard<std::mutex> lock(m_fontProgramMutex);
             return TryGetGlyphWidthFontProgram(gid, width);
+        }
         default:
             PODOFO_RAISE_ERROR(PdfErrorCode::InvalidEnumValue);
     }
@@ -13,6 +13,8 @@
 #include <podofo/auxiliary/Matrix.h>
 #include <podofo/auxiliary/Corners.h>
 
+#include <mutex>
+
 FORWARD_DECLARE_FREETYPE();
 
 namespace PoDoFo {
@@ -406,6 +408,9 @@ private:
     GlyphMetricsListConstPtr m_ParsedWidths;
     nullable<PdfFontStyle> m_Style;
     unsigned m_FaceIndex;
+    // NOTE: The font program face is loaded lazily and it can't be
+    // used concurrently, e.g. by parallel text extraction
+    mutable std::mutex m_fontProgramMutex;
 };
 
 class PODOFO_API PdfFontMetricsBase : public PdfFontMetrics
@@ -17,11 +17,14 @@
 #include "PdfObjectStream.h"
 #include "PdfDocument.h"
 #include "PdfCommon.h"
+#include <podofo/private/PdfArena.h>
 
 using namespace std;
 using namespace PoDoFo;
 
 static constexpr unsigned MaxXRefGenerationNum = 65535;
+// Margin over twice the object count allowed to the object numbers in the index
+static constexpr size_t SparseIndexMargin = 1024;
 
 namespace
 {
@@ -67,24 +70,30 @@ namespace
 
 PdfIndirectObjectList::PdfIndirectObjectList() :
     m_Document(nullptr),
+    m_overflowCount(0),
     m_ObjectCount(0),
-    m_StreamFactory(nullptr)
+    m_StreamFactory(nullptr),
+    m_arena(new PdfArena())
 {
 }
 
 PdfIndirectObjectList::PdfIndirectObjectList(PdfDocument& document) :
     m_Document(&document),
+    m_overflowCount(0),
     m_ObjectCount(0),
-    m_StreamFactory(nullptr)
+    m_StreamFactory(nullptr),
+    m_arena(new PdfArena())
 {
 }
 
 PdfIndirectObjectList::PdfIndirectObjectList(PdfDocument& document, const PdfIndirectObjectList& rhs)  :
     m_Document(&document),
+    m_overflowCount(0),
     m_ObjectCount(rhs.m_ObjectCount),
     m_FreeObjects(rhs.m_FreeObjects),
     m_unavailableObjects(rhs.m_unavailableObjects),
-    m_StreamFactory(nullptr)
+    m_StreamFactory(nullptr),
+    m_arena(new PdfArena())
 {
     // Copy all objects from source, resetting parent and indirect reference
     for (auto obj : rhs.m_Objects)
@@ -94,6 +103,8 @@ PdfIndirectObjectList::PdfIndirectObjectList(PdfDocument& document, const PdfInd
         newObj->SetDocument(&document);
         m_Objects.insert(newObj);
     }
+
+    rebuildIndex();
 }
 
 PdfIndirectObjectList::~PdfIndirectObjectList()
@@ -107,10 +118,15 @@ void PdfIndirectObjectList::Clear()
         delete obj;
 
     m_Objects.clear();
+    m_objectIndex.clear();
+    m_overflowCount = 0;
     m_ObjectCount = 0;
     m_FreeObjects.clear();
     m_unavailableObjects.clear();
     m_objectStreams.clear();
+
+    // Chunks are freed when all their objects are deleted
+    m_arena->Reset();
 }
 
 PdfObject& PdfIndirectObjectList::MustGetObject(const PdfReference& ref) const
@@ -124,6 +140,19 @@ PdfObject& PdfIndirectObjectList::MustGetObject(const PdfReference& ref) const
 
 PdfObject* PdfIndirectObjectList::GetObject(const PdfReference& ref) const
 {
+    uint32_t objNum = ref.ObjectNumber();
+    if (objNum < m_objectIndex.size())
+    {
+        auto obj = m_objectIndex[objNum];
+        if (obj != nullptr && obj->GetIndirectReference() == ref)
+            return obj;
+    }
+
+    if (m_overflowCount == 0)
+        return nullptr;
+
+    // Fallback looking for objects not indexed or with
+    // a different generation number than the indexed one
     auto it = m_Objects.lower_bound(ref);
     if (it == m_Objects.end() || (*it)->GetIndirectReference() != ref)
         return nullptr;
@@ -160,6 +189,7 @@ unique_ptr<PdfObject> PdfIndirectObjectList::removeObject(const iterator& it, bo
         SafeAddFreeObject(obj->GetIndirectReference());
 
     m_Objects.erase(it);
+    unindexObject(obj);
     return unique_ptr<PdfObject>(obj);
 }
 
@@ -307,9 +337,17 @@ void PdfIndirectObjectList::PushObject(PdfObject* obj)
         // the pointer on its node
         hintpos++;
         node = m_Objects.extract(it);
+        uint32_t objNum = obj->GetIndirectReference().ObjectNumber();
+        if (objNum < m_objectIndex.size() && m_objectIndex[objNum] == node.value())
+            m_objectIndex[objNum] = obj;
+
         delete node.value();
         node.value() = obj;
     }
+    else
+    {
+        indexObject(obj);
+    }
 
     pushObject(hintpos, node, obj);
 }
@@ -350,6 +388,7 @@ void PdfIndirectObjectList::CollectGarbage()
         delete obj;
 
     m_Objects.swap(newlist);
+    rebuildIndex();
 }
 
 void PdfIndirectObjectList::visitObject(const PdfObject& obj, unordered_set<PdfReference>& referencedObjects)
@@ -453,6 +492,72 @@ void PdfIndirectObjectList::SetStreamFactory(StreamFactory* factory)
     m_StreamFactory = factory;
 }
 
+void PdfIndirectObjectList::ReserveObjects(unsigned objectCount)
+{
+    m_objectIndex.reserve(objectCount);
+}
+
+void PdfIndirectObjectList::indexObject(PdfObject* obj)
+{
+    uint32_t objNum = obj->GetIndirectReference().ObjectNumber();
+    if (objNum >= m_objectIndex.size())
+    {
+        // Don't let sparse object numbers, e.g. from a hostile
+        // /Size, allocate a huge index. Such objects are just
+        // counted as overflowing and found in m_Objects
+        if (objNum > 2 * m_Objects.size() + SparseIndexMargin)
+        {
+            m_overflowCount++;
+            return;
+        }
+
+        m_objectIndex.resize((size_t)objNum + 1);
+    }
+
+    auto& slot = m_objectIndex[objNum];
+    if (slot == nullptr)
+        slot = obj;
+    else
+        m_overflowCount++;
+}
+
+void PdfIndirectObjectList::unindexObject(PdfObject* obj)
+{
+    auto& ref = obj->GetIndirectReference();
+    if (ref.ObjectNumber() >= m_objectIndex.size())
+    {
+        m_overflowCount--;
+        return;
+    }
+
+    auto& slot = m_objectIndex[ref.ObjectNumber()];
+    if (slot != obj)
+    {
+        m_overflowCount--;
+        return;
+    }
+
+    slot = nullptr;
+    if (m_overflowCount == 0)
+        return;
+
+    // Promote another object with the same number, if any
+    auto it = m_Objects.lower_bound(PdfReference(ref.ObjectNumber(), 0));
+    if (it != m_Objects.end() && (*it)->GetIndirectReference().ObjectNumber() == ref.ObjectNumber())
+    {
+        slot = *it;
+        m_overflowCount--;
+    }
+}
+
+void PdfIndirectObjectList::rebuildIndex()
+{
+    m_objectIndex.clear();
+    m_overflowCount = 0;
+    for (auto obj : m_Objects)
+        indexObject(obj);
+}
+
 void PdfIndirectObjectList::tryIncrementObjectCount(const PdfReference& ref)
 {
     if (ref.ObjectNumber() > m_ObjectCount)
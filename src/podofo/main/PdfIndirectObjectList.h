@@ -12,6 +12,7 @@
 namespace PoDoFo {
 
 class PdfObjectStreamProvider;
+class PdfArena;
 using PdfFreeObjectList = std::deque<PdfReference>;
 
 /** A list of PdfObjects that constitutes the indirect object list
@@ -34,6 +35,8 @@ class PODOFO_API PdfIndirectObjectList final
     PODOFO_PRIVATE_FRIEND(class PdfObjectStreamParser);
     PODOFO_PRIVATE_FRIEND(class PdfImmediateWriter);
     PODOFO_PRIVATE_FRIEND(class PdfParser);
+    PODOFO_PRIVATE_FRIEND(class PdfParserObject);
+    PODOFO_PRIVATE_FRIEND(class PdfCompressedParserObject);
     PODOFO_PRIVATE_FRIEND(class PdfWriter);
     PODOFO_PRIVATE_FRIEND(class PdfParserTest);
     PODOFO_PRIVATE_FRIEND(class PdfEncodingTest);
@@ -301,6 +304,16 @@ private:
      */
     void SetStreamFactory(StreamFactory* factory);
 
+    /** Reserve space in the object number index for the given
+     * number of objects, e.g. the objects found in the xref table
+     */
+    void ReserveObjects(unsigned objectCount);
+
+    /** The arena where the objects of the document
+     * are allocated while loading
+     */
+    PdfArena& GetArena() { return *m_arena; }
+
 private:
     void pushObject(const ObjectList::const_iterator& hintpos, ObjectList::node_type& node, PdfObject* obj);
 
@@ -325,9 +338,21 @@ private:
      */
     void tryIncrementObjectCount(const PdfReference& ref);
 
+    void indexObject(PdfObject* obj);
+
+    void unindexObject(PdfObject* obj);
+
+    void rebuildIndex();
+
 private:
     PdfDocument* m_Document;
     ObjectList m_Objects;
+    // Objects indexed by object number, for O(1) lookup. Objects
+    // with the same number of an already indexed object, but a
+    // different generation, or with numbers too sparse to be
+    // indexed, are found only in m_Objects
+    std::vector<PdfObject*> m_objectIndex;
+    unsigned m_overflowCount;
     unsigned m_ObjectCount;
     PdfFreeObjectList m_FreeObjects;
     ObjectNumSet m_unavailableObjects;
@@ -335,6 +360,7 @@ private:
 
     ObserverList m_observers;
     StreamFactory* m_StreamFactory;
+    std::unique_ptr<PdfArena> m_arena;
 };
 
 };
@@ -24,7 +24,9 @@ PdfMemDocument::PdfMemDocument(bool empty) :
     m_Version(PdfVersionDefault),
     m_InitialVersion(PdfVersionDefault),
     m_HasXRefStream(false),
-    m_PrevXRefOffset(-1)
+    m_PrevXRefOffset(-1),
+    m_ObjectStreamSize(PdfObjectStreamSizeDefault),
+    m_ParallelLoad(false)
 {
 }
 
@@ -42,7 +44,9 @@ PdfMemDocument::PdfMemDocument(const PdfMemDocument& rhs) :
     m_Version(rhs.m_Version),
     m_InitialVersion(rhs.m_InitialVersion),
     m_HasXRefStream(rhs.m_HasXRefStream),
-    m_PrevXRefOffset(rhs.m_PrevXRefOffset)
+    m_PrevXRefOffset(rhs.m_PrevXRefOffset),
+    m_ObjectStreamSize(rhs.m_ObjectStreamSize),
+    m_ParallelLoad(rhs.m_ParallelLoad)
 {
     // Do a full copy of the encrypt session
     if (rhs.m_Encrypt != nullptr)
@@ -85,6 +89,13 @@ void PdfMemDocument::initFromParser(PdfParser& parser)
         m_Encrypt.reset(new PdfEncryptSession(*encrypt));
 
     Init();
+
+    // Linearized documents serve the first page without
+    // loading the whole page tree
+    PdfReference firstPageRef;
+    unsigned pageCount;
+    if (parser.TryGetLinearizedFirstPage(firstPageRef, pageCount))
+        GetPages().initFirstPage(firstPageRef, pageCount);
 }
 
 void PdfMemDocument::Load(const string_view& filename, const string_view& password)
@@ -92,6 +103,9 @@ void PdfMemDocument::Load(const string_view& filename, const string_view& passwo
     if (filename.length() == 0)
         PODOFO_RAISE_ERROR(PdfErrorCode::InvalidHandle);
 
+    // NOTE: The file is not mapped in memory by default, since the
+    // document may be saved to the same file, see the remarks
+    // of MappedFileStreamDevice
     auto device = std::make_shared<FileStreamDevice>(filename);
     Load(device, password);
 }
@@ -122,7 +136,8 @@ void PdfMemDocument::loadFromDevice(shared_ptr<InputStreamDevice>&& device, cons
     // so that m_Parser is initialized for encrypted documents
     PdfParser parser(PdfDocument::GetObjects());
     parser.SetPassword(password);
-    parser.Parse(*m_device, true);
+    parser.SetParallelLoad(m_ParallelLoad);
+    parser.Parse(*m_device, !m_ParallelLoad);
     initFromParser(parser);
 }
 
@@ -140,6 +155,12 @@ void PdfMemDocument::Save(OutputStreamDevice& device, PdfSaveOptions opts)
     writer.SetPdfVersion(GetMetadata().GetPdfVersion());
     writer.SetPdfALevel(GetMetadata().GetPdfALevel());
     writer.SetSaveOptions(opts);
+    if ((opts & PdfSaveOptions::CompressObjects) != PdfSaveOptions::None)
+    {
+        // Object streams require a XRef stream
+        writer.SetUseXRefStream(true);
+        writer.SetObjectStreamSize(m_ObjectStreamSize);
+    }
 
     if (m_Encrypt != nullptr)
         writer.SetEncrypt(*m_Encrypt);
@@ -163,6 +184,11 @@ void PdfMemDocument::SaveUpdate(const string_view& filename, PdfSaveOptions opts
 
 void PdfMemDocument::SaveUpdate(OutputStreamDevice& device, PdfSaveOptions opts)
 {
+    // The previous xref section of a document with a rebuilt
+    // xref table is broken, so it can't be referenced by /Prev
+    if (m_PrevXRefOffset == 0)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidXRef, "Incremental updates are not supported on documents with a rebuilt xref table, use Save() instead");
+
     beforeWrite(opts);
 
     PdfWriter writer(this->GetObjects(), this->GetTrailer().GetObject());
@@ -239,6 +265,21 @@ const PdfEncrypt* PdfMemDocument::GetEncrypt() const
     return &m_Encrypt->GetEncrypt();
 }
 
+void PdfMemDocument::SetObjectStreamSize(unsigned size)
+{
+    // The index of the object in the stream is
+    // written as a 2 bytes field in the XRef stream
+    if (size == 0 || size > numeric_limits<uint16_t>::max())
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "The object stream size must be between 1 and 65535");
+
+    m_ObjectStreamSize = size;
+}
+
+void PdfMemDocument::SetParallelLoad(bool parallel)
+{
+    m_ParallelLoad = parallel;
+}
+
 void PdfMemDocument::SetPdfVersion(PdfVersion version)
 {
     m_Version = version;
@@ -56,6 +56,10 @@ public:
      *  When the bForUpdate is set to true, the filename is copied
      *  for later use by WriteUpdate.
      *
+     *  \remarks To map the file in memory, load a MappedFileStreamDevice
+     *  instead. The file must then not be truncated or overwritten, e.g.
+     *  by saving the document to the same file, as long as the document
+     *  is loaded
      *  \see WriteUpdate, LoadFromBuffer, LoadFromDevice
      */
     void Load(const std::string_view& filename, const std::string_view& password = { });
@@ -121,6 +125,8 @@ public:
      *  Writes the document changes to the output device as an incremental update.
      *  The document should be loaded with bForUpdate = true, otherwise
      *  an exception is thrown.
+     *  \remarks Documents loaded by rebuilding a broken xref table can't be
+     *  updated incrementally and an exception is thrown
      *
      *  \see Save, SaveUpdate
      */
@@ -152,6 +158,27 @@ public:
 
     const PdfEncrypt* GetEncrypt() const override;
 
+    /** Set the maximum number of objects packed in a single
+     *  object stream, when saving with PdfSaveOptions::CompressObjects
+     *
+     *  \param size the number of objects, between 1 and 65535.
+     *      The default is PdfObjectStreamSizeDefault
+     */
+    void SetObjectStreamSize(unsigned size);
+
+    inline unsigned GetObjectStreamSize() const { return m_ObjectStreamSize; }
+
+    /** Load all the objects and their streams when the document
+     *  is loaded, parsing them on multiple threads, instead of
+     *  loading them on demand. It must be set before loading.
+     *  Encrypted documents are still parsed on the current thread
+     *
+     *  \param parallel the new setting. It's by default disabled
+     */
+    void SetParallelLoad(bool parallel);
+
+    inline bool IsParallelLoad() const { return m_ParallelLoad; }
+
 protected:
     /** Set the PDF Version of the document. Has to be called before Write() to
      *  have an effect.
@@ -189,6 +216,8 @@ private:
     PdfVersion m_InitialVersion;
     bool m_HasXRefStream;
     int64_t m_PrevXRefOffset;
+    unsigned m_ObjectStreamSize;
+    bool m_ParallelLoad;
     std::unique_ptr<PdfEncryptSession> m_Encrypt;
     std::shared_ptr<InputStreamDevice> m_device;
 };
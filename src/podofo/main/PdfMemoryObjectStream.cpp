@@ -9,6 +9,7 @@
 
 #include <podofo/auxiliary/StreamDevice.h>
 #include "PdfStatefulEncrypt.h"
+#include <podofo/private/PdfPassthroughObjectStream.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -31,7 +32,15 @@ bool PdfMemoryObjectStream::TryCopyFrom(const PdfObjectStreamProvider& rhs)
 {
     const PdfMemoryObjectStream* memstream = dynamic_cast<const PdfMemoryObjectStream*>(&rhs);
     if (memstream == nullptr)
-        return false;
+    {
+        // Streams loaded by the parser may still be backed by the source device
+        auto passthrough = dynamic_cast<const PdfPassthroughObjectStream*>(&rhs);
+        if (passthrough == nullptr)
+            return false;
+
+        passthrough->CopyTo(m_buffer);
+        return true;
+    }
 
     m_buffer = memstream->m_buffer;
     return true;
@@ -41,7 +50,15 @@ bool PdfMemoryObjectStream::TryMoveFrom(PdfObjectStreamProvider&& rhs)
 {
     PdfMemoryObjectStream* memstream = dynamic_cast<PdfMemoryObjectStream*>(&rhs);
     if (memstream == nullptr)
-        return false;
+    {
+        auto passthrough = dynamic_cast<PdfPassthroughObjectStream*>(&rhs);
+        if (passthrough == nullptr)
+            return false;
+
+        passthrough->CopyTo(m_buffer);
+        passthrough->Clear();
+        return true;
+    }
 
     m_buffer = std::move(memstream->m_buffer);
     return true;
@@ -65,9 +82,10 @@ void PdfMemoryObjectStream::Write(OutputStream& stream, const PdfStatefulEncrypt
     stream.Write("stream\n");
     if (encrypt != nullptr)
     {
-        charbuff encrypted;
-        encrypt->EncryptTo(encrypted, { m_buffer.data(), m_buffer.size() });
-        stream.Write(encrypted);
+        // Encrypt while writing, without a copy of the whole buffer
+        auto output = encrypt->CreateEncryptionOutputStream(stream);
+        output->Write(m_buffer.data(), m_buffer.size());
+        output->Close();
     }
     else
     {
@@ -15,6 +15,9 @@
 
 #include <podofo/auxiliary/StreamDevice.h>
 #include <podofo/private/PdfStreamedObjectStream.h>
+#include <podofo/private/PdfPassthroughObjectStream.h>
+#include <podofo/private/PdfArena.h>
+#include <podofo/private/PdfFiltersImpl.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -36,6 +39,16 @@ PdfObject::PdfObject(nullptr_t)
 
 PdfObject::~PdfObject() { }
 
+void* PdfObject::operator new(size_t size)
+{
+    return PdfArena::Allocate(size);
+}
+
+void PdfObject::operator delete(void* ptr) noexcept
+{
+    PdfArena::Deallocate(ptr);
+}
+
 PdfObject::PdfObject(const PdfVariant& var)
     : PdfObject(PdfVariant(var), PdfReference(), false) { }
 
@@ -245,26 +258,8 @@ void PdfObject::write(OutputStream& stream, bool skipLengthFix,
 
     if (m_Stream != nullptr)
     {
-        // Try to compress the flate compress the stream if it has no filters,
-        // the compression is not disabled and it's not the /MetaData object,
-        // which must be unfiltered as per PDF/A
-        const PdfObject* metadataObj;
-        if ((writeMode & PdfWriteFlags::NoFlateCompress) == PdfWriteFlags::None
-            && m_Stream->GetFilters().size() == 0
-            && (m_Document == nullptr 
-                || (metadataObj = m_Document->GetCatalog().GetMetadataObject()) == nullptr
-                || m_IndirectReference != metadataObj->GetIndirectReference()))
-        {
-            PdfObject object;
-            auto& objStream = object.GetOrCreateStream();
-            {
-                auto output = objStream.GetOutputStream({ PdfFilterType::FlateDecode });
-                auto input = m_Stream->GetInputStream();
-                input.CopyTo(output);
-            }
-
-            m_Stream->MoveFrom(objStream);
-        }
+        if (ShouldCompressStream(writeMode))
+            CompressStream();
 
         // Set length if it's not handled by the underlying provider
         if (!skipLengthFix)
@@ -289,6 +284,44 @@ void PdfObject::write(OutputStream& stream, bool skipLengthFix,
         stream.Write("endobj\n");
 }
 
+bool PdfObject::ShouldCompressStream(PdfWriteFlags writeMode) const
+{
+    // Try to compress the flate compress the stream if it has no filters,
+    // the compression is not disabled and it's not the /MetaData object,
+    // which must be unfiltered as per PDF/A
+    const PdfObject* metadataObj;
+    return m_Stream != nullptr
+        && (writeMode & PdfWriteFlags::NoFlateCompress) == PdfWriteFlags::None
+        && m_Stream->GetFilters().size() == 0
+        && (m_Document == nullptr
+            || (metadataObj = m_Document->GetCatalog().GetMetadataObject()) == nullptr
+            || m_IndirectReference != metadataObj->GetIndirectReference());
+}
+
+void PdfObject::CompressStream() const
+{
+    auto& params = m_Stream->GetFlateParams();
+    PdfObject object;
+    auto& objStream = object.GetOrCreateStream();
+    auto memStream = dynamic_cast<const PdfMemoryObjectStream*>(&static_cast<const PdfObjectStream&>(*m_Stream).GetProvider());
+    if (memStream == nullptr)
+    {
+        objStream.SetFlateParams(params);
+        auto output = objStream.GetOutputStream({ PdfFilterType::FlateDecode });
+        auto input = m_Stream->GetInputStream();
+        input.CopyTo(output);
+    }
+    else
+    {
+        // The data is already in memory: compress it in a single pass
+        charbuff compressed;
+        PdfFlateFilter::EncodeBuffer(compressed, memStream->GetBuffer(), params);
+        objStream.SetData(compressed, { PdfFilterType::FlateDecode }, true);
+    }
+
+    m_Stream->MoveFrom(objStream);
+}
+
 void PdfObject::WriteHeader(OutputStream& stream, PdfWriteFlags writeMode, charbuff& buffer) const
 {
     if ((writeMode & PdfWriteFlags::Clean) != PdfWriteFlags::None
@@ -437,8 +470,15 @@ void PdfObject::moveStreamFrom(PdfObject& obj)
 {
     obj.DelayedLoadStream();
     m_Stream = std::move(obj.m_Stream);
-    if (m_Stream != nullptr)
-        m_Stream->SetParent(*this);
+    if (m_Stream == nullptr)
+        return;
+
+    m_Stream->SetParent(*this);
+
+    // The object may outlive the device the stream was parsed from
+    auto passthrough = dynamic_cast<PdfPassthroughObjectStream*>(m_Stream->m_Provider.get());
+    if (passthrough != nullptr)
+        passthrough->Detach();
 }
 
 void PdfObject::EnableDelayedLoading()
@@ -44,6 +44,7 @@ class PODOFO_API PdfObject
     friend class PdfArrayElement;
     friend class PdfTokenizer;
     PODOFO_PRIVATE_FRIEND(class PdfStreamedObjectStream);
+    PODOFO_PRIVATE_FRIEND(class PdfCompressedParserObject);
     PODOFO_PRIVATE_FRIEND(class PdfObjectStreamParser);
     PODOFO_PRIVATE_FRIEND(class PdfParser);
     PODOFO_PRIVATE_FRIEND(class PdfParserObject);
@@ -56,6 +57,13 @@ public:
     static const PdfObject Null;
 
 public:
+    // Custom allocation functions, so objects can be allocated
+    // in the arena of the document being loaded
+    static void* operator new(size_t size);
+    static void* operator new(size_t, void* ptr) noexcept { return ptr; }
+    static void operator delete(void* ptr) noexcept;
+    static void operator delete(void*, void*) noexcept { }
+
 
     /** Create a PDF object with an empty PdfDictionary.
      */
@@ -544,6 +552,10 @@ private:
     void WriteFinal(OutputStream& stream, PdfWriteFlags writeMode,
         const PdfStatefulEncrypt* encrypt, charbuff& buffer);
 
+    // To be called by PdfWriter. The stream must be already loaded
+    bool ShouldCompressStream(PdfWriteFlags writeMode) const;
+    void CompressStream() const;
+
     // To be called by PdfStreamedObjectStream
     void SetNumberNoDirtySet(int64_t l);
 
@@ -12,6 +12,7 @@
 #include <podofo/auxiliary/StreamDevice.h>
 
 #include <podofo/private/PdfFilterFactory.h>
+#include <podofo/private/PdfFiltersImpl.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -22,7 +23,7 @@ static bool isMediaFilter(PdfFilterType filterType);
 static PdfFilterList stripMediaFilters(const PdfFilterList& filters, PdfFilterList& mediaFilters);
 
 PdfObjectStream::PdfObjectStream(PdfObject& parent, std::unique_ptr<PdfObjectStreamProvider>&& provider)
-    : m_Parent(&parent), m_Provider(std::move(provider)), m_locked(false)
+    : m_Parent(&parent), m_Provider(std::move(provider)), m_readerCount(0), m_writing(false)
 {
     m_Provider->Init(parent);
 }
@@ -55,7 +56,7 @@ PdfObjectOutputStream PdfObjectStream::GetOutputStream(const PdfFilterList& filt
 
 PdfObjectInputStream PdfObjectStream::GetInputStream(bool raw) const
 {
-    ensureClosed();
+    ensureNotWriting();
     return PdfObjectInputStream(const_cast<PdfObjectStream&>(*this), raw);
 }
 
@@ -214,6 +215,32 @@ size_t PdfObjectStream::GetLength() const
     return m_Provider->GetLength();
 }
 
+void PdfObjectStream::SetFlateParams(nullable<const PdfFlateParams&> params)
+{
+    if (params.has_value())
+    {
+        PdfFlateFilter::ValidateParams(*params);
+        m_FlateParams = *params;
+    }
+    else
+    {
+        m_FlateParams = nullptr;
+    }
+}
+
+const PdfFlateParams& PdfObjectStream::GetFlateParams() const
+{
+    static const PdfFlateParams s_defaultParams;
+    if (m_FlateParams.has_value())
+        return *m_FlateParams;
+
+    auto document = m_Parent->GetDocument();
+    if (document == nullptr)
+        return s_defaultParams;
+
+    return document->GetFlateParams();
+}
+
 void PdfObjectStream::MoveFrom(PdfObjectStream& rhs)
 {
     rhs.ensureClosed();
@@ -389,9 +416,22 @@ void PdfObjectStream::InitData(InputStream& stream, size_t size, PdfFilterList&&
     m_Filters = std::move(filterList);
 }
 
+void PdfObjectStream::InitData(unique_ptr<PdfObjectStreamProvider>&& provider, PdfFilterList&& filterList)
+{
+    ensureClosed();
+    m_Provider = std::move(provider);
+    m_Provider->Init(*m_Parent);
+    m_Filters = std::move(filterList);
+}
+
 void PdfObjectStream::ensureClosed() const
 {
-    PODOFO_RAISE_LOGIC_IF(m_locked, "The stream should have no read/write operations in progress");
+    PODOFO_RAISE_LOGIC_IF(m_readerCount != 0 || m_writing, "The stream should have no read/write operations in progress");
+}
+
+void PdfObjectStream::ensureNotWriting() const
+{
+    PODOFO_RAISE_LOGIC_IF(m_writing, "The stream should have no write operations in progress");
 }
 
 PdfObjectInputStream::PdfObjectInputStream()
@@ -400,7 +440,7 @@ PdfObjectInputStream::PdfObjectInputStream()
 PdfObjectInputStream::~PdfObjectInputStream()
 {
     if (m_stream != nullptr)
-        m_stream->m_locked = false;
+        m_stream->m_readerCount--;
 }
 
 PdfObjectInputStream::PdfObjectInputStream(PdfObjectInputStream&& rhs) noexcept
@@ -412,8 +452,8 @@ PdfObjectInputStream::PdfObjectInputStream(PdfObjectInputStream&& rhs) noexcept
 PdfObjectInputStream::PdfObjectInputStream(PdfObjectStream& stream, bool raw)
     : m_stream(&stream)
 {
-    m_stream->m_locked = true;
     m_input = stream.getInputStream(raw, m_MediaFilters, m_MediaDecodeParms);
+    m_stream->m_readerCount++;
 }
 
 size_t PdfObjectInputStream::readBuffer(char* buffer, size_t size, bool& eof)
@@ -428,6 +468,9 @@ bool PdfObjectInputStream::readChar(char& ch)
 
 PdfObjectInputStream& PdfObjectInputStream::operator=(PdfObjectInputStream&& rhs) noexcept
 {
+    if (m_stream != nullptr)
+        m_stream->m_readerCount--;
+
     utls::move(rhs.m_stream, m_stream);
     return *this;
 }
@@ -443,7 +486,7 @@ PdfObjectOutputStream::~PdfObjectOutputStream()
     if (m_stream != nullptr)
     {
         // Unlock the stream
-        m_stream->m_locked = false;
+        m_stream->m_writing = false;
 
         auto document = m_stream->GetParent().GetDocument();
         if (document != nullptr)
@@ -478,7 +521,7 @@ PdfObjectOutputStream::PdfObjectOutputStream(PdfObjectStream& stream,
     if (append)
         stream.CopyTo(buffer);
 
-    m_stream->m_locked = true;
+    m_stream->m_writing = true;
 
     if (filters_.has_value())
     {
@@ -500,7 +543,8 @@ PdfObjectOutputStream::PdfObjectOutputStream(PdfObjectStream& stream,
             else
             {
                 m_output = PdfFilterFactory::CreateEncodeStream(
-                    stream.m_Provider->GetOutputStream(stream.GetParent()), filters);
+                    stream.m_Provider->GetOutputStream(stream.GetParent()), filters,
+                    stream.GetFlateParams());
             }
 
             if (filters.size() == 1)
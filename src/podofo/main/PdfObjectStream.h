@@ -13,6 +13,7 @@
 #include <podofo/auxiliary/OutputStream.h>
 #include <podofo/auxiliary/InputStream.h>
 #include "PdfObjectStreamProvider.h"
+#include <atomic>
 
 namespace PoDoFo {
 
@@ -90,6 +91,7 @@ class PODOFO_API PdfObjectStream final
     friend class PdfObjectOutputStream;
     PODOFO_PRIVATE_FRIEND(class PdfParserObject);
     PODOFO_PRIVATE_FRIEND(class PdfImmediateWriter);
+    PODOFO_PRIVATE_FRIEND(class PdfWriter);
 
 private:
     /** Create a new PdfObjectStream object which has a parent PdfObject.
@@ -200,6 +202,19 @@ public:
 
     const PdfFilterList& GetFilters() { return m_Filters; }
 
+    /** Set the parameters of the Flate compression applied when
+     * writing to this stream, or when it's compressed on save
+     * \param params the parameters to use, or nullptr to use
+     *      the ones of the owner document
+     * \see PdfDocument::SetFlateParams
+     */
+    void SetFlateParams(nullable<const PdfFlateParams&> params);
+
+    /** Get the parameters of the Flate compression effectively
+     * used by this stream
+     */
+    const PdfFlateParams& GetFlateParams() const;
+
     /** Create a copy of a PdfObjectStream object
      *  \param rhs the object to clone
      *  \returns a reference to this object
@@ -225,6 +240,10 @@ private:
 
     void InitData(InputStream& stream, size_t len, PdfFilterList&& filterList);
 
+    /** Initialize the stream with a provider that already holds the data
+     */
+    void InitData(std::unique_ptr<PdfObjectStreamProvider>&& provider, PdfFilterList&& filterList);
+
     /** Copy data and non data fields from rhs
      */
     void CopyFrom(const PdfObjectStream& rhs);
@@ -237,6 +256,7 @@ private:
 
 private:
     void ensureClosed() const;
+    void ensureNotWriting() const;
 
     std::unique_ptr<InputStream> getInputStream(bool raw, PdfFilterList& mediaFilters,
         std::vector<const PdfDictionary*>& decodeParms);
@@ -251,7 +271,11 @@ private:
     PdfObject* m_Parent;
     std::unique_ptr<PdfObjectStreamProvider> m_Provider;
     PdfFilterList m_Filters;
-    bool m_locked;
+    nullable<PdfFlateParams> m_FlateParams;
+    // NOTE: Streams not being written can be read concurrently,
+    // so the readers are counted
+    std::atomic<unsigned> m_readerCount;
+    bool m_writing;
 };
 
 };
@@ -0,0 +1,441 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <podofo/private/PdfDeclarationsPrivate.h>
+#include "PdfOperandStack.h"
+#include "PdfArray.h"
+#include "PdfDictionary.h"
+
+using namespace std;
+using namespace PoDoFo;
+
+PdfOperand::PdfOperand()
+    : m_Number(0), m_Stack(nullptr), m_DataType(PdfDataType::Null), m_IsHex(false) { }
+
+bool PdfOperand::IsNumberOrReal() const
+{
+    return m_DataType == PdfDataType::Number || m_DataType == PdfDataType::Real;
+}
+
+bool PdfOperand::IsHexString() const
+{
+    return m_DataType == PdfDataType::String && m_IsHex;
+}
+
+bool PdfOperand::GetBool() const
+{
+    bool ret;
+    if (!TryGetBool(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetBool(bool& value) const
+{
+    if (m_DataType != PdfDataType::Bool)
+    {
+        value = false;
+        return false;
+    }
+
+    value = m_Bool;
+    return true;
+}
+
+int64_t PdfOperand::GetNumber() const
+{
+    int64_t ret;
+    if (!TryGetNumber(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetNumber(int64_t& value) const
+{
+    if (m_DataType != PdfDataType::Number)
+    {
+        value = 0;
+        return false;
+    }
+
+    value = m_Number;
+    return true;
+}
+
+double PdfOperand::GetReal() const
+{
+    double ret;
+    if (!TryGetReal(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetReal(double& value) const
+{
+    switch (m_DataType)
+    {
+        case PdfDataType::Real:
+            value = m_Real;
+            return true;
+        case PdfDataType::Number:
+            value = static_cast<double>(m_Number);
+            return true;
+        default:
+            value = 0;
+            return false;
+    }
+}
+
+PdfName PdfOperand::GetName() const
+{
+    PdfName ret;
+    if (!TryGetName(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetName(PdfName& name) const
+{
+    if (m_DataType != PdfDataType::Name)
+        return false;
+
+    name = PdfName::FromEscaped(getView());
+    return true;
+}
+
+string_view PdfOperand::GetNameRaw() const
+{
+    string_view ret;
+    if (!TryGetNameRaw(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetNameRaw(string_view& name) const
+{
+    if (m_DataType != PdfDataType::Name)
+    {
+        name = { };
+        return false;
+    }
+
+    name = getView();
+    return true;
+}
+
+PdfString PdfOperand::GetString() const
+{
+    PdfString ret;
+    if (!TryGetString(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetString(PdfString& str) const
+{
+    if (m_DataType != PdfDataType::String)
+        return false;
+
+    str = PdfString::FromRaw(getView(), m_IsHex);
+    return true;
+}
+
+string_view PdfOperand::GetStringRaw() const
+{
+    string_view ret;
+    if (!TryGetStringRaw(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return ret;
+}
+
+bool PdfOperand::TryGetStringRaw(string_view& str) const
+{
+    if (m_DataType != PdfDataType::String)
+    {
+        str = { };
+        return false;
+    }
+
+    str = getView();
+    return true;
+}
+
+const PdfArray& PdfOperand::GetArray() const
+{
+    const PdfArray* ret;
+    if (!TryGetArray(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return *ret;
+}
+
+bool PdfOperand::TryGetArray(const PdfArray*& arr) const
+{
+    if (m_DataType != PdfDataType::Array)
+    {
+        arr = nullptr;
+        return false;
+    }
+
+    arr = &getVariant().GetArray();
+    return true;
+}
+
+const PdfDictionary& PdfOperand::GetDictionary() const
+{
+    const PdfDictionary* ret;
+    if (!TryGetDictionary(ret))
+        PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+
+    return *ret;
+}
+
+bool PdfOperand::TryGetDictionary(const PdfDictionary*& dict) const
+{
+    if (m_DataType != PdfDataType::Dictionary)
+    {
+        dict = nullptr;
+        return false;
+    }
+
+    dict = &getVariant().GetDictionary();
+    return true;
+}
+
+PdfVariant PdfOperand::ToVariant() const
+{
+    switch (m_DataType)
+    {
+        case PdfDataType::Null:
+            return PdfVariant();
+        case PdfDataType::Bool:
+            return PdfVariant(m_Bool);
+        case PdfDataType::Number:
+            return PdfVariant(m_Number);
+        case PdfDataType::Real:
+            return PdfVariant(m_Real);
+        case PdfDataType::Name:
+            return PdfVariant(PdfName::FromEscaped(getView()));
+        case PdfDataType::String:
+            return PdfVariant(PdfString::FromRaw(getView(), m_IsHex));
+        case PdfDataType::Array:
+        case PdfDataType::Dictionary:
+            return getVariant();
+        default:
+            PODOFO_RAISE_ERROR(PdfErrorCode::InvalidDataType);
+    }
+}
+
+string_view PdfOperand::getView() const
+{
+    PODOFO_ASSERT(m_Stack != nullptr);
+    return string_view(m_Stack->m_buffer.data() + m_View.Offset, m_View.Length);
+}
+
+const PdfVariant& PdfOperand::getVariant() const
+{
+    PODOFO_ASSERT(m_Stack != nullptr);
+    return m_Stack->m_variants[m_VariantIndex];
+}
+
+PdfOperandStack::PdfOperandStack()
+    : m_size(0) { }
+
+PdfOperandStack::PdfOperandStack(const PdfOperandStack& rhs)
+    : m_operands(rhs.m_operands), m_overflow(rhs.m_overflow),
+    m_variants(rhs.m_variants), m_buffer(rhs.m_buffer), m_size(rhs.m_size)
+{
+    rebind();
+}
+
+PdfOperandStack::PdfOperandStack(PdfOperandStack&& rhs) noexcept
+    : m_operands(rhs.m_operands), m_overflow(std::move(rhs.m_overflow)),
+    m_variants(std::move(rhs.m_variants)), m_buffer(std::move(rhs.m_buffer)), m_size(rhs.m_size)
+{
+    rhs.m_size = 0;
+    rebind();
+}
+
+void PdfOperandStack::Clear()
+{
+    // NOTE: Keep the capacity of the buffers, so
+    // following reads don't need to allocate
+    m_overflow.clear();
+    m_variants.clear();
+    m_buffer.clear();
+    m_size = 0;
+}
+
+unsigned PdfOperandStack::GetSize() const
+{
+    return m_size;
+}
+
+PdfVariant PdfOperandStack::GetVariant(unsigned index) const
+{
+    return (*this)[index].ToVariant();
+}
+
+const PdfOperand& PdfOperandStack::operator[](unsigned index) const
+{
+    if (index >= m_size)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Index {} is out of range", index);
+
+    // Access elements from the end
+    index = (m_size - 1) - index;
+    if (index < InlineCapacity)
+        return m_operands[index];
+    else
+        return m_overflow[index - InlineCapacity];
+}
+
+PdfOperandStack& PdfOperandStack::operator=(const PdfOperandStack& rhs)
+{
+    m_operands = rhs.m_operands;
+    m_overflow = rhs.m_overflow;
+    m_variants = rhs.m_variants;
+    m_buffer = rhs.m_buffer;
+    m_size = rhs.m_size;
+    rebind();
+    return *this;
+}
+
+PdfOperandStack& PdfOperandStack::operator=(PdfOperandStack&& rhs) noexcept
+{
+    m_operands = rhs.m_operands;
+    m_overflow = std::move(rhs.m_overflow);
+    m_variants = std::move(rhs.m_variants);
+    m_buffer = std::move(rhs.m_buffer);
+    m_size = rhs.m_size;
+    rhs.m_size = 0;
+    rebind();
+    return *this;
+}
+
+size_t PdfOperandStack::size() const
+{
+    return m_size;
+}
+
+void PdfOperandStack::PushNull()
+{
+    (void)push(PdfDataType::Null);
+}
+
+void PdfOperandStack::PushBool(bool value)
+{
+    push(PdfDataType::Bool).m_Bool = value;
+}
+
+void PdfOperandStack::PushNumber(int64_t value)
+{
+    push(PdfDataType::Number).m_Number = value;
+}
+
+void PdfOperandStack::PushReal(double value)
+{
+    push(PdfDataType::Real).m_Real = value;
+}
+
+void PdfOperandStack::PushName(const string_view& name)
+{
+    auto& operand = push(PdfDataType::Name);
+    operand.m_View.Offset = (unsigned)m_buffer.size();
+    operand.m_View.Length = (unsigned)name.size();
+    m_buffer.append(name.data(), name.size());
+}
+
+void PdfOperandStack::PushString(const string_view& str)
+{
+    auto& operand = push(PdfDataType::String);
+    operand.m_View.Offset = (unsigned)m_buffer.size();
+    operand.m_View.Length = (unsigned)str.size();
+    m_buffer.append(str.data(), str.size());
+}
+
+void PdfOperandStack::PushHexString(const string_view& hex)
+{
+    auto& operand = push(PdfDataType::String);
+    operand.m_IsHex = true;
+    operand.m_View.Offset = (unsigned)m_buffer.size();
+
+    // Decode the hex data straight into the buffer, see also PdfString::FromHexData()
+    unsigned char val;
+    char decodedChar = 0;
+    bool low = true;
+    for (size_t i = 0; i < hex.size(); i++)
+    {
+        char ch = hex[i];
+        if (PoDoFo::IsCharWhitespace(ch))
+            continue;
+
+        (void)utls::TryGetHexValue(ch, val);
+        if (low)
+        {
+            decodedChar = (char)(val & 0x0F);
+            low = false;
+        }
+        else
+        {
+            decodedChar = (char)((decodedChar << 4) | val);
+            low = true;
+            m_buffer.push_back(decodedChar);
+        }
+    }
+
+    // Treat the last digit as if it were followed by zero
+    if (!low)
+        m_buffer.push_back((char)(decodedChar << 4));
+
+    operand.m_View.Length = (unsigned)m_buffer.size() - operand.m_View.Offset;
+}
+
+void PdfOperandStack::PushVariant(PdfVariant&& variant)
+{
+    auto type = variant.GetDataType();
+    if (type != PdfDataType::Array && type != PdfDataType::Dictionary)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidDataType, "Only arrays and dictionaries are stored as variants");
+
+    push(type).m_VariantIndex = (unsigned)m_variants.size();
+    m_variants.push_back(std::move(variant));
+}
+
+PdfOperand& PdfOperandStack::push(PdfDataType type)
+{
+    PdfOperand* operand;
+    if (m_size < InlineCapacity)
+    {
+        operand = &m_operands[m_size];
+    }
+    else
+    {
+        m_overflow.emplace_back();
+        operand = &m_overflow.back();
+    }
+
+    m_size++;
+    operand->m_Number = 0;
+    operand->m_Stack = this;
+    operand->m_DataType = type;
+    operand->m_IsHex = false;
+    return *operand;
+}
+
+void PdfOperandStack::rebind()
+{
+    for (unsigned i = 0; i < m_size && i < InlineCapacity; i++)
+        m_operands[i].m_Stack = this;
+
+    for (auto& operand : m_overflow)
+        operand.m_Stack = this;
+}
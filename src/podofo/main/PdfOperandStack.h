@@ -0,0 +1,169 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#ifndef PDF_OPERAND_STACK_H
+#define PDF_OPERAND_STACK_H
+
+#include "PdfVariant.h"
+
+namespace PoDoFo {
+
+class PdfOperandStack;
+
+/** A compact operand as read from a content stream
+ *
+ * Numbers are stored inline, while names and strings are views
+ * into a buffer owned by the operand stack. Arrays and dictionaries
+ * are the only operands stored as a full PdfVariant. A PdfVariant,
+ * PdfName or PdfString is created only when requested
+ * \remarks Operands and the views they return are valid until
+ * the operand stack is cleared, that is until the next read
+ */
+class PODOFO_API PdfOperand final
+{
+    friend class PdfOperandStack;
+
+public:
+    PdfOperand();
+
+public:
+    PdfDataType GetDataType() const { return m_DataType; }
+
+    bool IsNumberOrReal() const;
+
+    /** True if the operand is a string written as hex string
+     */
+    bool IsHexString() const;
+
+    bool GetBool() const;
+    bool TryGetBool(bool& value) const;
+
+    int64_t GetNumber() const;
+    bool TryGetNumber(int64_t& value) const;
+
+    /** Get the operand as a real number, also converting integer numbers
+     */
+    double GetReal() const;
+    bool TryGetReal(double& value) const;
+
+    /** Get the name, creating a PdfName from the escaped name as read
+     */
+    PdfName GetName() const;
+    bool TryGetName(PdfName& name) const;
+
+    /** Get the name as escaped in the content stream,
+     * without creating a PdfName
+     */
+    std::string_view GetNameRaw() const;
+    bool TryGetNameRaw(std::string_view& name) const;
+
+    /** Get the string, creating a PdfString from the decoded data
+     */
+    PdfString GetString() const;
+    bool TryGetString(PdfString& str) const;
+
+    /** Get the decoded string data, without creating a PdfString
+     */
+    std::string_view GetStringRaw() const;
+    bool TryGetStringRaw(std::string_view& str) const;
+
+    const PdfArray& GetArray() const;
+    bool TryGetArray(const PdfArray*& arr) const;
+
+    const PdfDictionary& GetDictionary() const;
+    bool TryGetDictionary(const PdfDictionary*& dict) const;
+
+    /** Create a full PdfVariant from the operand
+     */
+    PdfVariant ToVariant() const;
+
+private:
+    std::string_view getView() const;
+    const PdfVariant& getVariant() const;
+
+private:
+    union
+    {
+        bool m_Bool;
+        int64_t m_Number;
+        double m_Real;
+        struct
+        {
+            unsigned Offset;
+            unsigned Length;
+        } m_View;
+        unsigned m_VariantIndex;
+    };
+    const PdfOperandStack* m_Stack;
+    PdfDataType m_DataType;
+    bool m_IsHex;
+};
+
+/** A stack of operands read from a content stream, accessed from the top
+ *
+ * The first operands are stored in a fixed capacity inline buffer
+ * and names and strings data are appended to a buffer that is
+ * reused after clearing the stack, so dense content streams can
+ * be read without allocations
+ */
+class PODOFO_API PdfOperandStack final
+{
+    friend class PdfOperand;
+    friend class PdfPostScriptTokenizer;
+
+public:
+    /** The count of operands stored without allocations.
+     * It's enough for all operators with a fixed operand count
+     */
+    static constexpr unsigned InlineCapacity = 16;
+
+public:
+    PdfOperandStack();
+    PdfOperandStack(const PdfOperandStack& rhs);
+    PdfOperandStack(PdfOperandStack&& rhs) noexcept;
+
+public:
+    void Clear();
+    unsigned GetSize() const;
+
+    /** Get a copy of the operand as a full PdfVariant
+     * \param index index of the operand, starting from the top of the stack
+     */
+    PdfVariant GetVariant(unsigned index) const;
+
+public:
+    /** Access the operands from the top of the stack
+     */
+    const PdfOperand& operator[](unsigned index) const;
+    PdfOperandStack& operator=(const PdfOperandStack& rhs);
+    PdfOperandStack& operator=(PdfOperandStack&& rhs) noexcept;
+    size_t size() const;
+
+private:
+    void PushNull();
+    void PushBool(bool value);
+    void PushNumber(int64_t value);
+    void PushReal(double value);
+    void PushName(const std::string_view& name);
+    void PushString(const std::string_view& str);
+    void PushHexString(const std::string_view& hex);
+    void PushVariant(PdfVariant&& variant);
+
+private:
+    PdfOperand& push(PdfDataType type);
+    void rebind();
+
+private:
+    std::array<PdfOperand, InlineCapacity> m_operands;
+    std::vector<PdfOperand> m_overflow;
+    std::vector<PdfVariant> m_variants;
+    charbuff m_buffer;
+    unsigned m_size;
+};
+
+}
+
+#endif // PDF_OPERAND_STACK_H
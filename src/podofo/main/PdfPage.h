@@ -33,6 +33,21 @@ struct PODOFO_API PdfTextEntry final
     nullable<Rect> BoundingBox;
 };
 
+/** A text entry as emitted by the streaming text extraction
+ * \remarks The text view is valid only for the duration of the callback
+ */
+struct PODOFO_API PdfTextEntryView final
+{
+    std::string_view Text;
+    int Page = -1;
+    double X = -1;
+    double Y = -1;
+    double Length = -1;
+    nullable<Rect> BoundingBox;
+};
+
+using PdfTextEntryCallback = std::function<void(const PdfTextEntryView& entry)>;
+
 /** A structure with status progress attributes of certain operations
  */
 struct PODOFO_API AbortCheckInfo final
@@ -165,6 +180,17 @@ public:
         const std::string_view& pattern = { },
         const PdfTextExtractParams& params = { }) const;
 
+    /** Extract text emitting every entry to the callback as soon as
+     * it's complete, without collecting them. Memory usage stays bounded
+     * also on pages with a lot of text
+     */
+    void ExtractTextTo(const PdfTextEntryCallback& callback,
+        const PdfTextExtractParams& params) const;
+
+    void ExtractTextTo(const PdfTextEntryCallback& callback,
+        const std::string_view& pattern = { },
+        const PdfTextExtractParams& params = { }) const;
+
     /** Get the rectangle of this page.
      *  \returns a rectangle. It's oriented according to the canonical PDF coordinate system
      */
@@ -33,14 +33,15 @@ static PdfPageTreeNodeType getPageTreeNodeType(const PdfObject& nodeObj);
 static unsigned getChildCount(const PdfObject& nodeObj);
 
 PdfPageCollection::PdfPageCollection(PdfDocument& doc)
-    : PdfDictionaryElement(doc, "Pages"_n), m_initialized(true)
+    : PdfDictionaryElement(doc, "Pages"_n), m_initialized(true), m_firstPage(nullptr)
 {
     m_kidsArray = &GetDictionary().AddKey("Kids"_n, PdfArray()).GetArray();
     GetDictionary().AddKey("Count"_n, static_cast<int64_t>(0));
 }
 
 PdfPageCollection::PdfPageCollection(PdfObject& pagesRoot)
-    : PdfDictionaryElement(pagesRoot), m_initialized(false), m_kidsArray(nullptr)
+    : PdfDictionaryElement(pagesRoot), m_initialized(false), m_kidsArray(nullptr),
+    m_firstPage(nullptr)
 {
 }
 
@@ -48,6 +49,9 @@ PdfPageCollection::~PdfPageCollection()
 {
     for (unsigned i = 0; i < m_Pages.size(); i++)
         delete m_Pages[i];
+
+    // Not reused when loading the page tree
+    delete m_firstPage;
 }
 
 unsigned PdfPageCollection::GetCount() const
@@ -58,6 +62,9 @@ unsigned PdfPageCollection::GetCount() const
 
 PdfPage& PdfPageCollection::GetPageAt(unsigned index)
 {
+    if (index == 0 && !m_initialized && m_firstPage != nullptr)
+        return *m_firstPage;
+
     const_cast<PdfPageCollection&>(*this).initPages();
     if (index >= m_Pages.size())
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Page with index {} not found", index);
@@ -67,6 +74,9 @@ PdfPage& PdfPageCollection::GetPageAt(unsigned index)
 
 const PdfPage& PdfPageCollection::GetPageAt(unsigned index) const
 {
+    if (index == 0 && !m_initialized && m_firstPage != nullptr)
+        return *m_firstPage;
+
     const_cast<PdfPageCollection&>(*this).initPages();
     if (index >= m_Pages.size())
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Page with index {} not found", index);
@@ -361,7 +371,18 @@ unsigned PdfPageCollection::traversePageTreeNode(PdfObject& obj, unsigned count,
         case PdfPageTreeNodeType::Page:
         {
             unsigned index = (unsigned)m_Pages.size();
-            unique_ptr<PdfPage> page(new PdfPage(obj, vector<PdfObject*>(parents)));
+            unique_ptr<PdfPage> page;
+            if (index == 0 && m_firstPage != nullptr && &m_firstPage->GetObject() == &obj)
+            {
+                // Reuse the page that may be already in use
+                page.reset(m_firstPage);
+                m_firstPage = nullptr;
+            }
+            else
+            {
+                page.reset(new PdfPage(obj, vector<PdfObject*>(parents)));
+            }
+
             m_Pages.push_back(page.get());
             (*page.release()).SetIndex(index);
             return count - 1;
@@ -375,6 +396,53 @@ unsigned PdfPageCollection::traversePageTreeNode(PdfObject& obj, unsigned count,
     }
 }
 
+void PdfPageCollection::initFirstPage(const PdfReference& ref, unsigned pageCount)
+{
+    if (m_initialized || m_firstPage != nullptr || getChildCount(GetObject()) != pageCount)
+        return;
+
+    auto& objects = GetDocument().GetObjects();
+    auto pageObj = objects.GetObject(ref);
+    if (pageObj == nullptr || !pageObj->IsDictionary()
+        || getPageTreeNodeType(*pageObj) != PdfPageTreeNodeType::Page)
+    {
+        return;
+    }
+
+    // Walk up to the root, checking that the page
+    // is the first kid of every ancestor
+    vector<PdfObject*> parents;
+    unordered_set<PdfObject*> visitedNodes;
+    PdfObject* child = pageObj;
+    PdfReference parentRef;
+    while (child != &GetObject())
+    {
+        auto parentObj = child->GetDictionary().GetKey("Parent");
+        PdfObject* parent;
+        const PdfArray* kidsArr;
+        PdfReference kidRef;
+        if (parentObj == nullptr || !parentObj->TryGetReference(parentRef)
+            || (parent = objects.GetObject(parentRef)) == nullptr
+            || !parent->IsDictionary()
+            || getPageTreeNodeType(*parent) != PdfPageTreeNodeType::Node
+            || !visitedNodes.insert(parent).second
+            || !parent->GetDictionary().TryFindKeyAs("Kids", kidsArr)
+            || kidsArr->GetSize() == 0
+            || !(*kidsArr)[0].TryGetReference(kidRef)
+            || kidRef != child->GetIndirectReference())
+        {
+            return;
+        }
+
+        parents.push_back(parent);
+        child = parent;
+    }
+
+    std::reverse(parents.begin(), parents.end());
+    m_firstPage = new PdfPage(*pageObj, std::move(parents));
+    m_firstPage->SetIndex(0);
+}
+
 void PdfPageCollection::FlattenStructure()
 {
     if (m_kidsArray != nullptr)
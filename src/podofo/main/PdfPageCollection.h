@@ -23,6 +23,7 @@ namespace PoDoFo {
 class PODOFO_API PdfPageCollection final : public PdfDictionaryElement
 {
     friend class PdfDocument;
+    friend class PdfMemDocument;
     friend class PdfPage;
 
 public:
@@ -218,6 +219,12 @@ private:
 
     void initPages();
 
+    /** Create the first page of a linearized document without
+     *  traversing the page tree. It's used only if the page is
+     *  the first leaf of the tree and the tree has pageCount pages
+     */
+    void initFirstPage(const PdfReference& ref, unsigned pageCount);
+
     unsigned traversePageTreeNode(PdfObject& obj, unsigned count,
         std::vector<PdfObject*>& parents, std::unordered_set<PdfObject*>& visitedNodes);
 
@@ -228,6 +235,7 @@ private:
     bool m_initialized;
     PageList m_Pages;
     PdfArray* m_kidsArray;
+    PdfPage* m_firstPage; // Served before the page tree is loaded
 };
 
 };
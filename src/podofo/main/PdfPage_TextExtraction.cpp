@@ -111,10 +111,17 @@ struct XObjectState
     unsigned TextStateIndex;
 };
 
+struct CachedFont
+{
+    const PdfObject* Resources;     ///< The resources object, which is owned by the document
+    PdfName Name;
+    const PdfFont* Font;
+};
+
 struct ExtractionContext
 {
 public:
-    ExtractionContext(vector<PdfTextEntry> &entries, const PdfPage &page, const string_view &pattern,
+    ExtractionContext(const PdfTextEntryCallback& callback, const PdfPage &page, const string_view &pattern,
         PdfTextExtractFlags flags, const nullable<Rect> &clipRect);
 public:
     void BeginText();
@@ -136,15 +143,18 @@ private:
     void tryAddEntry(const StatefulString& currStr);
     const PdfCanvas& getActualCanvas();
     const StatefulString& getPreviouString() const;
+    const PdfFont* getFont(const PdfResources& resources, const PdfName& fontname);
 private:
     const PdfPage& m_page;
+    // Fonts resolved by Tf operators. Pages usually use few fonts
+    vector<CachedFont> m_fonts;
 public:
     const int PageIndex;
     const string Pattern;
     const EntryOptions Options;
     const nullable<Rect> ClipRect;
     unique_ptr<Matrix> Rotation;
-    vector<PdfTextEntry> &Entries;
+    const PdfTextEntryCallback& Callback;
     StringChunkPtr Chunk = std::make_unique<StringChunk>();
     StringChunkList Chunks;
     TextStateStack States;
@@ -168,10 +178,10 @@ static void splitChunkBySpaces(vector<StringChunkPtr> &splittedChunks, const Str
 static void splitStringBySpaces(vector<StatefulString> &separatedStrings, const StatefulString &string);
 static void trimSpacesBegin(StringChunk &chunk);
 static void trimSpacesEnd(StringChunk &chunk);
-static void addEntry(vector<PdfTextEntry> &textEntries, StringChunkList &strings,
+static void addEntry(const PdfTextEntryCallback& callback, StringChunkList &strings,
     const string_view &pattern, const EntryOptions &options, const nullable<Rect> &clipRect,
     int pageIndex, const Matrix* rotation);
-static void addEntryChunk(vector<PdfTextEntry> &textEntries, StringChunkList &strings,
+static void addEntryChunk(const PdfTextEntryCallback& callback, StringChunkList &strings,
     const string_view &pattern, const EntryOptions& options, const nullable<Rect> &clipRect,
     int pageIndex, const Matrix* rotation);
 static void processChunks(const StringChunkList& chunks, string& destString,
@@ -181,8 +191,8 @@ static double computeLength(const vector<const StatefulString*>& strings, const
     unsigned lowerIndex, unsigned upperIndex);
 static bool isMatchWholeWordSubstring(const string_view& str, const string_view& pattern, size_t& matchPos);
 static Rect computeBoundingBox(const TextState& textState, double boxWidth);
-static void read(const PdfVariantStack& stack, double &tx, double &ty);
-static void read(const PdfVariantStack& stack, double &a, double &b, double &c, double &d, double &e, double &f);
+static void read(const PdfOperandStack& stack, double &tx, double &ty);
+static void read(const PdfOperandStack& stack, double &a, double &b, double &c, double &d, double &e, double &f);
 static void getSubstringIndices(const vector<unsigned>& positions, unsigned lowerPos, unsigned upperLimitPos,
     unsigned& lowerIndex, unsigned& upperLimitIndex);
 static EntryOptions optionsFromFlags(PdfTextExtractFlags flags);
@@ -195,7 +205,21 @@ void PdfPage::ExtractTextTo(vector<PdfTextEntry>& entries, const PdfTextExtractP
 void PdfPage::ExtractTextTo(vector<PdfTextEntry>& entries, const string_view& pattern,
     const PdfTextExtractParams& params) const
 {
-    ExtractionContext context(entries, *this, pattern, params.Flags, params.ClipRect);
+    ExtractTextTo([&entries](const PdfTextEntryView& entry) {
+        entries.push_back(PdfTextEntry{ (string)entry.Text, entry.Page,
+            entry.X, entry.Y, entry.Length, entry.BoundingBox });
+    }, pattern, params);
+}
+
+void PdfPage::ExtractTextTo(const PdfTextEntryCallback& callback, const PdfTextExtractParams& params) const
+{
+    ExtractTextTo(callback, { }, params);
+}
+
+void PdfPage::ExtractTextTo(const PdfTextEntryCallback& callback, const string_view& pattern,
+    const PdfTextExtractParams& params) const
+{
+    ExtractionContext context(callback, *this, pattern, params.Flags, params.ClipRect);
 
     // Look FIGURE 4.1 Graphics objects
     PdfContentReaderArgs args;
@@ -295,7 +319,7 @@ void PdfPage::ExtractTextTo(vector<PdfTextEntry>& entries, const string_view& pa
                     case PdfOperator::Tf:
                     {
                         double fontSize = content.Stack[0].GetReal();
-                        auto& fontName = content.Stack[1].GetName();
+                        auto fontName = content.Stack[1].GetName();
                         context.Tf_Operator(fontName, fontSize);
                         break;
                     }
@@ -310,7 +334,7 @@ void PdfPage::ExtractTextTo(vector<PdfTextEntry>& entries, const string_view& pa
                     {
                         ASSERT(context.BlockOpen, "No text block open");
 
-                        auto& str = content.Stack[0].GetString();
+                        auto str = content.Stack[0].GetString();
                         if (content.Operator == PdfOperator::DoubleQuote)
                         {
                             // Operator " arguments: aw ac string "
@@ -446,7 +470,7 @@ void PdfPage::ExtractTextTo(vector<PdfTextEntry>& entries, const string_view& pa
     context.TryAddLastEntry();
 }
 
-void addEntry(vector<PdfTextEntry> &textEntries, StringChunkList &chunks, const string_view &pattern,
+void addEntry(const PdfTextEntryCallback& callback, StringChunkList &chunks, const string_view &pattern,
     const EntryOptions &options, const nullable<Rect> &clipRect, int pageIndex, const Matrix* rotation)
 {
     if (options.TokenizeWords)
@@ -500,18 +524,18 @@ void addEntry(vector<PdfTextEntry> &textEntries, StringChunkList &chunks, const
 
         for (auto& batch : batches)
         {
-            addEntryChunk(textEntries, *batch, pattern, options,
+            addEntryChunk(callback, *batch, pattern, options,
                 clipRect, pageIndex, rotation);
         }
     }
     else
     {
-        addEntryChunk(textEntries, chunks, pattern, options,
+        addEntryChunk(callback, chunks, pattern, options,
             clipRect, pageIndex, rotation);
     }
 }
 
-void addEntryChunk(vector<PdfTextEntry> &textEntries, StringChunkList &chunks, const string_view &pattern,
+void addEntryChunk(const PdfTextEntryCallback& callback, StringChunkList &chunks, const string_view &pattern,
     const EntryOptions& options, const nullable<Rect> &clipRect, int pageIndex, const Matrix* rotation)
 {
     if (options.TrimSpaces)
@@ -656,27 +680,27 @@ void addEntryChunk(vector<PdfTextEntry> &textEntries, StringChunkList &chunks, c
     auto strPosition = textState.T_rm.GetTranslationVector();
     if (rotation == nullptr || options.RawCoordinates)
     {
-        textEntries.push_back(PdfTextEntry{ str, pageIndex,
+        callback(PdfTextEntryView{ str, pageIndex,
             strPosition.X, strPosition.Y, strLength, bbox });
     }
     else
     {
         Vector2 rawp(strPosition.X, strPosition.Y);
         auto p_1 = rawp * (*rotation);
-        textEntries.push_back(PdfTextEntry{ str, pageIndex,
+        callback(PdfTextEntryView{ str, pageIndex,
             p_1.X, p_1.Y, strLength, bbox });
     }
 
     chunks.clear();
 }
 
-void read(const PdfVariantStack& tokens, double & tx, double & ty)
+void read(const PdfOperandStack& tokens, double & tx, double & ty)
 {
     ty = tokens[0].GetReal();
     tx = tokens[1].GetReal();
 }
 
-void read(const PdfVariantStack& tokens, double & a, double & b, double & c, double & d, double & e, double & f)
+void read(const PdfOperandStack& tokens, double & a, double & b, double & c, double & d, double & e, double & f)
 {
     f = tokens[0].GetReal();
     e = tokens[1].GetReal();
@@ -858,14 +882,14 @@ vector<double> StatefulString::computeLengths(const vector<double>& rawLengths)
     return ret;
 }
 
-ExtractionContext::ExtractionContext(vector<PdfTextEntry>& entries, const PdfPage& page, const string_view& pattern,
+ExtractionContext::ExtractionContext(const PdfTextEntryCallback& callback, const PdfPage& page, const string_view& pattern,
     PdfTextExtractFlags flags , const nullable<Rect>& clipRect) :
     m_page(page),
     PageIndex(page.GetPageNumber() - 1),
     Pattern(pattern),
     Options(optionsFromFlags(flags)),
     ClipRect(clipRect),
-    Entries(entries)
+    Callback(callback)
 {
     if (Options.ExtractSubstring && pattern.empty())
         PODOFO_RAISE_ERROR_INFO(PdfErrorCode::NotImplemented, "Unsupported ExtractSubstring flag with empty pattern");
@@ -899,7 +923,7 @@ void ExtractionContext::Tf_Operator(const PdfName &fontname, double fontsize)
     double spacingLengthRaw = 0;
     double spaceCharLengthRaw = 0;
     States.Current->PdfState.FontSize = fontsize;
-    if (resources == nullptr || (States.Current->PdfState.Font = resources->GetFont(fontname)) == nullptr)
+    if (resources == nullptr || (States.Current->PdfState.Font = getFont(*resources, fontname)) == nullptr)
     {
         PoDoFo::LogMessage(PdfLogSeverity::Warning, "Unable to find font object {}", fontname.GetString());
     }
@@ -1013,6 +1037,19 @@ const PdfCanvas& ExtractionContext::getActualCanvas()
     return *XObjectStateIndices.back().Form;
 }
 
+const PdfFont* ExtractionContext::getFont(const PdfResources& resources, const PdfName& fontname)
+{
+    for (auto& cached : m_fonts)
+    {
+        if (cached.Resources == &resources.GetObject() && cached.Name == fontname)
+            return cached.Font;
+    }
+
+    auto font = resources.GetFont(fontname);
+    m_fonts.push_back({ &resources.GetObject(), fontname, font });
+    return font;
+}
+
 const StatefulString& ExtractionContext::getPreviouString() const
 {
     const StatefulString* prevString;
@@ -1031,7 +1068,7 @@ const StatefulString& ExtractionContext::getPreviouString() const
 
 void ExtractionContext::addEntry()
 {
-    ::addEntry(Entries, Chunks, Pattern, Options, ClipRect, PageIndex, Rotation.get());
+    ::addEntry(Callback, Chunks, Pattern, Options, ClipRect, PageIndex, Rotation.get());
 }
 
 void ExtractionContext::tryAddEntry(const StatefulString& currStr)
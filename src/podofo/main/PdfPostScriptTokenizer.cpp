@@ -95,6 +95,82 @@ bool PdfPostScriptTokenizer::TryReadNext(InputStreamDevice& device, PdfPostScrip
     return true;
 }
 
+bool PdfPostScriptTokenizer::TryReadNext(InputStreamDevice& device, PdfPostScriptTokenType& psTokenType, string_view& keyword, PdfOperandStack& operands)
+{
+    PdfTokenType tokenType;
+    string_view token;
+    keyword = { };
+    bool gotToken = PdfTokenizer::TryReadNextToken(device, token, tokenType);
+    if (!gotToken)
+    {
+        psTokenType = PdfPostScriptTokenType::Unknown;
+        return false;
+    }
+
+    switch (tokenType)
+    {
+        case PdfTokenType::BraceLeft:
+            psTokenType = PdfPostScriptTokenType::ProcedureEnter;
+            return true;
+        case PdfTokenType::BraceRight:
+            psTokenType = PdfPostScriptTokenType::ProcedureExit;
+            return true;
+        default:
+            // Continue evaluating data type
+            break;
+    }
+
+    // NOTE: Scalars are read into the variant without allocations
+    PdfVariant variant;
+    string_view str;
+    PdfLiteralDataType dataType = DetermineDataType(device, token, tokenType, variant);
+    psTokenType = PdfPostScriptTokenType::Variant;
+    switch (dataType)
+    {
+        case PdfLiteralDataType::Null:
+            operands.PushNull();
+            break;
+        case PdfLiteralDataType::Bool:
+            operands.PushBool(variant.GetBool());
+            break;
+        case PdfLiteralDataType::Number:
+            operands.PushNumber(variant.GetNumber());
+            break;
+        case PdfLiteralDataType::Real:
+            operands.PushReal(variant.GetReal());
+            break;
+        case PdfLiteralDataType::Dictionary:
+            this->ReadDictionary(device, variant, { });
+            operands.PushVariant(std::move(variant));
+            break;
+        case PdfLiteralDataType::Array:
+            this->ReadArray(device, variant, { });
+            operands.PushVariant(std::move(variant));
+            break;
+        case PdfLiteralDataType::String:
+            this->ReadString(device, str);
+            operands.PushString(str);
+            break;
+        case PdfLiteralDataType::HexString:
+            this->ReadHexString(device, str);
+            operands.PushHexString(str);
+            break;
+        case PdfLiteralDataType::Name:
+            this->ReadName(device, str);
+            operands.PushName(str);
+            break;
+        case PdfLiteralDataType::Reference:
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Unsupported reference datatype at this context");
+        default:
+            // Assume we have a keyword
+            keyword = token;
+            psTokenType = PdfPostScriptTokenType::Keyword;
+            break;
+    }
+
+    return true;
+}
+
 PdfTokenizerOptions getPostScriptOptions(PdfPostScriptLanguageLevel level)
 {
     PdfTokenizerOptions tokenizerOpts;
@@ -9,6 +9,7 @@
 
 #include "PdfTokenizer.h"
 #include "PdfVariant.h"
+#include "PdfOperandStack.h"
 #include <podofo/auxiliary/InputDevice.h>
 
 namespace PoDoFo {
@@ -37,6 +38,11 @@ public:
         PdfPostScriptLanguageLevel level = PdfPostScriptLanguageLevel::L2);
 public:
     bool TryReadNext(InputStreamDevice& device, PdfPostScriptTokenType& tokenType, std::string_view& keyword, PdfVariant& variant);
+
+    /** Read the next token, pushing variants to the given operand stack in compact form.
+     * Names and strings don't create PdfName or PdfString instances
+     */
+    bool TryReadNext(InputStreamDevice& device, PdfPostScriptTokenType& tokenType, std::string_view& keyword, PdfOperandStack& operands);
     void ReadNextVariant(InputStreamDevice& device, PdfVariant& variant);
     bool TryReadNextVariant(InputStreamDevice& device, PdfVariant& variant);
 };
@@ -174,6 +174,9 @@ void PdfSigningContext::saveDocForSigning(PdfMemDocument& doc, StreamDevice& dev
         acroForm->GetDictionary().RemoveKey("NeedAppearances");
     }
 
+    // NOTE: The signature beacons must be written directly to
+    // the device, so objects can't be packed in object streams
+    saveOptions &= ~PdfSaveOptions::CompressObjects;
     if ((saveOptions & PdfSaveOptions::SaveOnSigning) != PdfSaveOptions::None)
         doc.Save(device, saveOptions);
     else
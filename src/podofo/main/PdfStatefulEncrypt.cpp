@@ -25,6 +25,16 @@ void PdfStatefulEncrypt::DecryptTo(charbuff& out, const bufferview& view) const
     m_encrypt->DecryptTo(out, view, *m_context, m_currReference);
 }
 
+unique_ptr<PdfEncryptOutputStream> PdfStatefulEncrypt::CreateEncryptionOutputStream(OutputStream& stream) const
+{
+    return m_encrypt->CreateEncryptionOutputStream(stream, *m_context, m_currReference);
+}
+
+unique_ptr<InputStream> PdfStatefulEncrypt::CreateEncryptionInputStream(InputStream& stream, size_t inputLen) const
+{
+    return m_encrypt->CreateEncryptionInputStream(stream, inputLen, *m_context, m_currReference);
+}
+
 size_t PdfStatefulEncrypt::CalculateStreamLength(size_t length) const
 {
     return m_encrypt->CalculateStreamLength(length);
@@ -26,8 +26,26 @@ namespace PoDoFo
          */
         void DecryptTo(charbuff& out, const bufferview& view) const;
 
+        /** Create a stream that encrypts all data written to it
+         * \remarks PdfEncryptOutputStream::Close() must be called
+         * after all the data has been written
+         */
+        std::unique_ptr<PdfEncryptOutputStream> CreateEncryptionOutputStream(OutputStream& stream) const;
+
+        /** Create a stream that decrypts the given amount of
+         * encrypted data read from the input stream
+         */
+        std::unique_ptr<InputStream> CreateEncryptionInputStream(InputStream& stream, size_t inputLen) const;
+
         size_t CalculateStreamLength(size_t length) const;
 
+        /** Set the reference of the object being encrypted/decrypted,
+         * so the same instance can be reused for several objects
+         */
+        void SetCurrentReference(const PdfReference& objref) { m_currReference = objref; }
+
+        const PdfReference& GetCurrentReference() const { return m_currReference; }
+
     private:
         PdfStatefulEncrypt(const PdfStatefulEncrypt&) = delete;
         PdfStatefulEncrypt& operator=(const PdfStatefulEncrypt&) = delete;
@@ -256,7 +256,8 @@ void PdfString::Write(OutputStream& device, PdfWriteFlags writeFlags,
         view = string_view(tempBuffer.data(), tempBuffer.size());
     }
 
-    utls::SerializeEncodedString(device, view, m_isHex,
+    utls::SerializeEncodedString(device, view,
+        m_isHex || (writeFlags & PdfWriteFlags::HexStrings) != PdfWriteFlags::None,
         (writeFlags & PdfWriteFlags::SkipDelimiters) != PdfWriteFlags::None);
 }
 
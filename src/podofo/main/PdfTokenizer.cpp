@@ -19,9 +19,66 @@
 using namespace std;
 using namespace PoDoFo;
 
+namespace
+{
+    enum CharClass : uint8_t
+    {
+        CharClassRegular = 0,
+        CharClassWhitespace = 1,
+        CharClassDelimiter = 2,
+        // Delimiters that are single character tokens
+        CharClassTokenDelimiter = 4,
+        // Characters that can be part of a number
+        CharClassNumber = 8,
+    };
+
+    // Character classes and token types of the single
+    // character tokens, indexed by the character value
+    struct CharTable final
+    {
+        constexpr CharTable() : Classes{ }, TokenTypes{ }
+        {
+            Classes[0] = CharClassWhitespace;
+            for (char ch : { '\t', '\n', '\f', '\r', ' ' })
+                Classes[(unsigned char)ch] = CharClassWhitespace;
+
+            for (char ch : { '(', ')', '<', '>', '[', ']', '{', '}', '/', '%' })
+                Classes[(unsigned char)ch] = CharClassDelimiter;
+
+            setTokenDelimiter('(', PdfTokenType::ParenthesisLeft);
+            setTokenDelimiter(')', PdfTokenType::ParenthesisRight);
+            setTokenDelimiter('[', PdfTokenType::SquareBracketLeft);
+            setTokenDelimiter(']', PdfTokenType::SquareBracketRight);
+            setTokenDelimiter('{', PdfTokenType::BraceLeft);
+            setTokenDelimiter('}', PdfTokenType::BraceRight);
+            setTokenDelimiter('/', PdfTokenType::Slash);
+
+            for (char ch = '0'; ch <= '9'; ch++)
+                Classes[(unsigned char)ch] = CharClassNumber;
+
+            for (char ch : { '+', '-', '.' })
+                Classes[(unsigned char)ch] = CharClassNumber;
+        }
+
+        uint8_t Classes[256];
+        PdfTokenType TokenTypes[256];
+
+    private:
+        constexpr void setTokenDelimiter(char ch, PdfTokenType type)
+        {
+            Classes[(unsigned char)ch] = CharClassDelimiter | CharClassTokenDelimiter;
+            TokenTypes[(unsigned char)ch] = type;
+        }
+    };
+}
+
+static constexpr CharTable s_charTable;
+
 static bool tryGetEscapedCharacter(char ch, char& escapedChar);
 static void readHexString(InputStreamDevice& device, charbuff& buffer);
 static bool isOctalChar(char ch);
+static bool tryPeekNonWhitespace(InputStreamDevice& device, char& ch);
+static uint8_t getCharClass(char ch);
 
 PdfTokenizer::PdfTokenizer(const PdfTokenizerOptions& options)
     : PdfTokenizer(std::in_place, std::make_shared<charbuff>(BufferSize), options)
@@ -34,7 +91,8 @@ PdfTokenizer::PdfTokenizer(shared_ptr<charbuff> buffer, const PdfTokenizerOption
 }
 
 PdfTokenizer::PdfTokenizer(std::in_place_t, shared_ptr<charbuff>&& buffer, const PdfTokenizerOptions& options)
-    : m_buffer(std::move(buffer)), m_options(options)
+    : m_buffer(std::move(buffer)), m_options(options), m_tokenQueue{ },
+    m_tokenQueueStart(0), m_tokenQueueCount(0)
 {
     if (m_buffer == nullptr)
         PODOFO_RAISE_ERROR(PdfErrorCode::InvalidHandle);
@@ -53,18 +111,22 @@ bool PdfTokenizer::TryReadNextToken(InputStreamDevice& device, string_view& toke
     size_t bufferSize = m_buffer->size() - 1;
 
     // check first if there are queued tokens and return them first
-    if (m_tokenQueque.size() != 0)
+    if (m_tokenQueueCount != 0)
     {
-        auto& pair = m_tokenQueque.front();
-        tokenType = pair.second;
+        auto& queued = m_tokenQueue[m_tokenQueueStart];
+        tokenType = queued.Type;
 
-        size_t size = std::min(bufferSize, pair.first.size());
+        size_t size = std::min(bufferSize, (size_t)queued.Length);
         // make sure buffer is \0 terminated
-        std::memcpy(buffer, pair.first.data(), size);
+        std::memcpy(buffer, m_tokenQueueBuffer.data() + queued.Offset, size);
         buffer[size] = '\0';
         token = string_view(buffer, size);
 
-        m_tokenQueque.pop_front();
+        m_tokenQueueStart = (m_tokenQueueStart + 1) % TokenQueueSize;
+        m_tokenQueueCount--;
+        if (m_tokenQueueCount == 0)
+            clearTokenQueue();
+
         return true;
     }
 
@@ -78,8 +140,10 @@ bool PdfTokenizer::TryReadNextToken(InputStreamDevice& device, string_view& toke
         if (!device.Peek(ch1))
             goto Eof;
 
+        uint8_t charClass = getCharClass(ch1);
+
         // ignore leading whitespaces
-        if (count == 0 && IsCharWhitespace(ch1))
+        if (count == 0 && charClass == CharClassWhitespace)
         {
             // Consume the whitespace character
             (void)device.ReadChar();
@@ -138,7 +202,7 @@ bool PdfTokenizer::TryReadNextToken(InputStreamDevice& device, string_view& toke
 
             break;
         }
-        else if (count != 0 && (IsCharWhitespace(ch1) || IsCharDelimiter(ch1)))
+        else if (count != 0 && charClass != CharClassRegular && charClass != CharClassNumber)
         {
             // Next (unconsumed) character is a token-terminating char, so
             // we have a complete token and can return it.
@@ -151,13 +215,12 @@ bool PdfTokenizer::TryReadNextToken(InputStreamDevice& device, string_view& toke
             buffer[count] = ch1;
             count++;
 
-            PdfTokenType tokenDelimiterType;
-            if (IsCharTokenDelimiter(ch1, tokenDelimiterType))
+            if ((charClass & CharClassTokenDelimiter) != 0)
             {
                 // All delimiters except << and >> (handled above) are
                 // one-character tokens, so if we hit one we can just return it
                 // immediately.
-                tokenType = tokenDelimiterType;
+                tokenType = s_charTable.TokenTypes[(unsigned char)ch1];
                 break;
             }
         }
@@ -280,20 +343,17 @@ PdfTokenizer::PdfLiteralDataType PdfTokenizer::DetermineDataType(InputStreamDevi
             }
 
             PdfLiteralDataType dataType = PdfLiteralDataType::Number;
-            const char* start = token.data();
-            while (*start)
+            for (char ch : token)
             {
-                if (*start == '.')
+                if (ch == '.')
                 {
                     dataType = PdfLiteralDataType::Real;
                 }
-                else if (!(isdigit(*start) || *start == '-' || *start == '+'))
+                else if (getCharClass(ch) != CharClassNumber)
                 {
                     dataType = PdfLiteralDataType::Unknown;
                     break;
                 }
-
-                start++;
             }
 
             if (dataType == PdfLiteralDataType::Real)
@@ -325,6 +385,20 @@ PdfTokenizer::PdfLiteralDataType PdfTokenizer::DetermineDataType(InputStreamDevi
                     return PdfLiteralDataType::Number;
                 }
 
+                // Plain numbers are much more frequent than references:
+                // when there are no queued tokens check the following
+                // characters first, to not enqueue and read again tokens.
+                // Skipping whitespaces is safe, since they separate tokens.
+                // Comments are not skipped, so they fall back to reading tokens
+                bool lookAhead = m_tokenQueueCount == 0;
+                char ch;
+                if (lookAhead && (!tryPeekNonWhitespace(device, ch)
+                    || (getCharClass(ch) != CharClassNumber && ch != '%')))
+                {
+                    new(&variant.m_Number)PdfVariant::PrimitiveMember(num1);
+                    return PdfLiteralDataType::Number;
+                }
+
                 // read another two tokens to see if it is a reference
                 // we cannot be sure that there is another token
                 // on the input device, so if we hit EOF just return
@@ -355,6 +429,14 @@ PdfTokenizer::PdfLiteralDataType PdfTokenizer::DetermineDataType(InputStreamDevi
                     return PdfLiteralDataType::Number;
                 }
 
+                if (lookAhead && (!tryPeekNonWhitespace(device, ch) || (ch != 'R' && ch != '%')))
+                {
+                    // Not a reference: only the second number must be read again
+                    this->EnqueueToken(nextToken, secondTokenType);
+                    new(&variant.m_Number)PdfVariant::PrimitiveMember(num1);
+                    return PdfLiteralDataType::Number;
+                }
+
                 string tmp(nextToken);
                 PdfTokenType thirdTokenType;
                 gotToken = this->TryReadNextToken(device, nextToken, thirdTokenType);
@@ -530,6 +612,31 @@ void PdfTokenizer::ReadString(InputStreamDevice& device, PdfVariant& variant, co
 {
     PODOFO_ASSERT(variant.GetDataType() == PdfDataType::Null);
 
+    string_view str;
+    ReadString(device, str);
+    if (str.size() != 0)
+    {
+        if (encrypt != nullptr)
+        {
+            charbuff decrypted;
+            encrypt->DecryptTo(decrypted, { str.data(), str.size() });
+            new(&variant.m_String)PdfString(std::move(decrypted), false);
+        }
+        else
+        {
+            new(&variant.m_String)PdfString(charbuff(str.data(), str.size()), false);
+        }
+    }
+    else
+    {
+        // NOTE: The string is empty but ensure it will be
+        // initialized as a raw buffer first
+        new(&variant.m_String)PdfString(charbuff(), false);
+    }
+}
+
+void PdfTokenizer::ReadString(InputStreamDevice& device, string_view& str)
+{
     char ch;
     bool escape = false;
     bool octEscape = false;
@@ -625,74 +732,85 @@ void PdfTokenizer::ReadString(InputStreamDevice& device, PdfVariant& variant, co
     if (octEscape)
         m_charBuffer.push_back(octValue);
 
-    if (m_charBuffer.size() != 0)
-    {
-        if (encrypt != nullptr)
-        {
-            charbuff decrypted;
-            encrypt->DecryptTo(decrypted, { m_charBuffer.data(), m_charBuffer.size() });
-            new(&variant.m_String)PdfString(std::move(decrypted), false);
-        }
-        else
-        {
-            new(&variant.m_String)PdfString(charbuff(m_charBuffer.data(), m_charBuffer.size()), false);
-        }
-    }
-    else
-    {
-        // NOTE: The string is empty but ensure it will be
-        // initialized as a raw buffer first
-        new(&variant.m_String)PdfString(charbuff(), false);
-    }
+    str = string_view(m_charBuffer.data(), m_charBuffer.size());
 }
 
 void PdfTokenizer::ReadHexString(InputStreamDevice& device, PdfVariant& variant, const PdfStatefulEncrypt* encrypt)
 {
     PODOFO_ASSERT(variant.GetDataType() == PdfDataType::Null);
+    string_view hex;
+    ReadHexString(device, hex);
+    new(&variant.m_String)PdfString(PdfString::FromHexData(hex, encrypt));
+}
+
+void PdfTokenizer::ReadHexString(InputStreamDevice& device, string_view& hex)
+{
     readHexString(device, m_charBuffer);
-    new(&variant.m_String)PdfString(PdfString::FromHexData({ m_charBuffer.size() ? m_charBuffer.data() : "", m_charBuffer.size() }, encrypt));
+    hex = string_view(m_charBuffer.data(), m_charBuffer.size());
 }
 
 void PdfTokenizer::ReadName(InputStreamDevice& device, PdfVariant& variant)
 {
     PODOFO_ASSERT(variant.GetDataType() == PdfDataType::Null);
 
+    string_view name;
+    ReadName(device, name);
+    if (name.size() == 0)
+        new(&variant.m_Name)PdfName();
+    else
+        new(&variant.m_Name)PdfName(PdfName::FromEscaped(name));
+}
+
+void PdfTokenizer::ReadName(InputStreamDevice& device, string_view& name)
+{
     // Do special checking for empty names
     // as tryReadNextToken will ignore white spaces
     // and we have to take care for stuff like:
     // 10 0 obj / endobj
     // which stupid but legal PDF
     char ch;
-    if (!device.Peek(ch) || IsCharWhitespace(ch))
+    if (!device.Peek(ch) || getCharClass(ch) == CharClassWhitespace)
     {
         // We have an empty PdfName
         // NOTE: Delimiters are handled correctly by tryReadNextToken
-        new(&variant.m_Name)PdfName();
+        name = { };
         return;
     }
 
     PdfTokenType tokenType;
-    string_view token;
-    bool gotToken = this->TryReadNextToken(device, token, tokenType);
+    bool gotToken = this->TryReadNextToken(device, name, tokenType);
     if (!gotToken || tokenType != PdfTokenType::Literal)
     {
         // We got an empty name which is legal according to the PDF specification
         // Some weird PDFs even use them.
-        new(&variant.m_Name)PdfName();
-
         // Enqueue the token again
         if (gotToken)
-            EnqueueToken(token, tokenType);
-    }
-    else
-    {
-        new(&variant.m_Name)PdfName(PdfName::FromEscaped(token));
+            EnqueueToken(name, tokenType);
+
+        name = { };
     }
 }
 
 void PdfTokenizer::EnqueueToken(const string_view& token, PdfTokenType tokenType)
 {
-    m_tokenQueque.push_back(TokenizerPair(string(token), tokenType));
+    if (m_tokenQueueCount == TokenQueueSize)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Too many tokens enqueued");
+
+    // The buffer is reset when the queue is emptied, so it
+    // doesn't grow past the size of a few tokens
+    auto& queued = m_tokenQueue[(m_tokenQueueStart + m_tokenQueueCount) % TokenQueueSize];
+    queued.Offset = (unsigned)m_tokenQueueBuffer.size();
+    queued.Length = (unsigned)token.size();
+    queued.Type = tokenType;
+    m_tokenQueueBuffer.append(token.data(), token.size());
+    m_tokenQueueCount++;
+}
+
+void PdfTokenizer::clearTokenQueue()
+{
+    m_tokenQueueStart = 0;
+    m_tokenQueueCount = 0;
+    m_tokenQueueBuffer.clear();
 }
 
 bool tryGetEscapedCharacter(char ch, char& escapedChar)
@@ -748,6 +866,25 @@ void readHexString(InputStreamDevice& device, charbuff& buffer)
         buffer.push_back('0');
 }
 
+// Consume the whitespaces and peek the following character
+bool tryPeekNonWhitespace(InputStreamDevice& device, char& ch)
+{
+    while (device.Peek(ch))
+    {
+        if (getCharClass(ch) != CharClassWhitespace)
+            return true;
+
+        (void)device.ReadChar();
+    }
+
+    return false;
+}
+
+uint8_t getCharClass(char ch)
+{
+    return s_charTable.Classes[(unsigned char)ch];
+}
+
 bool isOctalChar(char ch)
 {
     switch (ch)
@@ -11,7 +11,7 @@
 #include <podofo/auxiliary/InputDevice.h>
 #include "PdfStatefulEncrypt.h"
 
-#include <deque>
+#include <array>
 
 namespace PoDoFo {
 
@@ -36,6 +36,7 @@ class PODOFO_API PdfTokenizer
 {
     friend class PdfPostScriptTokenizer;
     PODOFO_PRIVATE_FRIEND(class PdfParserObject);
+    PODOFO_PRIVATE_FRIEND(class PdfObjectStreamParser);
 
 public:
     static constexpr unsigned BufferSize = 4096;
@@ -165,6 +166,12 @@ protected:
      */
     void ReadString(InputStreamDevice& device, PdfVariant& variant, const PdfStatefulEncrypt* encrypt);
 
+    /** Read a string from the input device, without creating a PdfString
+     *
+     *  \param str the decoded string, valid until the next read
+     */
+    void ReadString(InputStreamDevice& device, std::string_view& str);
+
     /** Read a hex string from the input device
      *  and store it into a variant.
      *
@@ -173,6 +180,12 @@ protected:
      */
     void ReadHexString(InputStreamDevice& device, PdfVariant& variant, const PdfStatefulEncrypt* encrypt);
 
+    /** Read a hex string from the input device, without creating a PdfString
+     *
+     *  \param hex the hex digits of the string, valid until the next read
+     */
+    void ReadHexString(InputStreamDevice& device, std::string_view& hex);
+
     /** Read a name from the input device
      *  and store it into a variant.
      *
@@ -182,6 +195,13 @@ protected:
      */
     void ReadName(InputStreamDevice& device, PdfVariant& variant);
 
+    /** Read a name from the input device, without creating a PdfName
+     *
+     *  \param name the name as escaped in the input, valid until the next
+     *      read. It's empty for empty names
+     */
+    void ReadName(InputStreamDevice& device, std::string_view& name);
+
     /** Determine the possible datatype of a token.
      *  Numbers, reals, bools or nullptr values are parsed directly by this function
      *  and saved to a variant.
@@ -193,15 +213,28 @@ protected:
 private:
     PdfTokenizer(std::in_place_t, std::shared_ptr<charbuff>&& buffer, const PdfTokenizerOptions& options);
     bool tryReadDataType(InputStreamDevice& device, PdfLiteralDataType dataType, PdfVariant& variant, const PdfStatefulEncrypt* encrypt);
+    void clearTokenQueue();
 
 private:
-    using TokenizerPair = std::pair<std::string, PdfTokenType>;
-    using TokenizerQueque = std::deque<TokenizerPair>;
+    // A token waiting in the queue, stored in m_queueBuffer
+    struct QueuedToken
+    {
+        unsigned Offset;
+        unsigned Length;
+        PdfTokenType Type;
+    };
+
+    // Tokens are enqueued only to look ahead a few tokens,
+    // so a small fixed size ring is enough
+    static constexpr unsigned TokenQueueSize = 4;
 
 private:
     std::shared_ptr<charbuff> m_buffer;
     PdfTokenizerOptions m_options;
-    TokenizerQueque m_tokenQueque;
+    std::array<QueuedToken, TokenQueueSize> m_tokenQueue;
+    unsigned m_tokenQueueStart;
+    unsigned m_tokenQueueCount;
+    charbuff m_tokenQueueBuffer;
     charbuff m_charBuffer;
 };
 
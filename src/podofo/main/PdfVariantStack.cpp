@@ -10,6 +10,18 @@
 using namespace std;
 using namespace PoDoFo;
 
+PdfVariantStack::PdfVariantStack() { }
+
+PdfVariantStack::PdfVariantStack(const PdfOperandStack& stack)
+{
+    // Operands are accessed from the top, variants
+    // are stored from the bottom of the stack
+    unsigned size = stack.GetSize();
+    m_variants.reserve(size);
+    for (unsigned i = size; i > 0; i--)
+        m_variants.push_back(stack.GetVariant(i - 1));
+}
+
 void PdfVariantStack::Push(const PdfVariant& var)
 {
     m_variants.push_back(var);
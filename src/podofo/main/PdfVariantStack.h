@@ -7,14 +7,17 @@
 #ifndef PDF_OPERATOR_STACK_H
 #define PDF_OPERATOR_STACK_H
 
-#include "PdfVariant.h"
+#include "PdfOperandStack.h"
 
 namespace PoDoFo {
 
+/** A stack of variants, accessed from the top
+ * \deprecated PdfContent::Stack is now a PdfOperandStack. This class
+ * is kept for a release for source compatibility, and it can be
+ * constructed from a PdfOperandStack. It will be removed
+ */
 class PODOFO_API PdfVariantStack final
 {
-    friend class PdfContentStreamReader;
-
 public:
     using Stack = std::vector<PdfVariant>;
     using iterator = Stack::reverse_iterator;
@@ -22,6 +25,13 @@ public:
     using const_iterator = Stack::const_reverse_iterator;
     using const_reverse_iterator = Stack::const_iterator;
 
+public:
+    PdfVariantStack();
+
+    /** Copy all the operands of the stack as full variants
+     */
+    PdfVariantStack(const PdfOperandStack& stack);
+
 public:
     void Push(const PdfVariant& var);
     void Push(PdfVariant&& var);
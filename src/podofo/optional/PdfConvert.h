@@ -536,6 +536,21 @@ namespace PoDoFo
         }
     };
 
+    namespace detail
+    {
+        /** Pack an operator of at most 3 characters into a collision free
+         * key, usable as a switch label
+         */
+        constexpr uint32_t GetOperatorKey(const std::string_view& str)
+        {
+            uint32_t key = (uint32_t)str.size() << 24;
+            for (size_t i = 0; i < str.size(); i++)
+                key |= (uint32_t)(unsigned char)str[i] << (i * 8);
+
+            return key;
+        }
+    }
+
     template<>
     struct Convert<PdfOperator>
     {
@@ -698,376 +713,239 @@ namespace PoDoFo
 
         static bool TryParse(const std::string_view& str, PdfOperator& value)
         {
-            if (str == "w")
-            {
-                value = PdfOperator::w;
-                return true;
-            }
-            else if (str == "J")
-            {
-                value = PdfOperator::J;
-                return true;
-            }
-            else if (str == "j")
-            {
-                value = PdfOperator::j;
-                return true;
-            }
-            else if (str == "M")
-            {
-                value = PdfOperator::M;
-                return true;
-            }
-            else if (str == "d")
-            {
-                value = PdfOperator::d;
-                return true;
-            }
-            else if (str == "ri")
-            {
-                value = PdfOperator::ri;
-                return true;
-            }
-            else if (str == "i")
-            {
-                value = PdfOperator::i;
-                return true;
-            }
-            else if (str == "gs")
-            {
-                value = PdfOperator::gs;
-                return true;
-            }
-            else if (str == "q")
-            {
-                value = PdfOperator::q;
-                return true;
-            }
-            else if (str == "Q")
-            {
-                value = PdfOperator::Q;
-                return true;
-            }
-            else if (str == "cm")
-            {
-                value = PdfOperator::cm;
-                return true;
-            }
-            else if (str == "m")
-            {
-                value = PdfOperator::m;
-                return true;
-            }
-            else if (str == "l")
-            {
-                value = PdfOperator::l;
-                return true;
-            }
-            else if (str == "c")
-            {
-                value = PdfOperator::c;
-                return true;
-            }
-            else if (str == "v")
-            {
-                value = PdfOperator::v;
-                return true;
-            }
-            else if (str == "y")
-            {
-                value = PdfOperator::y;
-                return true;
-            }
-            else if (str == "h")
-            {
-                value = PdfOperator::h;
-                return true;
-            }
-            else if (str == "re")
-            {
-                value = PdfOperator::re;
-                return true;
-            }
-            else if (str == "S")
-            {
-                value = PdfOperator::S;
-                return true;
-            }
-            else if (str == "s")
-            {
-                value = PdfOperator::s;
-                return true;
-            }
-            else if (str == "f")
-            {
-                value = PdfOperator::f;
-                return true;
-            }
-            else if (str == "F")
-            {
-                value = PdfOperator::F;
-                return true;
-            }
-            else if (str == "f*")
-            {
-                value = PdfOperator::f_Star;
-                return true;
-            }
-            else if (str == "B")
-            {
-                value = PdfOperator::B;
-                return true;
-            }
-            else if (str == "B*")
-            {
-                value = PdfOperator::B_Star;
-                return true;
-            }
-            else if (str == "b")
-            {
-                value = PdfOperator::b;
-                return true;
-            }
-            else if (str == "b*")
-            {
-                value = PdfOperator::b_Star;
-                return true;
-            }
-            else if (str == "n")
-            {
-                value = PdfOperator::n;
-                return true;
-            }
-            else if (str == "W")
-            {
-                value = PdfOperator::W;
-                return true;
-            }
-            else if (str == "W*")
-            {
-                value = PdfOperator::W_Star;
-                return true;
-            }
-            else if (str == "BT")
-            {
-                value = PdfOperator::BT;
-                return true;
-            }
-            else if (str == "ET")
-            {
-                value = PdfOperator::ET;
-                return true;
-            }
-            else if (str == "Tc")
-            {
-                value = PdfOperator::Tc;
-                return true;
-            }
-            else if (str == "Tw")
-            {
-                value = PdfOperator::Tw;
-                return true;
-            }
-            else if (str == "Tz")
-            {
-                value = PdfOperator::Tz;
-                return true;
-            }
-            else if (str == "TL")
-            {
-                value = PdfOperator::TL;
-                return true;
-            }
-            else if (str == "Tf")
-            {
-                value = PdfOperator::Tf;
-                return true;
-            }
-            else if (str == "Tr")
-            {
-                value = PdfOperator::Tr;
-                return true;
-            }
-            else if (str == "Ts")
-            {
-                value = PdfOperator::Ts;
-                return true;
-            }
-            else if (str == "Td")
-            {
-                value = PdfOperator::Td;
-                return true;
-            }
-            else if (str == "TD")
-            {
-                value = PdfOperator::TD;
-                return true;
-            }
-            else if (str == "Tm")
-            {
-                value = PdfOperator::Tm;
-                return true;
-            }
-            else if (str == "T*")
-            {
-                value = PdfOperator::T_Star;
-                return true;
-            }
-            else if (str == "Tj")
-            {
-                value = PdfOperator::Tj;
-                return true;
-            }
-            else if (str == "TJ")
-            {
-                value = PdfOperator::TJ;
-                return true;
-            }
-            else if (str == "'")
-            {
-                value = PdfOperator::Quote;
-                return true;
-            }
-            else if (str == "\"")
-            {
-                value = PdfOperator::DoubleQuote;
-                return true;
-            }
-            else if (str == "d0")
-            {
-                value = PdfOperator::d0;
-                return true;
-            }
-            else if (str == "d1")
-            {
-                value = PdfOperator::d1;
-                return true;
-            }
-            else if (str == "CS")
-            {
-                value = PdfOperator::CS;
-                return true;
-            }
-            else if (str == "cs")
-            {
-                value = PdfOperator::cs;
-                return true;
-            }
-            else if (str == "SC")
-            {
-                value = PdfOperator::SC;
-                return true;
-            }
-            else if (str == "SCN")
-            {
-                value = PdfOperator::SCN;
-                return true;
-            }
-            else if (str == "sc")
-            {
-                value = PdfOperator::sc;
-                return true;
-            }
-            else if (str == "scn")
-            {
-                value = PdfOperator::scn;
-                return true;
-            }
-            else if (str == "G")
-            {
-                value = PdfOperator::G;
-                return true;
-            }
-            else if (str == "g")
-            {
-                value = PdfOperator::g;
-                return true;
-            }
-            else if (str == "RG")
-            {
-                value = PdfOperator::RG;
-                return true;
-            }
-            else if (str == "rg")
-            {
-                value = PdfOperator::rg;
-                return true;
-            }
-            else if (str == "K")
-            {
-                value = PdfOperator::K;
-                return true;
-            }
-            else if (str == "k")
-            {
-                value = PdfOperator::k;
-                return true;
-            }
-            else if (str == "sh")
-            {
-                value = PdfOperator::sh;
-                return true;
-            }
-            else if (str == "BI")
-            {
-                value = PdfOperator::BI;
-                return true;
-            }
-            else if (str == "ID")
-            {
-                value = PdfOperator::ID;
-                return true;
-            }
-            else if (str == "EI")
-            {
-                value = PdfOperator::EI;
-                return true;
-            }
-            else if (str == "Do")
-            {
-                value = PdfOperator::Do;
-                return true;
-            }
-            else if (str == "MP")
-            {
-                value = PdfOperator::MP;
-                return true;
-            }
-            else if (str == "DP")
-            {
-                value = PdfOperator::DP;
-                return true;
-            }
-            else if (str == "BMC")
-            {
-                value = PdfOperator::BMC;
-                return true;
-            }
-            else if (str == "BDC")
-            {
-                value = PdfOperator::BDC;
-                return true;
-            }
-            else if (str == "EMC")
-            {
-                value = PdfOperator::EMC;
-                return true;
-            }
-            else if (str == "BX")
-            {
-                value = PdfOperator::BX;
-                return true;
-            }
-            else if (str == "EX")
-            {
-                value = PdfOperator::EX;
-                return true;
-            }
-            else
+            // Operators are 1 to 3 characters long: the packed
+            // characters and length are a collision free key
+            if (str.size() == 0 || str.size() > 3)
             {
                 value = PdfOperator::Unknown;
                 return false;
             }
+
+            switch (detail::GetOperatorKey(str))
+            {
+                case detail::GetOperatorKey("w"):
+                    value = PdfOperator::w;
+                    return true;
+                case detail::GetOperatorKey("J"):
+                    value = PdfOperator::J;
+                    return true;
+                case detail::GetOperatorKey("j"):
+                    value = PdfOperator::j;
+                    return true;
+                case detail::GetOperatorKey("M"):
+                    value = PdfOperator::M;
+                    return true;
+                case detail::GetOperatorKey("d"):
+                    value = PdfOperator::d;
+                    return true;
+                case detail::GetOperatorKey("ri"):
+                    value = PdfOperator::ri;
+                    return true;
+                case detail::GetOperatorKey("i"):
+                    value = PdfOperator::i;
+                    return true;
+                case detail::GetOperatorKey("gs"):
+                    value = PdfOperator::gs;
+                    return true;
+                case detail::GetOperatorKey("q"):
+                    value = PdfOperator::q;
+                    return true;
+                case detail::GetOperatorKey("Q"):
+                    value = PdfOperator::Q;
+                    return true;
+                case detail::GetOperatorKey("cm"):
+                    value = PdfOperator::cm;
+                    return true;
+                case detail::GetOperatorKey("m"):
+                    value = PdfOperator::m;
+                    return true;
+                case detail::GetOperatorKey("l"):
+                    value = PdfOperator::l;
+                    return true;
+                case detail::GetOperatorKey("c"):
+                    value = PdfOperator::c;
+                    return true;
+                case detail::GetOperatorKey("v"):
+                    value = PdfOperator::v;
+                    return true;
+                case detail::GetOperatorKey("y"):
+                    value = PdfOperator::y;
+                    return true;
+                case detail::GetOperatorKey("h"):
+                    value = PdfOperator::h;
+                    return true;
+                case detail::GetOperatorKey("re"):
+                    value = PdfOperator::re;
+                    return true;
+                case detail::GetOperatorKey("S"):
+                    value = PdfOperator::S;
+                    return true;
+                case detail::GetOperatorKey("s"):
+                    value = PdfOperator::s;
+                    return true;
+                case detail::GetOperatorKey("f"):
+                    value = PdfOperator::f;
+                    return true;
+                case detail::GetOperatorKey("F"):
+                    value = PdfOperator::F;
+                    return true;
+                case detail::GetOperatorKey("f*"):
+                    value = PdfOperator::f_Star;
+                    return true;
+                case detail::GetOperatorKey("B"):
+                    value = PdfOperator::B;
+                    return true;
+                case detail::GetOperatorKey("B*"):
+                    value = PdfOperator::B_Star;
+                    return true;
+                case detail::GetOperatorKey("b"):
+                    value = PdfOperator::b;
+                    return true;
+                case detail::GetOperatorKey("b*"):
+                    value = PdfOperator::b_Star;
+                    return true;
+                case detail::GetOperatorKey("n"):
+                    value = PdfOperator::n;
+                    return true;
+                case detail::GetOperatorKey("W"):
+                    value = PdfOperator::W;
+                    return true;
+                case detail::GetOperatorKey("W*"):
+                    value = PdfOperator::W_Star;
+                    return true;
+                case detail::GetOperatorKey("BT"):
+                    value = PdfOperator::BT;
+                    return true;
+                case detail::GetOperatorKey("ET"):
+                    value = PdfOperator::ET;
+                    return true;
+                case detail::GetOperatorKey("Tc"):
+                    value = PdfOperator::Tc;
+                    return true;
+                case detail::GetOperatorKey("Tw"):
+                    value = PdfOperator::Tw;
+                    return true;
+                case detail::GetOperatorKey("Tz"):
+                    value = PdfOperator::Tz;
+                    return true;
+                case detail::GetOperatorKey("TL"):
+                    value = PdfOperator::TL;
+                    return true;
+                case detail::GetOperatorKey("Tf"):
+                    value = PdfOperator::Tf;
+                    return true;
+                case detail::GetOperatorKey("Tr"):
+                    value = PdfOperator::Tr;
+                    return true;
+                case detail::GetOperatorKey("Ts"):
+                    value = PdfOperator::Ts;
+                    return true;
+                case detail::GetOperatorKey("Td"):
+                    value = PdfOperator::Td;
+                    return true;
+                case detail::GetOperatorKey("TD"):
+                    value = PdfOperator::TD;
+                    return true;
+                case detail::GetOperatorKey("Tm"):
+                    value = PdfOperator::Tm;
+                    return true;
+                case detail::GetOperatorKey("T*"):
+                    value = PdfOperator::T_Star;
+                    return true;
+                case detail::GetOperatorKey("Tj"):
+                    value = PdfOperator::Tj;
+                    return true;
+                case detail::GetOperatorKey("TJ"):
+                    value = PdfOperator::TJ;
+                    return true;
+                case detail::GetOperatorKey("'"):
+                    value = PdfOperator::Quote;
+                    return true;
+                case detail::GetOperatorKey("\""):
+                    value = PdfOperator::DoubleQuote;
+                    return true;
+                case detail::GetOperatorKey("d0"):
+                    value = PdfOperator::d0;
+                    return true;
+                case detail::GetOperatorKey("d1"):
+                    value = PdfOperator::d1;
+                    return true;
+                case detail::GetOperatorKey("CS"):
+                    value = PdfOperator::CS;
+                    return true;
+                case detail::GetOperatorKey("cs"):
+                    value = PdfOperator::cs;
+                    return true;
+                case detail::GetOperatorKey("SC"):
+                    value = PdfOperator::SC;
+                    return true;
+                case detail::GetOperatorKey("SCN"):
+                    value = PdfOperator::SCN;
+                    return true;
+                case detail::GetOperatorKey("sc"):
+                    value = PdfOperator::sc;
+                    return true;
+                case detail::GetOperatorKey("scn"):
+                    value = PdfOperator::scn;
+                    return true;
+                case detail::GetOperatorKey("G"):
+                    value = PdfOperator::G;
+                    return true;
+                case detail::GetOperatorKey("g"):
+                    value = PdfOperator::g;
+                    return true;
+                case detail::GetOperatorKey("RG"):
+                    value = PdfOperator::RG;
+                    return true;
+                case detail::GetOperatorKey("rg"):
+                    value = PdfOperator::rg;
+                    return true;
+                case detail::GetOperatorKey("K"):
+                    value = PdfOperator::K;
+                    return true;
+                case detail::GetOperatorKey("k"):
+                    value = PdfOperator::k;
+                    return true;
+                case detail::GetOperatorKey("sh"):
+                    value = PdfOperator::sh;
+                    return true;
+                case detail::GetOperatorKey("BI"):
+                    value = PdfOperator::BI;
+                    return true;
+                case detail::GetOperatorKey("ID"):
+                    value = PdfOperator::ID;
+                    return true;
+                case detail::GetOperatorKey("EI"):
+                    value = PdfOperator::EI;
+                    return true;
+                case detail::GetOperatorKey("Do"):
+                    value = PdfOperator::Do;
+                    return true;
+                case detail::GetOperatorKey("MP"):
+                    value = PdfOperator::MP;
+                    return true;
+                case detail::GetOperatorKey("DP"):
+                    value = PdfOperator::DP;
+                    return true;
+                case detail::GetOperatorKey("BMC"):
+                    value = PdfOperator::BMC;
+                    return true;
+                case detail::GetOperatorKey("BDC"):
+                    value = PdfOperator::BDC;
+                    return true;
+                case detail::GetOperatorKey("EMC"):
+                    value = PdfOperator::EMC;
+                    return true;
+                case detail::GetOperatorKey("BX"):
+                    value = PdfOperator::BX;
+                    return true;
+                case detail::GetOperatorKey("EX"):
+                    value = PdfOperator::EX;
+                    return true;
+                default:
+                    value = PdfOperator::Unknown;
+                    return false;
+            }
         }
     };
 
@@ -0,0 +1,136 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <podofo/private/PdfDeclarationsPrivate.h>
+#include "PdfArena.h"
+
+#include <cstddef>
+
+using namespace std;
+using namespace PoDoFo;
+
+// Every block is preceded by a header with the owning chunk, or
+// nullptr if allocated from the heap. The header size preserves
+// the fundamental alignment of the returned blocks
+static constexpr size_t BlockHeaderSize = alignof(max_align_t);
+static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+static size_t alignSize(size_t size);
+
+static thread_local PdfArena* s_currentArena;
+
+PdfArena::PdfArena() :
+    m_chunk(nullptr),
+    m_chunkUsed(0),
+    m_chunkSize(0),
+    m_busy(false)
+{
+}
+
+PdfArena::~PdfArena()
+{
+    Reset();
+}
+
+void* PdfArena::Allocate(size_t size)
+{
+    char* block;
+    Chunk* chunk = nullptr;
+    auto arena = s_currentArena;
+    if (arena == nullptr)
+        block = (char*)::operator new(BlockHeaderSize + size);
+    else
+        block = (char*)arena->allocate(BlockHeaderSize + size, chunk);
+
+    *reinterpret_cast<Chunk**>(block) = chunk;
+    return block + BlockHeaderSize;
+}
+
+void PdfArena::Deallocate(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    char* block = (char*)ptr - BlockHeaderSize;
+    auto chunk = *reinterpret_cast<Chunk**>(block);
+    if (chunk == nullptr)
+        ::operator delete(block);
+    else
+        releaseChunk(chunk);
+}
+
+void PdfArena::Reset()
+{
+    if (m_chunk == nullptr)
+        return;
+
+    // Release the reference held by the arena on the current chunk
+    releaseChunk(m_chunk);
+    m_chunk = nullptr;
+    m_chunkUsed = 0;
+    m_chunkSize = 0;
+}
+
+void* PdfArena::allocate(size_t size, Chunk*& chunk)
+{
+    size = alignSize(size);
+    if (m_chunk == nullptr || m_chunkUsed + size > m_chunkSize)
+    {
+        Reset();
+        size_t chunkHeaderSize = alignSize(sizeof(Chunk));
+        size_t chunkSize = std::max(DefaultChunkSize, chunkHeaderSize + size);
+        m_chunk = new(::operator new(chunkSize)) Chunk();
+        // The arena holds a reference on its current chunk
+        m_chunk->RefCount = 1;
+        m_chunkUsed = chunkHeaderSize;
+        m_chunkSize = chunkSize;
+    }
+
+    char* ret = reinterpret_cast<char*>(m_chunk) + m_chunkUsed;
+    m_chunkUsed += size;
+    m_chunk->RefCount.fetch_add(1, memory_order_relaxed);
+    chunk = m_chunk;
+    return ret;
+}
+
+void PdfArena::releaseChunk(Chunk* chunk) noexcept
+{
+    if (chunk->RefCount.fetch_sub(1, memory_order_acq_rel) != 1)
+        return;
+
+    chunk->~Chunk();
+    ::operator delete(chunk);
+}
+
+PdfArenaScope::PdfArenaScope(PdfArena* arena) :
+    m_arena(nullptr),
+    m_prevArena(s_currentArena)
+{
+    // Nothing to do if the arena is already current
+    if (arena == nullptr || s_currentArena == arena)
+        return;
+
+    // Don't use the arena if it's in use by another thread
+    if (arena->m_busy.exchange(true, memory_order_acquire))
+        return;
+
+    m_arena = arena;
+    s_currentArena = arena;
+}
+
+PdfArenaScope::~PdfArenaScope()
+{
+    if (m_arena == nullptr)
+        return;
+
+    m_arena->m_busy.store(false, memory_order_release);
+    s_currentArena = m_prevArena;
+}
+
+size_t alignSize(size_t size)
+{
+    return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
@@ -0,0 +1,95 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#ifndef PDF_ARENA_H
+#define PDF_ARENA_H
+
+#include <atomic>
+
+namespace PoDoFo {
+
+/**
+ * A pooled allocator where the objects of a document, and their
+ * dictionary and array bodies, are allocated while loading
+ *
+ * Allocations are carved sequentially from large chunks. This is
+ * not a bulk free: objects are still destroyed one by one. Each chunk
+ * counts its live allocations and it's returned to the heap when the
+ * last of them is deallocated, so objects that outlive the document, e.g.
+ * moved out of it, stay valid. The arena is used by an allocation only
+ * when it's current for the calling thread, see PdfArenaScope
+ */
+class PdfArena final
+{
+    friend class PdfArenaScope;
+
+public:
+    PdfArena();
+    ~PdfArena();
+
+public:
+    /** Allocate a memory block from the arena current
+     * for the calling thread, if any, or from the heap
+     */
+    static void* Allocate(size_t size);
+
+    /** Deallocate a memory block returned by Allocate()
+     */
+    static void Deallocate(void* ptr) noexcept;
+
+    /** Stop allocating from the current chunk. Following
+     * allocations will start a new chunk
+     */
+    void Reset();
+
+private:
+    struct Chunk
+    {
+        std::atomic<size_t> RefCount;
+    };
+
+    void* allocate(size_t size, Chunk*& chunk);
+
+    static void releaseChunk(Chunk* chunk) noexcept;
+
+private:
+    PdfArena(const PdfArena&) = delete;
+    PdfArena& operator=(const PdfArena&) = delete;
+
+private:
+    Chunk* m_chunk;
+    size_t m_chunkUsed;
+    size_t m_chunkSize;
+    std::atomic<bool> m_busy;
+};
+
+/**
+ * Make an arena current for the calling thread in this scope
+ *
+ * If the arena is already in use by another thread the scope has
+ * no effect, and the allocations in the scope use the heap
+ */
+class PdfArenaScope final
+{
+public:
+    /**
+     * \param arena the arena to make current, or nullptr to do nothing
+     */
+    PdfArenaScope(PdfArena* arena);
+    ~PdfArenaScope();
+
+private:
+    PdfArenaScope(const PdfArenaScope&) = delete;
+    PdfArenaScope& operator=(const PdfArenaScope&) = delete;
+
+private:
+    PdfArena* m_arena;
+    PdfArena* m_prevArena;
+};
+
+};
+
+#endif // PDF_ARENA_H
@@ -0,0 +1,44 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <podofo/private/PdfDeclarationsPrivate.h>
+#include "PdfCompressedParserObject.h"
+#include "PdfArena.h"
+
+#include <podofo/main/PdfDocument.h>
+
+using namespace std;
+using namespace PoDoFo;
+
+PdfCompressedParserObject::PdfCompressedParserObject(PdfDocument& doc, const PdfReference& indirectReference,
+        shared_ptr<PdfObjectStreamParser> streamParser, unsigned index) :
+    PdfObject(PdfVariant(), indirectReference, false),
+    m_StreamParser(std::move(streamParser)),
+    m_Index(index)
+{
+    SetDocument(&doc);
+    EnableDelayedLoading();
+}
+
+void PdfCompressedParserObject::delayedLoad()
+{
+    PODOFO_ASSERT(m_StreamParser != nullptr);
+
+    // Allocate the loaded data in the arena of the document
+    PdfArenaScope arenaScope(&GetDocument()->GetObjects().GetArena());
+    auto& reference = GetIndirectReference();
+    if (!m_StreamParser->TryReadObject(reference.ObjectNumber(), m_Index, m_Variant))
+    {
+        // A reference to a non existing object is equivalent to the null object
+        PoDoFo::LogMessage(PdfLogSeverity::Warning, "Object {} {} R could not be found in its object stream",
+            reference.ObjectNumber(), reference.GenerationNumber());
+        m_Variant = PdfVariant();
+    }
+
+    // Release the object stream parser, which will free
+    // the decoded stream after all its objects have been read
+    m_StreamParser = nullptr;
+}
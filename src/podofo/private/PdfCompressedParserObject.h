@@ -0,0 +1,42 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#ifndef PDF_COMPRESSED_PARSER_OBJECT_H
+#define PDF_COMPRESSED_PARSER_OBJECT_H
+
+#include "PdfObjectStreamParser.h"
+
+namespace PoDoFo {
+
+/**
+ * An object compressed in an object stream (PDF Reference 1.7 3.4.6 Object Streams)
+ * that is read only when it's accessed first. The owning object stream
+ * is decoded once, and shared by all the objects it contains
+ */
+class PdfCompressedParserObject final : public PdfObject
+{
+    friend class PdfParser;
+
+private:
+    /**
+     * \param doc document where to resolve object references
+     * \param streamParser the parser of the object stream containing the object
+     * \param index the index of the object in the stream, as reported by the xref
+     */
+    PdfCompressedParserObject(PdfDocument& doc, const PdfReference& indirectReference,
+        std::shared_ptr<PdfObjectStreamParser> streamParser, unsigned index);
+
+protected:
+    void delayedLoad() override;
+
+private:
+    std::shared_ptr<PdfObjectStreamParser> m_StreamParser;
+    unsigned m_Index;
+};
+
+};
+
+#endif // PDF_COMPRESSED_PARSER_OBJECT_H
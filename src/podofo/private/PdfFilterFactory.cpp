@@ -18,9 +18,13 @@ using namespace PoDoFo;
 class PdfFilteredEncodeStream : public OutputStream
 {
 private:
-    void init(OutputStream& outputStream, PdfFilterType filterType)
+    void init(OutputStream& outputStream, PdfFilterType filterType, const PdfFlateParams& flateParams)
     {
-        m_filter = PdfFilterFactory::Create(filterType);
+        if (filterType == PdfFilterType::FlateDecode)
+            m_filter.reset(new PdfFlateFilter(flateParams));
+        else
+            m_filter = PdfFilterFactory::Create(filterType);
+
         m_filter->BeginEncode(outputStream);
     }
     ~PdfFilteredEncodeStream()
@@ -28,10 +32,11 @@ private:
         m_filter->EndEncode();
     }
 public:
-    PdfFilteredEncodeStream(shared_ptr<OutputStream>&& outputStream, PdfFilterType filterType)
+    PdfFilteredEncodeStream(shared_ptr<OutputStream>&& outputStream, PdfFilterType filterType,
+        const PdfFlateParams& flateParams)
         : m_OutputStream(std::move(outputStream))
     {
-        init(*m_OutputStream, filterType);
+        init(*m_OutputStream, filterType, flateParams);
     }
 protected:
     void writeBuffer(const char* buffer, size_t len) override
@@ -218,17 +223,17 @@ bool PdfFilterFactory::TryCreate(PdfFilterType filterType, unique_ptr<PdfFilter>
 }
 
 unique_ptr<OutputStream> PdfFilterFactory::CreateEncodeStream(shared_ptr<OutputStream> stream,
-    const PdfFilterList& filters)
+    const PdfFilterList& filters, const PdfFlateParams& flateParams)
 {
     PODOFO_RAISE_LOGIC_IF(!filters.size(), "Cannot create an EncodeStream from an empty list of filters");
 
     PdfFilterList::const_iterator it = filters.begin();
-    unique_ptr<OutputStream> filter(new PdfFilteredEncodeStream(std::move(stream), *it));
+    unique_ptr<OutputStream> filter(new PdfFilteredEncodeStream(std::move(stream), *it, flateParams));
     it++;
 
     while (it != filters.end())
     {
-        filter.reset(new PdfFilteredEncodeStream(std::move(filter), *it));
+        filter.reset(new PdfFilteredEncodeStream(std::move(filter), *it, flateParams));
         it++;
     }
 
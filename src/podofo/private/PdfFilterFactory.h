@@ -41,12 +41,13 @@ public:
      *  \param filters a list of filters
      *  \param stream write all data to this OutputStream after it has been
      *         encoded
+     *  \param flateParams parameters used by the Flate filter, if present
      *  \returns a new OutputStream that has to be deleted by the caller.
      *
      *  \see PdfFilterFactory::CreateFilterList
      */
     static std::unique_ptr<OutputStream> CreateEncodeStream(std::shared_ptr<OutputStream> stream,
-        const PdfFilterList& filters);
+        const PdfFilterList& filters, const PdfFlateParams& flateParams = { });
 
     /** Create an InputStream that applies a list of filters
      *  on all data written to it.
@@ -10,6 +10,16 @@
 #include <podofo/main/PdfTokenizer.h>
 #include <podofo/auxiliary/StreamDevice.h>
 
+#ifdef PODOFO_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif // PODOFO_HAVE_LIBDEFLATE
+
+// SSE2 is part of the x86-64 baseline, so it's always available there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PODOFO_PREDICTOR_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 using namespace PoDoFo;
 
@@ -20,6 +30,20 @@ namespace PoDoFo {
 // evaluation.
 const unsigned s_Powers85[] = { 85 * 85 * 85 * 85, 85 * 85 * 85, 85 * 85, 85, 1 };
 
+// Reconstruct a row filtered with a PNG predictor. "row" holds the
+// filtered bytes and it's reconstructed in place, "prev" is the
+// previous reconstructed row, "bpp" the number of bytes per
+// complete pixel, rounded up to one
+using PngRowDecodeFunc = void(*)(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp);
+
+struct PngRowDecoders final
+{
+    PngRowDecodeFunc Sub;
+    PngRowDecodeFunc Up;
+    PngRowDecodeFunc Average;
+    PngRowDecodeFunc Paeth;
+};
+
 /**
  * This structure contains all necessary values
  * for a FlateDecode and LZWDecode Predictor.
@@ -61,7 +85,16 @@ public:
         num = decodeParms.FindKeyAsSafe<int64_t>("EarlyChange", 1);
         m_EarlyChange = num < 1 ? 1 : (unsigned)num;
 
-        m_BytesPerPixel = (m_BitsPerComponent * m_Colors) / 8;
+        // check for multiplication overflow on buffer sizes (e.g. if m_nBPC=2 and m_nColors=SIZE_MAX/2+1)
+        if (utls::DoesMultiplicationOverflow(m_BitsPerComponent, m_Colors)
+            || utls::DoesMultiplicationOverflow(m_ColumnCount, (size_t)m_BitsPerComponent * m_Colors))
+        {
+            PODOFO_RAISE_ERROR(PdfErrorCode::ValueOutOfRange);
+        }
+
+        // PNG predictors operate on bytes, with the left pixel
+        // being at least one byte away, see the PNG specification
+        m_BytesPerPixel = std::max(1u, (m_BitsPerComponent * m_Colors + 7) / 8);
         if (m_Predictor >= 10)
         {
             m_NextByteIsPredictor = true;
@@ -74,24 +107,19 @@ public:
         }
 
         m_CurrRowIndex = 0;
-        m_Rows = (m_ColumnCount * m_Colors * m_BitsPerComponent) / 8;
-
-        // check for multiplication overflow on buffer sizes (e.g. if m_nBPC=2 and m_nColors=SIZE_MAX/2+1)
-        if (utls::DoesMultiplicationOverflow(m_BitsPerComponent, m_Colors)
-            || utls::DoesMultiplicationOverflow(m_ColumnCount, (size_t)m_BitsPerComponent * m_Colors))
-        {
+        size_t rowLength = ((size_t)m_ColumnCount * m_Colors * m_BitsPerComponent + 7) / 8;
+        if (rowLength > numeric_limits<unsigned>::max())
             PODOFO_RAISE_ERROR(PdfErrorCode::ValueOutOfRange);
-        }
+
+        m_RowLength = (unsigned)rowLength;
 
         // check that computed allocation sizes are > 0 (CVE-2018-20797)
-        if (m_Rows < 1 || m_BitsPerComponent < 1)
+        if (m_RowLength < 1 || m_BitsPerComponent < 1)
             PODOFO_RAISE_ERROR(PdfErrorCode::ValueOutOfRange);
 
-        m_Prev.resize(m_Rows);
-        memset(m_Prev.data(), 0, sizeof(char) * m_Rows);
-
-        m_UpperLeftPixelComponents.resize(m_BytesPerPixel);
-        memset(m_UpperLeftPixelComponents.data(), 0, sizeof(char) * m_BytesPerPixel);
+        m_Prev.resize(m_RowLength);
+        m_Curr.resize(m_RowLength);
+        m_RowDecoders = getRowDecoders(m_BytesPerPixel);
     }
 
     void Decode(const char* buffer, size_t len, OutputStream& stream)
@@ -102,114 +130,334 @@ public:
             return;
         }
 
-        while (len-- != 0)
+        while (len != 0)
         {
             if (m_NextByteIsPredictor)
             {
-                m_CurrPredictor = *buffer + 10;
+                m_CurrPredictor = (unsigned char)*buffer + 10;
                 m_NextByteIsPredictor = false;
+                buffer++;
+                len--;
+                continue;
             }
-            else
+
+            // Collect a whole row before reconstructing it
+            size_t count = std::min(len, (size_t)(m_RowLength - m_CurrRowIndex));
+            std::memcpy(m_Curr.data() + m_CurrRowIndex, buffer, count);
+            m_CurrRowIndex += (unsigned)count;
+            buffer += count;
+            len -= count;
+            if (m_CurrRowIndex < m_RowLength)
+                break;
+
+            // One line finished
+            decodeRow();
+            m_CurrRowIndex = 0;
+            m_NextByteIsPredictor = (m_CurrPredictor >= 10);
+            stream.Write(m_Prev.data(), m_RowLength);
+        }
+    }
+
+private:
+    void decodeRow()
+    {
+        auto row = reinterpret_cast<unsigned char*>(m_Curr.data());
+        auto prev = reinterpret_cast<const unsigned char*>(m_Prev.data());
+        switch (m_CurrPredictor)
+        {
+            case 2: // Tiff Predictor
             {
-                if (m_BitsPerComponent != 8)
-                    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidPredictor, "Predictors with bits per component othern than 8 are not implemented");
+                if (m_BitsPerComponent == 8)
+                    decodeSubScalar(row, prev, m_RowLength, m_BytesPerPixel);
+                else if (m_BitsPerComponent == 16)
+                    decodeTiff16(row, m_RowLength, m_Colors);
+                else
+                    PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidPredictor, "Tiff predictors with bits per component other than 8 or 16 are not implemented");
+                break;
+            }
+            case 10: // png none
+                break;
+            case 11: // png sub
+                m_RowDecoders.Sub(row, prev, m_RowLength, m_BytesPerPixel);
+                break;
+            case 12: // png up
+                m_RowDecoders.Up(row, prev, m_RowLength, m_BytesPerPixel);
+                break;
+            case 13: // png average
+                m_RowDecoders.Average(row, prev, m_RowLength, m_BytesPerPixel);
+                break;
+            case 14: // png paeth
+                m_RowDecoders.Paeth(row, prev, m_RowLength, m_BytesPerPixel);
+                break;
+            case 15: // png optimum
+                PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidPredictor, "png optimum predictor is not implemented");
+                break;
+            default:
+            {
+                // Unknown predictors leave the previous row unchanged
+                return;
+            }
+        }
 
-                PODOFO_ASSERT(m_BytesPerPixel != 0);
-                switch (m_CurrPredictor)
-                {
-                    case 2: // Tiff Predictor
-                    {
-                        // Same as png sub
-                        char prev = ((int)m_CurrRowIndex - (int)m_BytesPerPixel < 0
-                            ? 0 : m_Prev[m_CurrRowIndex - m_BytesPerPixel]);
-                        m_Prev[m_CurrRowIndex] = *buffer + prev;
-                        break;
-                    }
-                    case 10: // png none
-                    {
-                        m_Prev[m_CurrRowIndex] = *buffer;
-                        break;
-                    }
-                    case 11: // png sub
-                    {
-                        char prev = ((int)m_CurrRowIndex - (int)m_BytesPerPixel < 0
-                            ? 0 : m_Prev[m_CurrRowIndex - m_BytesPerPixel]);
-                        m_Prev[m_CurrRowIndex] = *buffer + prev;
-                        break;
-                    }
-                    case 12: // png up
-                    {
-                        m_Prev[m_CurrRowIndex] += *buffer;
-                        break;
-                    }
-                    case 13: // png average
-                    {
-                        int prev = ((int)m_CurrRowIndex - (int)m_BytesPerPixel < 0
-                            ? 0 : m_Prev[m_CurrRowIndex - m_BytesPerPixel]);
-                        m_Prev[m_CurrRowIndex] = (char)((prev + m_Prev[m_CurrRowIndex]) >> 1) + *buffer;
-                        break;
-                    }
-                    case 14: // png paeth
-                    {
-                        int nLeftByteIndex = (int)m_CurrRowIndex - (int)m_BytesPerPixel;
+        std::swap(m_Prev, m_Curr);
+    }
 
-                        int a = nLeftByteIndex < 0 ? 0 : static_cast<unsigned char>(m_Prev[nLeftByteIndex]);
-                        int b = static_cast<unsigned char>(m_Prev[m_CurrRowIndex]);
+    static void decodeTiff16(unsigned char* row, size_t len, unsigned colors)
+    {
+        // Components are 16 bit big endian values
+        size_t stride = (size_t)colors * 2;
+        for (size_t i = stride; i + 1 < len; i += 2)
+        {
+            unsigned value = ((unsigned)row[i] << 8 | row[i + 1])
+                + ((unsigned)row[i - stride] << 8 | row[i - stride + 1]);
+            row[i] = (unsigned char)(value >> 8);
+            row[i + 1] = (unsigned char)value;
+        }
+    }
 
-                        int nCurrComponentIndex = m_CurrRowIndex % m_BytesPerPixel;
-                        int c = nLeftByteIndex < 0 ? 0 : static_cast<unsigned char>(m_UpperLeftPixelComponents[nCurrComponentIndex]);
+    static void decodeSubScalar(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        decodeSubRange(row, prev, len, bpp, 0);
+    }
 
-                        int p = a + b - c;
+    static void decodeUpScalar(unsigned char* row, const unsigned char* prev, size_t len, unsigned)
+    {
+        for (size_t i = 0; i < len; i++)
+            row[i] = (unsigned char)(row[i] + prev[i]);
+    }
 
-                        int pa = p - a;
-                        if (pa < 0)
-                            pa = -pa;
+    static void decodeAverageScalar(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        decodeAverageRange(row, prev, len, bpp, 0);
+    }
 
-                        int pb = p - b;
-                        if (pb < 0)
-                            pb = -pb;
+    static void decodePaethScalar(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        decodePaethRange(row, prev, len, bpp, 0);
+    }
 
-                        int pc = p - c;
-                        if (pc < 0)
-                            pc = -pc;
+    // The following reconstruct the bytes of the row starting
+    // from the given index, assuming the previous ones are done
 
-                        int closestByte;
-                        if (pa <= pb && pa <= pc)
-                            closestByte = a;
-                        else if (pb <= pc)
-                            closestByte = b;
-                        else
-                            closestByte = c;
+    static void decodeSubRange(unsigned char* row, const unsigned char*, size_t len, unsigned bpp, size_t start)
+    {
+        for (size_t i = std::max(start, (size_t)bpp); i < len; i++)
+            row[i] = (unsigned char)(row[i] + row[i - bpp]);
+    }
 
-                        // Save the byte we're about to clobber for the next pixel's prediction
-                        m_UpperLeftPixelComponents[nCurrComponentIndex] = m_Prev[m_CurrRowIndex];
+    static void decodeAverageRange(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp, size_t start)
+    {
+        size_t i = start;
+        for (; i < bpp && i < len; i++)
+            row[i] = (unsigned char)(row[i] + (prev[i] >> 1));
 
-                        m_Prev[m_CurrRowIndex] = *buffer + (char)closestByte;
-                        break;
-                    }
-                    case 15: // png optimum
-                        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidPredictor, "png optimum predictor is not implemented");
-                        break;
+        for (; i < len; i++)
+            row[i] = (unsigned char)(row[i] + ((row[i - bpp] + prev[i]) >> 1));
+    }
 
-                    default:
-                    {
-                        //PODOFO_RAISE_ERROR( EPdfError::InvalidPredictor );
-                        break;
-                    }
-                }
+    static void decodePaethRange(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp, size_t start)
+    {
+        size_t i = start;
+        // The left and upper left pixels are zero for the first pixel,
+        // so the predictor selects the upper one
+        for (; i < bpp && i < len; i++)
+            row[i] = (unsigned char)(row[i] + prev[i]);
 
-                m_CurrRowIndex++;
-            }
+        for (; i < len; i++)
+        {
+            int a = row[i - bpp];
+            int b = prev[i];
+            int c = prev[i - bpp];
+            int pa = std::abs(b - c);
+            int pb = std::abs(a - c);
+            int pc = std::abs(a + b - 2 * c);
+
+            int closestByte;
+            if (pa <= pb && pa <= pc)
+                closestByte = a;
+            else if (pb <= pc)
+                closestByte = b;
+            else
+                closestByte = c;
 
-            buffer++;
+            row[i] = (unsigned char)(row[i] + closestByte);
+        }
+    }
 
-            if (m_CurrRowIndex >= m_Rows)
-            {   // One line finished
-                m_CurrRowIndex = 0;
-                m_NextByteIsPredictor = (m_CurrPredictor >= 10);
-                stream.Write(m_Prev.data(), m_Rows);
-            }
+#ifdef PODOFO_PREDICTOR_SSE2
+    // Vectorized reconstruction, see the libpng filter_sse2_intrinsics.c.
+    // Pixels depend on the left one, so they are processed one at a time
+    // with all their components in a single register
+
+    template <unsigned Bpp>
+    static __m128i loadPixel(const unsigned char* p)
+    {
+        if constexpr (Bpp == 4)
+        {
+            int32_t value;
+            std::memcpy(&value, p, 4);
+            return _mm_cvtsi32_si128(value);
+        }
+        else if constexpr (Bpp == 8)
+        {
+            return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        }
+        else
+        {
+            unsigned char buffer[8] = { };
+            std::memcpy(buffer, p, Bpp);
+            return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buffer));
+        }
+    }
+
+    template <unsigned Bpp>
+    static void storePixel(unsigned char* p, __m128i value)
+    {
+        if constexpr (Bpp == 4)
+        {
+            int32_t v = _mm_cvtsi128_si32(value);
+            std::memcpy(p, &v, 4);
+        }
+        else if constexpr (Bpp == 8)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p), value);
+        }
+        else
+        {
+            unsigned char buffer[8];
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(buffer), value);
+            std::memcpy(p, buffer, Bpp);
+        }
+    }
+
+    template <unsigned Bpp>
+    static void decodeSubSSE2(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        PODOFO_ASSERT(bpp == Bpp);
+        size_t pixelCount = len / Bpp;
+        __m128i a = _mm_setzero_si128();
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            a = _mm_add_epi8(a, loadPixel<Bpp>(row));
+            storePixel<Bpp>(row, a);
+            row += Bpp;
+        }
+
+        // Handle the trailing partial pixel, if any
+        size_t offset = pixelCount * Bpp;
+        decodeSubRange(row - offset, prev, len, bpp, offset);
+    }
+
+    static void decodeUpSSE2(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+        }
+
+        decodeUpScalar(row + i, prev + i, len - i, bpp);
+    }
+
+    template <unsigned Bpp>
+    static void decodeAverageSSE2(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        PODOFO_ASSERT(bpp == Bpp);
+        size_t pixelCount = len / Bpp;
+        __m128i ones = _mm_set1_epi8(1);
+        __m128i a = _mm_setzero_si128();
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            __m128i b = loadPixel<Bpp>(prev);
+            // _mm_avg_epu8 rounds up, while the predictor rounds down
+            __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                _mm_and_si128(_mm_xor_si128(a, b), ones));
+            a = _mm_add_epi8(loadPixel<Bpp>(row), avg);
+            storePixel<Bpp>(row, a);
+            row += Bpp;
+            prev += Bpp;
+        }
+
+        size_t offset = pixelCount * Bpp;
+        decodeAverageRange(row - offset, prev - offset, len, bpp, offset);
+    }
+
+    static __m128i absEpi16(__m128i x)
+    {
+        return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+    }
+
+    static __m128i selectEpi16(__m128i condition, __m128i lhs, __m128i rhs)
+    {
+        return _mm_or_si128(_mm_and_si128(condition, lhs), _mm_andnot_si128(condition, rhs));
+    }
+
+    template <unsigned Bpp>
+    static void decodePaethSSE2(unsigned char* row, const unsigned char* prev, size_t len, unsigned bpp)
+    {
+        PODOFO_ASSERT(bpp == Bpp);
+        size_t pixelCount = len / Bpp;
+        __m128i zero = _mm_setzero_si128();
+
+        // Components are widened to 16 bits to compute the distances
+        __m128i a = zero;
+        __m128i c = zero;
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            __m128i b = _mm_unpacklo_epi8(loadPixel<Bpp>(prev), zero);
+            __m128i pa = _mm_sub_epi16(b, c);
+            __m128i pb = _mm_sub_epi16(a, c);
+            __m128i pc = _mm_add_epi16(pa, pb);
+            pa = absEpi16(pa);
+            pb = absEpi16(pb);
+            pc = absEpi16(pc);
+            __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+            __m128i closest = selectEpi16(_mm_cmpeq_epi16(smallest, pa), a,
+                selectEpi16(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+            __m128i x = _mm_add_epi8(loadPixel<Bpp>(row), _mm_packus_epi16(closest, closest));
+            storePixel<Bpp>(row, x);
+            a = _mm_unpacklo_epi8(x, zero);
+            c = b;
+            row += Bpp;
+            prev += Bpp;
         }
+
+        size_t offset = pixelCount * Bpp;
+        decodePaethRange(row - offset, prev - offset, len, bpp, offset);
+    }
+
+    template <unsigned Bpp>
+    static constexpr PngRowDecoders getSSE2Decoders()
+    {
+        return { decodeSubSSE2<Bpp>, decodeUpSSE2, decodeAverageSSE2<Bpp>, decodePaethSSE2<Bpp> };
+    }
+#endif // PODOFO_PREDICTOR_SSE2
+
+    static PngRowDecoders getRowDecoders(unsigned bpp)
+    {
+#ifdef PODOFO_PREDICTOR_SSE2
+        // Vectorized decoders for common layouts: 8 and 16 bits
+        // per component RGB/RGBA/CMYK images
+        switch (bpp)
+        {
+            case 3:
+                return getSSE2Decoders<3>();
+            case 4:
+                return getSSE2Decoders<4>();
+            case 6:
+                return getSSE2Decoders<6>();
+            case 8:
+                return getSSE2Decoders<8>();
+            default:
+                return { decodeSubScalar, decodeUpSSE2, decodeAverageScalar, decodePaethScalar };
+        }
+#else
+        (void)bpp;
+        return { decodeSubScalar, decodeUpScalar, decodeAverageScalar, decodePaethScalar };
+#endif // PODOFO_PREDICTOR_SSE2
     }
 
 private:
@@ -222,16 +470,15 @@ private:
 
     unsigned m_CurrPredictor;
     unsigned m_CurrRowIndex;
-    unsigned m_Rows;
+    unsigned m_RowLength;
 
     bool m_NextByteIsPredictor;
 
+    // The row being reconstructed and the previous one,
+    // as used by the PNG Up, Average and Paeth predictors
+    charbuff m_Curr;
     charbuff m_Prev;
-
-    // The PNG Paeth predictor uses the values of the pixel above and to the left
-    // of the current pixel. But we overwrite the row above as we go, so we'll
-    // have to store the bytes of the upper-left pixel separately.
-    charbuff m_UpperLeftPixelComponents;
+    PngRowDecoders m_RowDecoders;
 };
 
 } // end anonymous namespace
@@ -478,8 +725,89 @@ void PdfAscii85Filter::WidePut(unsigned tuple, int bytes) const
 
 #pragma endregion PdfFlateFilter
 
-PdfFlateFilter::PdfFlateFilter()
-    : m_buffer{ }, m_stream{ } { }
+PdfFlateFilter::PdfFlateFilter(const PdfFlateParams& params)
+    : m_buffer{ }, m_stream{ }, m_params(params) { }
+
+void PdfFlateFilter::ValidateParams(const PdfFlateParams& params)
+{
+    if (params.Level < -1 || params.Level > 9)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "The Flate compression level must be between -1 and 9");
+
+    if (params.Strategy > PdfFlateStrategy::Fixed)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Invalid Flate compression strategy");
+
+    if (params.WindowBits < 9 || params.WindowBits > 15)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "The Flate window bits must be between 9 and 15");
+
+    if (params.MemLevel < 1 || params.MemLevel > 9)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "The Flate memory level must be between 1 and 9");
+}
+
+void PdfFlateFilter::EncodeBuffer(charbuff& dst, const bufferview& src, const PdfFlateParams& params)
+{
+#ifdef PODOFO_HAVE_LIBDEFLATE
+    // libdeflate always uses the maximum window and has no
+    // strategies, so it can only replace the default settings
+    if (params.Strategy == PdfFlateStrategy::Default && params.WindowBits == 15)
+    {
+        auto compressor = libdeflate_alloc_compressor(params.Level < 0 ? 6 : params.Level);
+        if (compressor == nullptr)
+            PODOFO_RAISE_ERROR(PdfErrorCode::OutOfMemory);
+
+        dst.resize(libdeflate_zlib_compress_bound(compressor, src.size()));
+        size_t size = libdeflate_zlib_compress(compressor, src.data(), src.size(), dst.data(), dst.size());
+        libdeflate_free_compressor(compressor);
+        if (size == 0)
+            PODOFO_RAISE_ERROR(PdfErrorCode::FlateError);
+
+        dst.resize(size);
+        return;
+    }
+#endif // PODOFO_HAVE_LIBDEFLATE
+
+    z_stream stream{ };
+    if (deflateInit2(&stream, params.Level, Z_DEFLATED, params.WindowBits,
+            params.MemLevel, (int)params.Strategy) != Z_OK)
+    {
+        PODOFO_RAISE_ERROR(PdfErrorCode::FlateError);
+    }
+
+    // The zlib counters are 32 bit wide, so the input and the output
+    // are passed in chunks. The output is sized so inputs fitting a
+    // single chunk are compressed with a single call
+    constexpr size_t ChunkSize = 1u << 30;
+    dst.resize(deflateBound(&stream, (uLong)std::min(src.size(), ChunkSize)));
+    auto input = reinterpret_cast<const Bytef*>(src.data());
+    size_t inputLeft = src.size();
+    size_t size = 0;
+    int rc;
+    do
+    {
+        if (stream.avail_in == 0 && inputLeft != 0)
+        {
+            size_t chunkSize = std::min(inputLeft, ChunkSize);
+            stream.next_in = const_cast<Bytef*>(input);
+            stream.avail_in = (uInt)chunkSize;
+            input += chunkSize;
+            inputLeft -= chunkSize;
+        }
+
+        if (size == dst.size())
+            dst.resize(size + std::min(size, ChunkSize));
+
+        uInt outputLen = (uInt)std::min(dst.size() - size, ChunkSize);
+        stream.next_out = reinterpret_cast<Bytef*>(dst.data() + size);
+        stream.avail_out = outputLen;
+        rc = deflate(&stream, inputLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+        size += outputLen - stream.avail_out;
+    } while (rc == Z_OK);
+
+    deflateEnd(&stream);
+    if (rc != Z_STREAM_END)
+        PODOFO_RAISE_ERROR(PdfErrorCode::FlateError);
+
+    dst.resize(size);
+}
 
 void PdfFlateFilter::BeginEncodeImpl()
 {
@@ -487,8 +815,11 @@ void PdfFlateFilter::BeginEncodeImpl()
     m_stream.zfree = Z_NULL;
     m_stream.opaque = Z_NULL;
 
-    if (deflateInit(&m_stream, Z_DEFAULT_COMPRESSION))
+    if (deflateInit2(&m_stream, m_params.Level, Z_DEFLATED, m_params.WindowBits,
+            m_params.MemLevel, (int)m_params.Strategy) != Z_OK)
+    {
         PODOFO_RAISE_ERROR(PdfErrorCode::FlateError);
+    }
 }
 
 void PdfFlateFilter::EncodeBlockImpl(const char* buffer, size_t len)
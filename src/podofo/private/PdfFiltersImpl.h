@@ -92,7 +92,18 @@ class PdfFlateFilter final : public PdfFilter
     static constexpr unsigned BUFFER_SIZE = 4096;
 
 public:
-    PdfFlateFilter();
+    PdfFlateFilter(const PdfFlateParams& params = { });
+
+    /** Raise ValueOutOfRange if the parameters are not valid
+     */
+    static void ValidateParams(const PdfFlateParams& params);
+
+    /** Compress a whole buffer in a single pass, producing
+     * zlib formatted data suitable for a /FlateDecode stream
+     * \remarks If podofo was built with libdeflate it will be used
+     * when the parameters allow it
+     */
+    static void EncodeBuffer(charbuff& dst, const bufferview& src, const PdfFlateParams& params);
 
     inline bool CanEncode() const override { return true; }
 
@@ -119,6 +130,7 @@ private:
     unsigned char m_buffer[BUFFER_SIZE];
 
     z_stream m_stream;
+    PdfFlateParams m_params;
     std::shared_ptr<PdfPredictorDecoder> m_Predictor;
 };
 
@@ -78,7 +78,15 @@ void PdfImmediateWriter::finish()
 
 unique_ptr<PdfObjectStreamProvider> PdfImmediateWriter::CreateStream()
 {
-    return unique_ptr<PdfObjectStreamProvider>(new PdfStreamedObjectStream(*m_Device));
+    unique_ptr<PdfStreamedObjectStream> ret(new PdfStreamedObjectStream(*m_Device));
+
+    // Set the encryption now, since the stream output is
+    // created before BeginAppendStream() is called
+    auto encrypt = GetEncrypt();
+    if (encrypt != nullptr)
+        ret->SetEncrypt(encrypt->GetEncrypt(), encrypt->GetContext());
+
+    return ret;
 }
 
 void PdfImmediateWriter::BeginAppendStream(PdfObjectStream& stream)
@@ -91,12 +99,6 @@ void PdfImmediateWriter::BeginAppendStream(PdfObjectStream& stream)
 
     m_OpenStream = true;
     auto encrypt = GetEncrypt();
-    if (encrypt != nullptr)
-    {
-        auto& streamedObjectStream = dynamic_cast<PdfStreamedObjectStream&>(stream.GetProvider());
-        streamedObjectStream.SetEncrypt(encrypt->GetEncrypt(), encrypt->GetContext());
-    }
-
     auto& obj = stream.GetParent();
 
     // Manually mark the object as in-use, as it won't be
@@ -17,71 +17,184 @@ using namespace std;
 using namespace PoDoFo;
 
 PdfObjectStreamParser::PdfObjectStreamParser(PdfParserObject& parser,
-        PdfIndirectObjectList& objects, const shared_ptr<charbuff>& buffer)
-    : m_Parser(&parser), m_Objects(&objects), m_buffer(buffer)
+        PdfIndirectObjectList& objects, const shared_ptr<charbuff>& buffer) :
+    m_Parser(&parser),
+    m_Objects(&objects),
+    m_buffer(buffer),
+    m_tokenizer(m_buffer),
+    m_streamObjNum(parser.GetIndirectReference().ObjectNumber()),
+    m_streamLoaded(false)
 {
     if (buffer == nullptr)
         PODOFO_RAISE_ERROR(PdfErrorCode::InvalidHandle);
 }
 
+PdfObjectStreamParser::PdfObjectStreamParser(PdfIndirectObjectList& objects, uint32_t streamObjNum) :
+    m_Parser(nullptr),
+    m_Objects(&objects),
+    m_buffer(std::make_shared<charbuff>(PdfTokenizer::BufferSize)),
+    m_tokenizer(m_buffer),
+    m_streamObjNum(streamObjNum),
+    m_streamLoaded(false)
+{
+}
+
 void PdfObjectStreamParser::Parse(const cspan<int64_t>& objectList)
 {
-    int64_t num = m_Parser->GetDictionary().FindKeyAsSafe<int64_t>("N", 0);
-    int64_t first = m_Parser->GetDictionary().FindKeyAsSafe<int64_t>("First", 0);
+    vector<unique_ptr<PdfObject>> objects;
+    Parse(objectList, objects);
+    for (auto& obj : objects)
+        m_Objects->PushObject(obj.release());
+}
 
-    charbuff buffer;
-    m_Parser->GetOrCreateStream().CopyTo(buffer);
+void PdfObjectStreamParser::Parse(const cspan<int64_t>& objectList, vector<unique_ptr<PdfObject>>& objects)
+{
+    loadStream(*m_Parser);
+    if (objectList.size() != 0)
+        readObjectsFromStream(objectList, objects);
 
-    this->readObjectsFromStream(buffer.data(), buffer.size(), num, first, objectList);
     m_Parser = nullptr;
+    m_streamData = charbuff();
+    m_offsets = { };
 }
 
-void PdfObjectStreamParser::readObjectsFromStream(char* buffer, size_t bufferLen,
-    int64_t num, int64_t first, const cspan<int64_t>& objectList)
+void PdfObjectStreamParser::readObjectsFromStream(const cspan<int64_t>& objectList, vector<unique_ptr<PdfObject>>& objects)
 {
-    SpanStreamDevice device(buffer, bufferLen);
-    PdfTokenizer tokenizer(m_buffer);
+    // Mark the objects to read in a presized bitmap,
+    // so the lookup for each stream entry is O(1)
+    int64_t maxObjNo = *std::max_element(objectList.begin(), objectList.end());
+    if (maxObjNo < 0 || maxObjNo > std::numeric_limits<uint32_t>::max())
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::ValueOutOfRange, "Invalid object number");
+
+    vector<bool> selected((size_t)maxObjNo + 1);
+    for (int64_t objNo : objectList)
+    {
+        if (objNo >= 0)
+            selected[(size_t)objNo] = true;
+    }
+
+    // Read objects only once, if duplicated in the stream. The
+    // last occurrence is the one read, so scan the entries backward
+    vector<unsigned> indices;
+    for (size_t i = m_offsets.size(); i > 0; i--)
+    {
+        auto& pair = m_offsets[i - 1];
+        bool shouldRead = pair.first < selected.size() && selected[pair.first];
+#ifndef VERBOSE_DEBUG_DISABLED
+        std::cerr << "ReadObjectsFromStream STREAM=" << m_streamObjNum <<
+            ", OBJ=" << pair.first <<
+            ", " << (shouldRead ? "read" : "skipped") << std::endl;
+#endif
+        if (!shouldRead)
+            continue;
+
+        selected[pair.first] = false;
+        indices.push_back((unsigned)(i - 1));
+    }
+
+    SpanStreamDevice device(m_streamData.data(), m_streamData.size());
     PdfVariant var;
-    int i = 0;
+    for (auto it = indices.rbegin(); it != indices.rend(); it++)
+    {
+        auto& pair = m_offsets[*it];
+        readObject(device, pair.second, var);
+
+        // The generation number of an object stream and of any
+        // compressed object is implicitly zero
+        PdfReference reference(pair.first, 0);
+        unique_ptr<PdfObject> obj(new PdfObject(std::move(var)));
+        obj->SetIndirectReference(reference);
+        objects.push_back(std::move(obj));
+    }
+}
+
+bool PdfObjectStreamParser::TryReadObject(uint32_t objNum, unsigned index, PdfVariant& var)
+{
+    if (!m_streamLoaded)
+        loadStream();
 
-    while (i < num)
+    size_t offset;
+    if (index < m_offsets.size() && m_offsets[index].first == objNum)
+    {
+        offset = m_offsets[index].second;
+    }
+    else
     {
-        int64_t objNo = tokenizer.ReadNextNumber(device);
-        int64_t offset = tokenizer.ReadNextNumber(device);
-        size_t pos = device.GetPosition();
+        // The index reported by the xref is wrong, fallback
+        // searching the object number in the offset table. Search
+        // backward, so the last occurrence of duplicated objects is used
+        auto found = std::find_if(m_offsets.rbegin(), m_offsets.rend(),
+            [objNum](const pair<uint32_t, size_t>& pair) { return pair.first == objNum; });
+        if (found == m_offsets.rend())
+            return false;
+
+        offset = found->second;
+    }
 
-        if (first >= std::numeric_limits<int64_t>::max() - offset)
-        {
-            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::BrokenFile,
-                "Object position out of max limit");
-        }
+    SpanStreamDevice device(m_streamData.data(), m_streamData.size());
+    readObject(device, offset, var);
+    return true;
+}
 
-        // move to the position of the object in the stream
-        device.Seek(static_cast<size_t>(first + offset));
+void PdfObjectStreamParser::ReadObjectNumbers(vector<uint32_t>& objectNumbers)
+{
+    if (!m_streamLoaded)
+    {
+        if (m_Parser == nullptr)
+            loadStream();
+        else
+            loadStream(*m_Parser);
+    }
 
-        // use a second tokenizer here so that anything that gets dequeued isn't left in the tokenizer that reads the offsets and lengths
-        PdfTokenizer variantTokenizer(m_buffer);
-        variantTokenizer.ReadNextVariant(device, var); // NOTE: The stream is already decrypted
+    objectNumbers.clear();
+    for (auto& pair : m_offsets)
+        objectNumbers.push_back(pair.first);
+}
 
-        bool shouldRead = std::find(objectList.begin(), objectList.end(), objNo) != objectList.end();
-#ifndef VERBOSE_DEBUG_DISABLED
-        std::cerr << "ReadObjectsFromStream STREAM=" << m_Parser->GetIndirectReference().ToString() <<
-            ", OBJ=" << objNo <<
-            ", " << (shouldRead ? "read" : "skipped") << std::endl;
-#endif
-        if (shouldRead)
+void PdfObjectStreamParser::readObject(InputStreamDevice& device, size_t offset, PdfVariant& var)
+{
+    // The tokenizer is reused for all the objects: discard any token
+    // left enqueued by a previous read, since it belongs to a
+    // different position in the stream
+    m_tokenizer.clearTokenQueue();
+    device.Seek(offset);
+    m_tokenizer.ReadNextVariant(device, var); // NOTE: The stream is already decrypted
+}
+
+void PdfObjectStreamParser::loadStream()
+{
+    // Generation number of object streams is always 0
+    auto streamObj = m_Objects->GetObject(PdfReference(m_streamObjNum, 0));
+    if (streamObj == nullptr)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidObject, "Loading of object stream {} 0 R failed!", m_streamObjNum);
+
+    loadStream(*streamObj);
+}
+
+void PdfObjectStreamParser::loadStream(PdfObject& streamObj)
+{
+    int64_t num = streamObj.GetDictionary().FindKeyAsSafe<int64_t>("N", 0);
+    int64_t first = streamObj.GetDictionary().FindKeyAsSafe<int64_t>("First", 0);
+    if (num < 0 || first < 0)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::BrokenFile, "Invalid object stream /N or /First");
+
+    streamObj.MustGetStream().CopyTo(m_streamData);
+
+    SpanStreamDevice device(m_streamData.data(), m_streamData.size());
+    m_offsets.reserve((size_t)std::min(num, (int64_t)m_streamData.size()));
+    for (int64_t i = 0; i < num; i++)
+    {
+        int64_t objNo = m_tokenizer.ReadNextNumber(device);
+        int64_t offset = m_tokenizer.ReadNextNumber(device);
+        if (objNo < 0 || objNo > std::numeric_limits<uint32_t>::max()
+            || offset < 0 || first >= std::numeric_limits<int64_t>::max() - offset)
         {
-            // The generation number of an object stream and of any
-            // compressed object is implicitly zero
-            PdfReference reference(static_cast<uint32_t>(objNo), 0);
-            auto obj = new PdfObject(std::move(var));
-            obj->SetIndirectReference(reference);
-            m_Objects->PushObject(obj);
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::BrokenFile,
+                "Object position out of max limit");
         }
 
-        // move back to the position inside of the table of contents
-        device.Seek(pos);
-
-        i++;
+        m_offsets.push_back({ (uint32_t)objNo, (size_t)(first + offset) });
     }
+
+    m_streamLoaded = true;
 }
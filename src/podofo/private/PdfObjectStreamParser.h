@@ -24,9 +24,9 @@ class PdfObjectStreamParser
 {
 public:
     /**
-     * Create a new PdfObjectStreamParserObject from an existing
-     * PdfParserObject. The PdfParserObject will be removed and deleted.
-     * All objects from the object stream will be read into memory.
+     * Create a new PdfObjectStreamParser from an existing
+     * PdfParserObject. The selected objects from the object
+     * stream will be read into memory with Parse()
      *
      * \param parser PdfParserObject for an object stream
      * \param objects add loaded objects to this vector of objects
@@ -34,15 +34,61 @@ public:
      */
     PdfObjectStreamParser(PdfParserObject& parser, PdfIndirectObjectList& objects, const std::shared_ptr<charbuff>& buffer);
 
+    /**
+     * Create a new PdfObjectStreamParser for the object stream with
+     * the given number that is decoded only when the first object
+     * is read with TryReadObject(). The decoded stream and its offset
+     * table are then cached for all the following reads
+     *
+     * \param objects list where to find the object stream
+     * \param streamObjNum object number of the object stream
+     */
+    PdfObjectStreamParser(PdfIndirectObjectList& objects, uint32_t streamObjNum);
+
+    /** Read the selected objects from the stream and add them to the object list
+     * \param objectList numbers of the objects to read
+     */
     void Parse(const cspan<int64_t>& objectList);
 
+    /** Read the selected objects from the stream without adding them to the object list
+     * \param objectList numbers of the objects to read
+     * \param objects the vector where to store the read objects
+     */
+    void Parse(const cspan<int64_t>& objectList, std::vector<std::unique_ptr<PdfObject>>& objects);
+
+    /** Read a single compressed object from the stream
+     * \param objNum the number of the object to read
+     * \param index the index of the object in the stream, as reported by the xref
+     * \param var the variant where to store the object
+     * \returns false if the object could not be found in the stream
+     */
+    bool TryReadObject(uint32_t objNum, unsigned index, PdfVariant& var);
+
+    /** Read the numbers of the objects stored in the stream
+     * \param objectNumbers the vector where to store the numbers,
+     *     in the order they appear in the stream
+     */
+    void ReadObjectNumbers(std::vector<uint32_t>& objectNumbers);
+
 private:
-    void readObjectsFromStream(char* buffer, size_t lBufferLen, int64_t lNum, int64_t lFirst, const cspan<int64_t>& list);
+    void readObjectsFromStream(const cspan<int64_t>& objectList, std::vector<std::unique_ptr<PdfObject>>& objects);
+
+    void readObject(InputStreamDevice& device, size_t offset, PdfVariant& var);
+
+    void loadStream();
+
+    void loadStream(PdfObject& streamObj);
 
 private:
     PdfParserObject* m_Parser;
     PdfIndirectObjectList* m_Objects;
     std::shared_ptr<charbuff> m_buffer;
+    PdfTokenizer m_tokenizer;
+    uint32_t m_streamObjNum;
+    bool m_streamLoaded;
+    charbuff m_streamData;
+    // Object number and absolute offset in the stream of the contained objects
+    std::vector<std::pair<uint32_t, size_t>> m_offsets;
 };
 
 };
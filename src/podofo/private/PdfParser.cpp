@@ -8,10 +8,12 @@
 #include "PdfParser.h"
 
 #include <algorithm>
+#include <thread>
 #include <numerics/checked_math.h>
 
 #include <podofo/auxiliary/OutputDevice.h>
 #include <podofo/auxiliary/InputDevice.h>
+#include <podofo/auxiliary/StreamDevice.h>
 
 #include <podofo/main/PdfArray.h>
 #include <podofo/main/PdfDictionary.h>
@@ -19,12 +21,18 @@
 #include <podofo/main/PdfMemoryObjectStream.h>
 #include "PdfXRefStreamParserObject.h"
 #include "PdfObjectStreamParser.h"
+#include "PdfCompressedParserObject.h"
+#include "PdfArena.h"
 
 constexpr unsigned PDF_VERSION_LENGHT = 3;
 constexpr unsigned PDF_MAGIC_LENGHT = 8;
 constexpr unsigned PDF_XREF_ENTRY_SIZE = 20;
 constexpr unsigned PDF_XREF_BUF = 512;
+// Count of xref entries read at once by the fast xref subsection parser
+constexpr unsigned PDF_XREF_CHUNK_ENTRIES = 1024;
 constexpr unsigned MAX_XREF_SESSION_COUNT = 512;
+// Minimum number of xref entries for each thread when loading in parallel
+constexpr unsigned PARALLEL_LOAD_MIN_ENTRIES = 256;
 
 using namespace std;
 using namespace PoDoFo;
@@ -33,12 +41,79 @@ using namespace chromium::base;
 static bool CheckEOL(char e1, char e2);
 static bool CheckXRefEntryType(char c);
 static bool ReadMagicWord(char ch, unsigned& cursoridx);
+static bool TryParseXRefEntry(const char* buffer, uint64_t& variant, uint32_t& generation, char& type);
+
+/** Helper to run the parsing of the objects on multiple threads
+ *
+ * Each thread owns a disjoint range of the xref entries and its
+ * own device over the same read only file contents. Objects created
+ * by a thread keep a reference to its device, so they must be
+ * processed always by the same thread
+ */
+class PdfParser::ParallelObjectLoader final
+{
+public:
+    ParallelObjectLoader(InputStreamDevice& device, unsigned entryCount);
+
+public:
+    /** Get the count of threads that would parse the given count of xref entries
+     */
+    static unsigned GetThreadCount(unsigned entryCount);
+
+    /** Run the function on all threads and wait for them to finish.
+     * The first exception thrown by any thread is rethrown
+     * \param func a function with signature void(unsigned begin, unsigned end, InputStreamDevice& device),
+     *  where [begin, end) is the range of the xref entries owned by the thread
+     */
+    template <typename Func>
+    void Run(const Func& func)
+    {
+        unsigned threadCount = (unsigned)m_devices.size();
+        vector<exception_ptr> errors(threadCount);
+        auto run = [&](unsigned threadIndex)
+        {
+            try
+            {
+                func(getRangeBegin(threadIndex), getRangeBegin(threadIndex + 1), *m_devices[threadIndex]);
+            }
+            catch (...)
+            {
+                errors[threadIndex] = std::current_exception();
+            }
+        };
+
+        vector<thread> threads;
+        threads.reserve(threadCount - 1);
+        for (unsigned i = 1; i < threadCount; i++)
+            threads.emplace_back(run, i);
+
+        // Use also the current thread
+        run(0);
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto& error : errors)
+        {
+            if (error != nullptr)
+                std::rethrow_exception(error);
+        }
+    }
+
+private:
+    unsigned getRangeBegin(unsigned threadIndex) const;
+
+private:
+    charbuff m_buffer;
+    vector<unique_ptr<SpanStreamDevice>> m_devices;
+    unsigned m_EntryCount;
+};
 
 PdfParser::PdfParser(PdfIndirectObjectList& objects) :
     m_buffer(std::make_shared<charbuff>(PdfTokenizer::BufferSize)),
     m_tokenizer(m_buffer),
     m_Objects(&objects),
-    m_StrictParsing(false)
+    m_StrictParsing(false),
+    m_ParallelLoad(false)
 {
     this->reset();
 }
@@ -60,6 +135,10 @@ void PdfParser::reset()
 
     m_IgnoreBrokenObjects = true;
     m_IncrementalUpdateCount = 0;
+
+    m_linearizedFirstPage = PdfReference();
+    m_linearizedPageCount = 0;
+    m_recoveredObjectStreams.clear();
 }
 
 void PdfParser::Parse(InputStreamDevice& device, bool loadOnDemand)
@@ -68,12 +147,47 @@ void PdfParser::Parse(InputStreamDevice& device, bool loadOnDemand)
 
     m_LoadOnDemand = loadOnDemand;
 
+    // Allocate the objects in the arena of the document
+    PdfArenaScope arenaScope(&m_Objects->GetArena());
+
     try
     {
         if (!IsPdfFile(device))
             PODOFO_RAISE_ERROR(PdfErrorCode::InvalidPDF);
 
-        ReadDocumentStructure(device);
+        readLinearizationDictionary(device);
+
+        bool rebuildXRef = false;
+        try
+        {
+            ReadDocumentStructure(device);
+
+            // Offsets in damaged xref tables are often all shifted:
+            // check the one of the catalog, which is always needed
+            PdfReference rootRef;
+            auto rootObj = m_Trailer == nullptr ? nullptr : m_Trailer->GetDictionary().GetKey("Root");
+            rebuildXRef = !m_StrictParsing && (rootObj == nullptr
+                || !rootObj->TryGetReference(rootRef) || !isObjectHeaderValid(device, rootRef));
+        }
+        catch (PdfError& e)
+        {
+            if (m_StrictParsing)
+                throw;
+
+            // Try to recover from the broken xref,
+            // otherwise report the original error
+            PoDoFo::LogMessage(PdfLogSeverity::Warning, "Unable to read the xref table: {}", e.GetName());
+            if (!rebuildXRefTable(device))
+                throw;
+        }
+
+        if (rebuildXRef)
+        {
+            PoDoFo::LogMessage(PdfLogSeverity::Warning, "The xref table doesn't locate the document catalog");
+            if (!rebuildXRefTable(device))
+                PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidXRef, "Unable to rebuild the xref table");
+        }
+
         ReadObjects(device);
     }
     catch (PdfError& e)
@@ -186,6 +300,65 @@ bool PdfParser::IsPdfFile(InputStreamDevice& device)
     return true;
 }
 
+void PdfParser::readLinearizationDictionary(InputStreamDevice& device)
+{
+    // ISO 32000-2:2020 F.3.3: the linearization dictionary is
+    // the first indirect object in the file. Anything unexpected
+    // means the document is just not linearized. Probe with a
+    // separate tokenizer so a failed read can't leave tokens
+    // queued for the xref parsing that follows
+    PdfTokenizer tokenizer(m_buffer);
+    try
+    {
+        int64_t objNum;
+        int64_t gen;
+        string_view token;
+        PdfVariant variant;
+        const PdfDictionary* dict;
+        if (!tokenizer.TryReadNextNumber(device, objNum)
+            || !tokenizer.TryReadNextNumber(device, gen)
+            || !tokenizer.TryReadNextToken(device, token) || token != "obj"
+            || !tokenizer.TryReadNextVariant(device, variant)
+            || !variant.TryGetDictionary(dict)
+            || dict->FindKey("Linearized") == nullptr)
+        {
+            return;
+        }
+
+        // The dictionary is stale if the file was updated
+        int64_t length;
+        int64_t pageObjNum;
+        int64_t pageCount;
+        if (!dict->TryFindKeyAs("L", length) || (size_t)length != device.GetLength()
+            || !dict->TryFindKeyAs("O", pageObjNum) || pageObjNum <= 0
+            || !dict->TryFindKeyAs("N", pageCount) || pageCount <= 0)
+        {
+            return;
+        }
+
+        m_linearizedFirstPage = PdfReference((uint32_t)pageObjNum, 0);
+        m_linearizedPageCount = (unsigned)pageCount;
+    }
+    catch (PdfError&)
+    {
+        // Not a linearization dictionary
+    }
+}
+
+bool PdfParser::TryGetLinearizedFirstPage(PdfReference& ref, unsigned& pageCount) const
+{
+    uint32_t objNum = m_linearizedFirstPage.ObjectNumber();
+    if (objNum == 0 || objNum >= m_entries.GetSize()
+        || m_entries[objNum].Type != PdfXRefEntryType::InUse)
+    {
+        return false;
+    }
+
+    ref = PdfReference(objNum, (uint16_t)m_entries[objNum].Generation);
+    pageCount = m_linearizedPageCount;
+    return true;
+}
+
 void PdfParser::mergeTrailer(const PdfObject& trailer)
 {
     PODOFO_ASSERT(m_Trailer != nullptr);
@@ -407,6 +580,42 @@ bool CheckXRefEntryType(char c)
     return c == 'n' || c == 'f';
 }
 
+// Parse a fixed count of decimal digits. The loop has no
+// early exit so compilers can fully unroll and vectorize it
+template <unsigned N>
+static bool tryParseDigits(const char* str, uint64_t& value)
+{
+    uint64_t ret = 0;
+    unsigned invalid = 0;
+    for (unsigned i = 0; i < N; i++)
+    {
+        unsigned digit = (unsigned char)str[i] - (unsigned)'0';
+        invalid |= digit > 9 ? 1 : 0;
+        ret = ret * 10 + digit;
+    }
+
+    value = ret;
+    return invalid == 0;
+}
+
+// Parse a strictly well formed xref entry "nnnnnnnnnn ggggg n eol"
+bool TryParseXRefEntry(const char* buffer, uint64_t& variant, uint32_t& generation, char& type)
+{
+    uint64_t gen;
+    if (!tryParseDigits<10>(buffer, variant)
+        || !tryParseDigits<5>(buffer + 11, gen)
+        || buffer[10] != ' ' || buffer[16] != ' '
+        || !CheckXRefEntryType(buffer[17])
+        || !CheckEOL(buffer[18], buffer[19]))
+    {
+        return false;
+    }
+
+    generation = (uint32_t)gen;
+    type = buffer[17];
+    return true;
+}
+
 void PdfParser::ReadXRefSubsection(InputStreamDevice& device, int64_t& firstObject, int64_t& objectCount)
 {
 #ifdef PODOFO_VERBOSE_DEBUG
@@ -431,7 +640,9 @@ void PdfParser::ReadXRefSubsection(InputStreamDevice& device, int64_t& firstObje
     while (device.Peek(ch) && PoDoFo::IsCharWhitespace(ch))
         (void)device.ReadChar();
 
-    unsigned index = 0;
+    // Try first to parse well formed entries in bulk, then
+    // continue with the tolerant parser from the first bad entry
+    unsigned index = readXRefSubsectionFast(device, (unsigned)firstObject, (unsigned)objectCount);
     char* buffer = m_buffer->data();
     while (index < objectCount)
     {
@@ -469,37 +680,7 @@ void PdfParser::ReadXRefSubsection(InputStreamDevice& device, int64_t& firstObje
                 PODOFO_RAISE_ERROR(PdfErrorCode::InvalidXRef);
             }
 
-            switch (type)
-            {
-                case PdfXRefEntryType::Free:
-                {
-                    // The variant is the number of the next free object
-                    entry.ObjectNumber = variant;
-                    break;
-                }
-                case PdfXRefEntryType::InUse:
-                {
-                    // Support also files with whitespace offset before magic start
-                    variant += (uint64_t)m_magicOffset;
-                    if (variant > PTRDIFF_MAX)
-                    {
-                        // max size is PTRDIFF_MAX, so throw error if llOffset too big
-                        PODOFO_RAISE_ERROR(PdfErrorCode::ValueOutOfRange);
-                    }
-
-                    entry.Offset = variant;
-                    break;
-                }
-                default:
-                {
-                    // This flow should have beeb already been cathed earlier
-                    PODOFO_ASSERT(false);
-                }
-            }
-
-            entry.Generation = generation;
-            entry.Type = type;
-            entry.Parsed = true;
+            setXRefEntry(entry, variant, generation, type);
         }
 
         index++;
@@ -512,6 +693,81 @@ void PdfParser::ReadXRefSubsection(InputStreamDevice& device, int64_t& firstObje
     }
 }
 
+unsigned PdfParser::readXRefSubsectionFast(InputStreamDevice& device, unsigned firstObject, unsigned objectCount)
+{
+    charbuff buffer(std::min(objectCount, PDF_XREF_CHUNK_ENTRIES) * PDF_XREF_ENTRY_SIZE);
+    unsigned index = 0;
+    while (index < objectCount)
+    {
+        size_t chunkPosition = device.GetPosition();
+        unsigned chunkCount = std::min(objectCount - index, PDF_XREF_CHUNK_ENTRIES);
+        bool eof;
+        size_t read = device.Read(buffer.data(), chunkCount * PDF_XREF_ENTRY_SIZE, eof);
+        unsigned readCount = (unsigned)(read / PDF_XREF_ENTRY_SIZE);
+        const char* record = buffer.data();
+        for (unsigned i = 0; i < readCount; i++, record += PDF_XREF_ENTRY_SIZE)
+        {
+            uint64_t variant;
+            uint32_t generation;
+            char chType;
+            if (!TryParseXRefEntry(record, variant, generation, chType))
+            {
+                // Let the tolerant parser handle this entry and the following ones
+                device.Seek(chunkPosition + i * PDF_XREF_ENTRY_SIZE);
+                return index + i;
+            }
+
+            auto& entry = m_entries[firstObject + index + i];
+            if (!entry.Parsed)
+                setXRefEntry(entry, variant, generation, XRefEntryTypeFromChar(chType));
+        }
+
+        index += readCount;
+        if (readCount != chunkCount)
+        {
+            device.Seek(chunkPosition + readCount * PDF_XREF_ENTRY_SIZE);
+            break;
+        }
+    }
+
+    return index;
+}
+
+void PdfParser::setXRefEntry(PdfXRefEntry& entry, uint64_t variant, uint32_t generation, PdfXRefEntryType type)
+{
+    switch (type)
+    {
+        case PdfXRefEntryType::Free:
+        {
+            // The variant is the number of the next free object
+            entry.ObjectNumber = variant;
+            break;
+        }
+        case PdfXRefEntryType::InUse:
+        {
+            // Support also files with whitespace offset before magic start
+            variant += (uint64_t)m_magicOffset;
+            if (variant > PTRDIFF_MAX)
+            {
+                // max size is PTRDIFF_MAX, so throw error if llOffset too big
+                PODOFO_RAISE_ERROR(PdfErrorCode::ValueOutOfRange);
+            }
+
+            entry.Offset = variant;
+            break;
+        }
+        default:
+        {
+            // This flow should have beeb already been cathed earlier
+            PODOFO_ASSERT(false);
+        }
+    }
+
+    entry.Generation = generation;
+    entry.Type = type;
+    entry.Parsed = true;
+}
+
 void PdfParser::ReadXRefStreamContents(InputStreamDevice& device, size_t offset, bool skipFollowPrevious)
 {
     utls::RecursionGuard guard;
@@ -644,8 +900,34 @@ void PdfParser::ReadObjects(InputStreamDevice& device)
 
 void PdfParser::readObjectsInternal(InputStreamDevice& device)
 {
+    // Parse the objects in parallel only if they are read immediately
+    // NOTE: Encrypted documents are always parsed serially
+    if (!m_recoveredObjectStreams.empty())
+        recoverCompressedEntries(device);
+
+    unique_ptr<ParallelObjectLoader> loader;
+    vector<unique_ptr<PdfParserObject>> parsedObjects;
+    vector<exception_ptr> parseErrors;
+    // NOTE: Don't create the loader if the objects would be parsed
+    // by one thread only, to avoid copying the file contents in memory
+    if (m_ParallelLoad && !m_LoadOnDemand && m_Encrypt == nullptr
+        && ParallelObjectLoader::GetThreadCount(m_entries.GetSize()) > 1)
+    {
+        loader.reset(new ParallelObjectLoader(device, m_entries.GetSize()));
+        parseObjectsParallel(*loader, parsedObjects, parseErrors);
+    }
+
+    // Reserve the index only for the objects actually
+    // found, since the xref size may be hostile
+    unsigned objectCount = 0;
+    for (unsigned i = 0; i < m_entries.GetSize(); i++)
+    {
+        if (m_entries[i].Parsed && m_entries[i].Type != PdfXRefEntryType::Free)
+            objectCount++;
+    }
+    m_Objects->ReserveObjects(objectCount);
+
     // Read objects
-    vector<unsigned> compressedIndices;
     map<int64_t, vector<int64_t>> compressedObjects;
     for (unsigned i = 0; i < m_entries.GetSize(); i++)
     {
@@ -665,25 +947,37 @@ void PdfParser::readObjectsInternal(InputStreamDevice& device)
                     if (entry.Offset > 0)
                     {
                         PdfReference reference(i, (uint16_t)entry.Generation);
-                        unique_ptr<PdfParserObject> obj(new PdfParserObject(m_Objects->GetDocument(), reference, device, (ssize_t)entry.Offset));
+                        unique_ptr<PdfParserObject> obj;
                         try
                         {
-                            if (m_Encrypt != nullptr)
+                            if (loader == nullptr)
                             {
-                                obj->SetEncrypt(m_Encrypt);
-                                PdfDictionary* objDict;
-                                if (obj->TryGetDictionary(objDict))
+                                obj.reset(new PdfParserObject(m_Objects->GetDocument(), reference, device, (ssize_t)entry.Offset));
+                                if (m_Encrypt != nullptr)
                                 {
-                                    auto typeObj = objDict->GetKey("Type");
-                                    if (typeObj != nullptr && typeObj->IsName() && typeObj->GetName() == "XRef")
+                                    obj->SetEncrypt(m_Encrypt);
+                                    PdfDictionary* objDict;
+                                    if (obj->TryGetDictionary(objDict))
                                     {
-                                        // XRef is never encrypted
-                                        obj.reset(new PdfParserObject(m_Objects->GetDocument(), reference, device, (ssize_t)entry.Offset));
-                                        if (m_LoadOnDemand)
-                                            obj->DelayedLoad();
+                                        auto typeObj = objDict->GetKey("Type");
+                                        if (typeObj != nullptr && typeObj->IsName() && typeObj->GetName() == "XRef")
+                                        {
+                                            // XRef is never encrypted
+                                            obj.reset(new PdfParserObject(m_Objects->GetDocument(), reference, device, (ssize_t)entry.Offset));
+                                            if (m_LoadOnDemand)
+                                                obj->DelayedLoad();
+                                        }
                                     }
                                 }
                             }
+                            else
+                            {
+                                // The object was already parsed by a worker thread
+                                if (parseErrors[i] != nullptr)
+                                    std::rethrow_exception(parseErrors[i]);
+
+                                obj = std::move(parsedObjects[i]);
+                            }
 
                             m_Objects->PushObject(obj.release());
                         }
@@ -692,16 +986,14 @@ void PdfParser::readObjectsInternal(InputStreamDevice& device)
                             if (m_IgnoreBrokenObjects)
                             {
                                 PoDoFo::LogMessage(PdfLogSeverity::Error, "Error while loading object {} {} R, Offset={}, Index={}",
-                                    obj->GetIndirectReference().ObjectNumber(),
-                                    obj->GetIndirectReference().GenerationNumber(),
+                                    reference.ObjectNumber(), reference.GenerationNumber(),
                                     entry.Offset, i);
                                 m_Objects->SafeAddFreeObject(reference);
                             }
                             else
                             {
                                 PODOFO_PUSH_FRAME_INFO(e, "Error while loading object {} {} R, Offset={}, Index={}",
-                                    obj->GetIndirectReference().ObjectNumber(),
-                                    obj->GetIndirectReference().GenerationNumber(),
+                                    reference.ObjectNumber(), reference.GenerationNumber(),
                                     entry.Offset, i);
                                 throw;
                             }
@@ -760,20 +1052,31 @@ void PdfParser::readObjectsInternal(InputStreamDevice& device)
     // all normal objects including object streams are available now,
     // we can parse the object streams safely now.
     //
-    // Note that even if demand loading is enabled we still currently read all
-    // objects from the stream into memory then free the stream.
-    //
-    for (auto& pair : compressedObjects)
+    // If demand loading is enabled the objects are just recorded,
+    // and each object stream is decoded only when one of its
+    // objects is accessed first
+    if (loader == nullptr)
     {
-#ifndef VERBOSE_DEBUG_DISABLED
-        if (m_LoadOnDemand)
-            cerr << "Demand loading on, but can't demand-load from object stream." << endl;
-#endif
-        readCompressedObjectFromStream((uint32_t)pair.first, pair.second);
-        m_Objects->AddObjectStream((uint32_t)pair.first);
+        for (auto& pair : compressedObjects)
+        {
+            if (m_LoadOnDemand)
+                createCompressedObjects((uint32_t)pair.first, pair.second);
+            else
+                readCompressedObjectFromStream((uint32_t)pair.first, pair.second);
+
+            m_Objects->AddObjectStream((uint32_t)pair.first);
+        }
+    }
+    else
+    {
+        readCompressedObjectsParallel(*loader, compressedObjects);
     }
 
-    if (!m_LoadOnDemand)
+    if (loader != nullptr)
+    {
+        parseStreamsParallel(*loader, device);
+    }
+    else if (!m_LoadOnDemand)
     {
         // Force loading of streams. We can't do this during the initial
         // run that populates m_Objects because a stream might have a /Length
@@ -781,8 +1084,11 @@ void PdfParser::readObjectsInternal(InputStreamDevice& device)
         // in a second pass, or (if demand loading is enabled) defer it for later.
         for (auto objToLoad : *m_Objects)
         {
+            // Objects read from object streams are not parser objects
+            // and they can't have streams
             auto obj = dynamic_cast<PdfParserObject*>(objToLoad);
-            obj->ParseStream();
+            if (obj != nullptr)
+                obj->ParseStream();
         }
     }
 
@@ -810,6 +1116,152 @@ void PdfParser::readCompressedObjectFromStream(uint32_t objNo, const cspan<int64
     parserObject.Parse(objectList);
 }
 
+void PdfParser::parseObjectsParallel(ParallelObjectLoader& loader,
+    vector<unique_ptr<PdfParserObject>>& parsedObjects, vector<exception_ptr>& parseErrors)
+{
+    parsedObjects.resize(m_entries.GetSize());
+    parseErrors.resize(m_entries.GetSize());
+    const auto& entries = m_entries;
+    loader.Run([&](unsigned begin, unsigned end, InputStreamDevice& device)
+    {
+        for (unsigned i = begin; i < end; i++)
+        {
+            auto& entry = entries[i];
+            if (!entry.Parsed || entry.Type != PdfXRefEntryType::InUse || entry.Offset == 0)
+                continue;
+
+            unique_ptr<PdfParserObject> obj(new PdfParserObject(m_Objects->GetDocument(),
+                PdfReference(i, (uint16_t)entry.Generation), device, (ssize_t)entry.Offset));
+            try
+            {
+                obj->Parse();
+                parsedObjects[i] = std::move(obj);
+            }
+            catch (PdfError&)
+            {
+                // The error is handled when merging the objects
+                parseErrors[i] = std::current_exception();
+            }
+        }
+    });
+}
+
+void PdfParser::readCompressedObjectsParallel(ParallelObjectLoader& loader,
+    const map<int64_t, vector<int64_t>>& compressedObjects)
+{
+    vector<PdfParserObject*> streamObjs;
+    vector<uint32_t> streamObjNums;
+    streamObjs.reserve(compressedObjects.size());
+    streamObjNums.reserve(compressedObjects.size());
+    for (auto& pair : compressedObjects)
+    {
+        // generation number of object streams is always 0
+        auto streamObj = dynamic_cast<PdfParserObject*>(m_Objects->GetObject(PdfReference((uint32_t)pair.first, 0)));
+        if (streamObj == nullptr)
+        {
+            if (m_IgnoreBrokenObjects)
+                PoDoFo::LogMessage(PdfLogSeverity::Error, "Loading of object {} 0 R failed!", pair.first);
+            else
+                PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidObject, "Loading of object {} 0 R failed!", pair.first);
+        }
+
+        streamObjs.push_back(streamObj);
+        streamObjNums.push_back((uint32_t)pair.first);
+    }
+
+    // Object streams are decoded by the thread owning the stream object
+    vector<vector<unique_ptr<PdfObject>>> streamsObjects(compressedObjects.size());
+    loader.Run([&](unsigned begin, unsigned end, InputStreamDevice&)
+    {
+        auto buffer = std::make_shared<charbuff>(PdfTokenizer::BufferSize);
+        unsigned i = 0;
+        for (auto& pair : compressedObjects)
+        {
+            if (streamObjs[i] != nullptr && streamObjNums[i] >= begin && streamObjNums[i] < end)
+            {
+                PdfObjectStreamParser parserObject(*streamObjs[i], *m_Objects, buffer);
+                parserObject.Parse(pair.second, streamsObjects[i]);
+            }
+
+            i++;
+        }
+    });
+
+    for (unsigned i = 0; i < streamObjNums.size(); i++)
+    {
+        for (auto& obj : streamsObjects[i])
+            m_Objects->PushObject(obj.release());
+
+        m_Objects->AddObjectStream(streamObjNums[i]);
+    }
+}
+
+void PdfParser::parseStreamsParallel(ParallelObjectLoader& loader, InputStreamDevice& mainDevice)
+{
+    const auto& entries = m_entries;
+
+    // Resolve the stream lengths in advance: an indirect /Length
+    // would be otherwise read while another thread is parsing it
+    for (unsigned i = 0; i < entries.GetSize(); i++)
+    {
+        auto& entry = entries[i];
+        if (!entry.Parsed || entry.Type != PdfXRefEntryType::InUse || entry.Offset == 0)
+            continue;
+
+        auto obj = dynamic_cast<PdfParserObject*>(m_Objects->GetObject(PdfReference(i, (uint16_t)entry.Generation)));
+        if (obj != nullptr && obj->m_HasStream)
+            obj->resolveStreamLength();
+    }
+
+    loader.Run([&](unsigned begin, unsigned end, InputStreamDevice&)
+    {
+        for (unsigned i = begin; i < end; i++)
+        {
+            auto& entry = entries[i];
+            if (!entry.Parsed || entry.Type != PdfXRefEntryType::InUse || entry.Offset == 0)
+                continue;
+
+            auto obj = dynamic_cast<PdfParserObject*>(m_Objects->GetObject(PdfReference(i, (uint16_t)entry.Generation)));
+            if (obj == nullptr)
+                continue;
+
+            obj->ParseStream();
+
+            // The devices of the worker threads are going to be destroyed:
+            // rebind the object to the main device, that reads the same
+            // contents, so it can still be unloaded and reloaded
+            obj->m_device = &mainDevice;
+        }
+    });
+}
+
+void PdfParser::createCompressedObjects(uint32_t objNo, const cspan<int64_t>& objectList)
+{
+    // generation number of object streams is always 0
+    if (m_Objects->GetObject(PdfReference(objNo, 0)) == nullptr)
+    {
+        if (m_IgnoreBrokenObjects)
+        {
+            PoDoFo::LogMessage(PdfLogSeverity::Error, "Loading of object {} 0 R failed!", objNo);
+            return;
+        }
+        else
+        {
+            PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidObject, "Loading of object {} 0 R failed!", objNo);
+        }
+    }
+
+    auto streamParser = std::make_shared<PdfObjectStreamParser>(*m_Objects, objNo);
+    for (int64_t objNum : objectList)
+    {
+        // The generation number of an object stream and of any
+        // compressed object is implicitly zero
+        PdfReference reference(static_cast<uint32_t>(objNum), 0);
+        m_Objects->PushObject(new PdfCompressedParserObject(m_Objects->GetDocument(),
+            reference, streamParser, m_entries[(unsigned)objNum].Index));
+    }
+}
+
 void PdfParser::findTokenBackward(InputStreamDevice& device, const char* token, size_t range, size_t searchEnd)
 {
     device.Seek((ssize_t)searchEnd, SeekDirection::Begin);
@@ -1017,3 +1469,40 @@ bool ReadMagicWord(char ch, unsigned& cursoridx)
 
     return false;
 }
+
+PdfParser::ParallelObjectLoader::ParallelObjectLoader(InputStreamDevice& device, unsigned entryCount) :
+    m_EntryCount(entryCount)
+{
+    // Create the thread devices on a view of the whole file contents.
+    // Memory mapped files can be shared directly, otherwise
+    // the contents are read once in memory
+    bufferview view;
+    auto mapped = dynamic_cast<MappedFileStreamDevice*>(&device);
+    if (mapped == nullptr)
+    {
+        device.Seek(0);
+        m_buffer.resize(device.GetLength());
+        device.Read(m_buffer.data(), m_buffer.size());
+        view = m_buffer;
+    }
+    else
+    {
+        view = mapped->GetView();
+    }
+
+    unsigned threadCount = GetThreadCount(entryCount);
+    m_devices.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++)
+        m_devices.push_back(std::make_unique<SpanStreamDevice>(view));
+}
+
+unsigned PdfParser::ParallelObjectLoader::GetThreadCount(unsigned entryCount)
+{
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    return std::max(1u, std::min(threadCount, entryCount / PARALLEL_LOAD_MIN_ENTRIES));
+}
+
+unsigned PdfParser::ParallelObjectLoader::getRangeBegin(unsigned threadIndex) const
+{
+    return (unsigned)((uint64_t)m_EntryCount * threadIndex / m_devices.size());
+}
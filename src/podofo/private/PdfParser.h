@@ -155,12 +155,47 @@ public:
      */
     inline void SetIgnoreBrokenObjects(bool broken) { m_IgnoreBrokenObjects = broken; }
 
+    /**
+     * \return true if objects are parsed in parallel when not loading on demand
+     */
+    inline bool IsParallelLoad() const { return m_ParallelLoad; }
+
+    /**
+     * Enable/disable parsing of the objects on multiple threads.
+     * Parallel loading is by default disabled, and it's
+     * used only if objects are not loaded on demand.
+     *
+     * Each thread parses a disjoint range of the xref entries,
+     * including the object streams and the streams of the objects
+     * it owns, and the objects are added to the list at the end.
+     * Encrypted documents are always parsed serially
+     *
+     * \param parallel new setting for parallel loading
+     */
+    inline void SetParallelLoad(bool parallel) { m_ParallelLoad = parallel; }
+
+    /** Get the offset of the last xref section, or 0
+     * if the xref table was rebuilt by scanning the file
+     */
     inline size_t GetXRefOffset() const { return m_XRefOffset; }
 
     inline bool HasXRefStream() const { return m_HasXRefStream; }
 
     const PdfEncryptSession* GetEncrypt() const { return m_Encrypt.get(); }
 
+    /** Get the first page of a linearized document, as found in
+     *  the linearization dictionary. The dictionary is considered
+     *  only if it's valid for the whole file, eg. the document
+     *  has no incremental updates
+     *  \param ref the reference of the first page object
+     *  \param pageCount the number of pages of the document
+     *  \returns false if the document is not linearized
+     */
+    bool TryGetLinearizedFirstPage(PdfReference& ref, unsigned& pageCount) const;
+
+private:
+    class ParallelObjectLoader;
+
 private:
     /**
      * Reads the xref sections and the trailers of the file
@@ -215,6 +250,11 @@ private:
      */
     bool IsPdfFile(InputStreamDevice& device);
 
+    /** Reads the linearization dictionary, if it's
+     *  the first object following the file header
+     */
+    void readLinearizationDictionary(InputStreamDevice& device);
+
 private:
     /** Searches backwards from the specified position of the file
      *  and tries to find a token.
@@ -239,6 +279,33 @@ private:
      */
     void findXRef(InputStreamDevice& device, size_t& xRefOffset);
 
+    /** Read in bulk the well formed entries of a xref subsection
+     *  \returns the count of entries read. The device is positioned
+     *  at the first entry not read
+     */
+    unsigned readXRefSubsectionFast(InputStreamDevice& device, unsigned firstObject, unsigned objectCount);
+
+    void setXRefEntry(PdfXRefEntry& entry, uint64_t variant, uint32_t generation, PdfXRefEntryType type);
+
+    /** Rebuild the xref table and the trailer scanning
+     *  the whole file for object definitions and trailers,
+     *  to recover documents with a broken or missing xref
+     *  \returns false if the document catalog could not be found
+     */
+    bool rebuildXRefTable(InputStreamDevice& device);
+
+    /** Add the entries of the objects stored in the object
+     *  streams found while rebuilding the xref table. It must
+     *  be done after the encryption is set up
+     */
+    void recoverCompressedEntries(InputStreamDevice& device);
+
+    bool tryReadObjectType(InputStreamDevice& device, size_t offset, PdfName& type);
+
+    /** Check the xref entry of the object actually points to its definition
+     */
+    bool isObjectHeaderValid(InputStreamDevice& device, const PdfReference& ref);
+
     /** Reads all objects from the pdf into memory
      *  from the previously read entries
      *
@@ -266,6 +333,33 @@ private:
      */
     void readCompressedObjectFromStream(uint32_t objNo, const cspan<int64_t>& objectList);
 
+    /** Create the objects compressed in the object stream objNo
+     *  so that they are read only when accessed first
+     *
+     *  \param objNo object number of the stream object
+     *  \param objectList numbers of the objects to create
+     */
+    void createCompressedObjects(uint32_t objNo, const cspan<int64_t>& objectList);
+
+    /** Parse the objects of all in use xref entries on the loader threads
+     *  \param parsedObjects the parsed objects, by xref index
+     *  \param parseErrors the errors happened while parsing the objects, by xref index
+     */
+    void parseObjectsParallel(ParallelObjectLoader& loader,
+        std::vector<std::unique_ptr<PdfParserObject>>& parsedObjects,
+        std::vector<std::exception_ptr>& parseErrors);
+
+    /** Decode the object streams on the loader threads
+     *  and push the read objects in the objects list
+     */
+    void readCompressedObjectsParallel(ParallelObjectLoader& loader,
+        const std::map<int64_t, std::vector<int64_t>>& compressedObjects);
+
+    /** Parse the streams of the objects on the loader threads
+     *  \param mainDevice the device to bind the objects to after parsing
+     */
+    void parseStreamsParallel(ParallelObjectLoader& loader, InputStreamDevice& mainDevice);
+
     void readNextTrailer(InputStreamDevice& device, bool skipFollowPrevious);
 
 
@@ -321,10 +415,16 @@ private:
 
     bool m_StrictParsing;
     bool m_IgnoreBrokenObjects;
+    bool m_ParallelLoad;
 
     unsigned m_IncrementalUpdateCount;
 
+    PdfReference m_linearizedFirstPage;
+    unsigned m_linearizedPageCount;
+
     std::set<size_t> m_visitedXRefOffsets;
+    // Object streams found while rebuilding the xref table
+    std::vector<uint32_t> m_recoveredObjectStreams;
 };
 
 };
@@ -9,8 +9,11 @@
 
 #include <podofo/main/PdfArray.h>
 #include <podofo/main/PdfDictionary.h>
+#include <podofo/main/PdfDocument.h>
 
 #include "PdfFilterFactory.h"
+#include "PdfArena.h"
+#include "PdfPassthroughObjectStream.h"
 
 using namespace PoDoFo;
 using namespace std;
@@ -40,9 +43,11 @@ PdfParserObject::PdfParserObject(PdfDocument* doc, const PdfReference& indirectR
     m_device(&device),
     m_Offset(offset < 0 ? device.GetPosition() : offset),
     m_StreamOffset(0),
+    m_StreamLength(-1),
     m_IsTrailer(false),
     m_HasStream(false),
-    m_IsRevised(false)
+    m_IsRevised(false),
+    m_StreamInMemory(false)
 {
     // Parsed objects by definition are initially not dirty
     resetDirty();
@@ -63,12 +68,18 @@ void PdfParserObject::Parse()
 
 void PdfParserObject::ParseStream()
 {
-    // It's really just a call to DelayedLoad
+    // Streams parsed eagerly are fully read in memory, since
+    // the source device is not required to outlive the object.
+    // Otherwise it's really just a call to DelayedLoad
+    m_StreamInMemory = true;
     DelayedLoadStream();
 }
 
 void PdfParserObject::delayedLoad()
 {
+    // Allocate the loaded data in the arena of the document
+    auto doc = GetDocument();
+    PdfArenaScope arenaScope(doc == nullptr ? nullptr : &doc->GetObjects().GetArena());
     PdfTokenizer tokenizer;
     m_device->Seek(m_Offset);
     if (!m_IsTrailer)
@@ -103,6 +114,7 @@ bool PdfParserObject::removeStream()
     bool hasStream = m_HasStream;
     m_HasStream = false;
     m_StreamOffset = 0;
+    m_StreamLength = -1;
     return hasStream;
 }
 
@@ -178,12 +190,11 @@ void PdfParserObject::parseStream()
 {
     PODOFO_ASSERT(IsDelayedLoadDone());
 
-    int64_t size = -1;
     char ch;
+    if (m_StreamLength < 0)
+        resolveStreamLength();
 
-    auto& lengthObj = this->m_Variant.GetDictionaryUnsafe().MustFindKey("Length");
-    if (!lengthObj.TryGetNumber(size))
-        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidStream, "Invlid stream length");
+    int64_t size = m_StreamLength;
 
     m_device->Seek(m_StreamOffset);
 
@@ -251,12 +262,27 @@ ReadStream:
         // It's not needed for serialization here
         m_Encrypt = nullptr;
     }
+    else if (!m_StreamInMemory && size >= 0
+        && static_cast<uint64_t>(size) <= m_device->GetLength() - streamOffset)
+    {
+        // Leave the data in the source device, it will be read
+        // on demand or copied straight to the output on save
+        getOrCreateStream().InitData(unique_ptr<PdfObjectStreamProvider>(
+            new PdfPassthroughObjectStream(*m_device, streamOffset, static_cast<size_t>(size))), std::move(filters));
+    }
     else
     {
         getOrCreateStream().InitData(*m_device, static_cast<ssize_t>(size), std::move(filters));
     }
 }
 
+void PdfParserObject::resolveStreamLength()
+{
+    auto& lengthObj = this->m_Variant.GetDictionaryUnsafe().MustFindKey("Length");
+    if (!lengthObj.TryGetNumber(m_StreamLength) || m_StreamLength < 0)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InvalidStream, "Invlid stream length");
+}
+
 void PdfParserObject::checkReference(PdfTokenizer& tokenizer)
 {
     auto reference = readReference(tokenizer);
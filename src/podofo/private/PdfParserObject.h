@@ -95,6 +95,11 @@ private:
      */
     void parseStream();
 
+    /** Resolve the /Length of the stream, which may be
+     *  an indirect object, and remember it for parseStream()
+     */
+    void resolveStreamLength();
+
     PdfReference readReference(PdfTokenizer& tokenizer);
 
     void checkReference(PdfTokenizer& tokenizer);
@@ -104,9 +109,11 @@ private:
     InputStreamDevice* m_device;
     size_t m_Offset;
     size_t m_StreamOffset;
+    int64_t m_StreamLength;   ///< The resolved /Length of the stream, or -1 if not resolved yet
     bool m_IsTrailer;
     bool m_HasStream;
     bool m_IsRevised;         ///< True if the object was irreversibly modified since first read
+    bool m_StreamInMemory;    ///< True if the stream must be read in memory, instead of being left in the device
 };
 
 };
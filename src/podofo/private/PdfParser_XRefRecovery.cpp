@@ -0,0 +1,421 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "PdfDeclarationsPrivate.h"
+#include "PdfParser.h"
+
+#include <algorithm>
+
+#include <podofo/auxiliary/StreamDevice.h>
+#include <podofo/main/PdfCommon.h>
+#include <podofo/main/PdfDictionary.h>
+#include <podofo/main/PdfDocument.h>
+#include "PdfObjectStreamParser.h"
+
+using namespace std;
+using namespace PoDoFo;
+
+// Size of the chunks read from the device while scanning the file
+constexpr size_t SCAN_CHUNK_SIZE = 1 << 20;
+// Bytes of the previous chunk kept in front of the next one,
+// so object headers can be matched across the chunk boundaries
+constexpr size_t SCAN_OVERLAP = 64;
+// Bytes that must follow a keyword start to fully match it
+constexpr size_t SCAN_TAIL = 16;
+
+static bool tryReadObjectHeader(const char* buffer, size_t objPos, bool atFileStart,
+    uint32_t& objNum, uint32_t& generation, size_t& headerPos);
+static bool isKeywordEnd(const char* buffer, size_t pos, size_t length, bool eof);
+
+bool PdfParser::rebuildXRefTable(InputStreamDevice& device)
+{
+    m_entries.Clear();
+    m_Trailer = nullptr;
+    m_visitedXRefOffsets.clear();
+    m_recoveredObjectStreams.clear();
+    m_HasXRefStream = false;
+    m_XRefOffset = 0;
+
+    // Scan the file searching for "obj" and "trailer" keywords.
+    // Object definitions found later in the file replace the
+    // previous ones, as it happens with incremental updates
+    vector<size_t> trailerOffsets;
+    charbuff buffer(SCAN_OVERLAP + SCAN_CHUNK_SIZE);
+    size_t bufferOffset = 0;    // Offset in the file of the start of the buffer
+    size_t length = 0;          // Valid bytes in the buffer
+    size_t scanStart = 0;       // Position where to start matching keywords
+    bool eof = false;
+    device.Seek(0);
+    while (!eof)
+    {
+        size_t read = device.Read(buffer.data() + length, SCAN_CHUNK_SIZE, eof);
+        length += read;
+        if (read == 0)
+            eof = true;
+
+        size_t scanEnd = eof ? length : length - std::min(length, SCAN_TAIL);
+        string_view view(buffer.data(), length);
+
+        // "j" is rare in PDF syntax, so it's a fast anchor for "obj"
+        const char* data = buffer.data();
+        size_t pos = scanStart + 2;
+        while (pos < scanEnd + 2 && pos < length)
+        {
+            auto found = (const char*)std::memchr(data + pos, 'j', std::min(scanEnd + 2, length) - pos);
+            if (found == nullptr)
+                break;
+
+            size_t jPos = (size_t)(found - data);
+            pos = jPos + 1;
+            size_t objPos = jPos - 2;
+            if (objPos < scanStart || data[objPos] != 'o' || data[objPos + 1] != 'b'
+                || !isKeywordEnd(data, jPos + 1, length, eof))
+            {
+                continue;
+            }
+
+            uint32_t objNum;
+            uint32_t generation;
+            size_t headerPos;
+            if (!tryReadObjectHeader(data, objPos, bufferOffset == 0, objNum, generation, headerPos)
+                || objNum == 0 || objNum >= PdfCommon::GetMaxObjectCount())
+            {
+                continue;
+            }
+
+            m_entries.Enlarge(objNum + 1);
+            auto& entry = m_entries[objNum];
+            entry = PdfXRefEntry::CreateInUse(bufferOffset + headerPos, (uint16_t)generation);
+            entry.Parsed = true;
+        }
+
+        pos = scanStart;
+        while ((pos = view.find("trailer", pos)) < scanEnd)
+        {
+            if (isKeywordEnd(data, pos + 7, length, eof)
+                && (pos == 0 || PoDoFo::IsCharWhitespace(data[pos - 1]) || PoDoFo::IsCharDelimiter(data[pos - 1])))
+            {
+                trailerOffsets.push_back(bufferOffset + pos);
+            }
+
+            pos++;
+        }
+
+        if (eof)
+            break;
+
+        // Keep the last bytes for the lookbehind of the object headers
+        size_t keep = std::min(length, SCAN_OVERLAP);
+        std::memmove(buffer.data(), buffer.data() + length - keep, keep);
+        bufferOffset += length - keep;
+        scanStart = scanEnd - (length - keep);
+        length = keep;
+    }
+
+    if (m_entries.GetSize() == 0)
+        return false;
+
+    auto& zeroEntry = m_entries[0];
+    zeroEntry = PdfXRefEntry::CreateFree(0, 65535);
+    zeroEntry.Parsed = true;
+
+    // Look for the dictionaries that are relevant to
+    // recover the document: xref streams can act as
+    // trailers, object streams hold compressed objects
+    vector<size_t> xrefStreamNums;
+    uint32_t catalogNum = 0;
+    for (unsigned i = 1; i < m_entries.GetSize(); i++)
+    {
+        auto& entry = m_entries[i];
+        if (!entry.Parsed)
+            continue;
+
+        PdfName type;
+        if (!tryReadObjectType(device, (size_t)entry.Offset, type))
+            continue;
+
+        if (type == "XRef")
+            xrefStreamNums.push_back(i);
+        else if (type == "ObjStm")
+            m_recoveredObjectStreams.push_back(i);
+        else if (type == "Catalog")
+            catalogNum = i;
+    }
+
+    // Create a new trailer and merge in it the candidate trailers,
+    // ranked by file position so the most recent take the precedence.
+    // The device of the trailer is not needed after it's parsed
+    SpanStreamDevice trailerDevice("<< >>");
+    m_Trailer.reset(new PdfParserObject(m_Objects->GetDocument(), trailerDevice, -1));
+    m_Trailer->SetIsTrailer(true);
+    m_Trailer->Parse();
+    m_Trailer->SetRevised();
+
+    vector<pair<size_t, uint32_t>> trailers;
+    for (size_t offset : trailerOffsets)
+        trailers.push_back({ offset, 0 });
+    for (uint32_t num : xrefStreamNums)
+        trailers.push_back({ (size_t)m_entries[num].Offset, num });
+
+    std::sort(trailers.begin(), trailers.end());
+    for (auto it = trailers.rbegin(); it != trailers.rend(); it++)
+    {
+        unique_ptr<PdfParserObject> trailer;
+        try
+        {
+            if (it->second == 0)
+            {
+                device.Seek(it->first);
+                string_view token;
+                PdfTokenizer tokenizer(m_buffer);
+                (void)tokenizer.TryReadNextToken(device, token);
+                trailer.reset(new PdfParserObject(m_Objects->GetDocument(), device, -1));
+                trailer->SetIsTrailer(true);
+            }
+            else
+            {
+                auto& entry = m_entries[it->second];
+                trailer.reset(new PdfParserObject(m_Objects->GetDocument(),
+                    PdfReference(it->second, (uint16_t)entry.Generation), device, (ssize_t)entry.Offset));
+            }
+
+            trailer->Parse();
+            if (!trailer->IsDictionary())
+                continue;
+
+            mergeTrailer(*trailer);
+        }
+        catch (PdfError&)
+        {
+            // Skip broken trailers
+        }
+    }
+
+    auto& trailerDict = m_Trailer->GetDictionary();
+    PdfReference rootRef;
+    auto rootObj = trailerDict.GetKey("Root");
+    bool hasRoot = rootObj != nullptr && rootObj->TryGetReference(rootRef) && isObjectHeaderValid(device, rootRef);
+    if (!hasRoot && catalogNum != 0)
+    {
+        trailerDict.AddKey("Root"_n, PdfReference(catalogNum, (uint16_t)m_entries[catalogNum].Generation));
+        hasRoot = true;
+    }
+
+    // The catalog may be still found in the object streams
+    if (!hasRoot && (rootObj == nullptr || m_recoveredObjectStreams.empty()))
+        return false;
+
+    trailerDict.AddKey("Size"_n, (int64_t)m_entries.GetSize());
+    PoDoFo::LogMessage(PdfLogSeverity::Warning, "Rebuilt the xref table with {} entries", m_entries.GetSize());
+    return true;
+}
+
+void PdfParser::recoverCompressedEntries(InputStreamDevice& device)
+{
+    // Process the object streams in file order, so the
+    // most recent definition of each object takes the precedence
+    std::sort(m_recoveredObjectStreams.begin(), m_recoveredObjectStreams.end(),
+        [this](uint32_t lhs, uint32_t rhs) { return m_entries[lhs].Offset < m_entries[rhs].Offset; });
+
+    vector<uint32_t> objectNumbers;
+    for (uint32_t streamNum : m_recoveredObjectStreams)
+    {
+        uint64_t streamOffset = m_entries[streamNum].Offset;
+        try
+        {
+            PdfParserObject streamObj(m_Objects->GetDocument(),
+                PdfReference(streamNum, (uint16_t)m_entries[streamNum].Generation), device, (ssize_t)streamOffset);
+            streamObj.SetEncrypt(m_Encrypt);
+
+            // The objects are not loaded yet, so an indirect
+            // /Length is resolved from the rebuilt table
+            auto& streamDict = streamObj.GetDictionary();
+            auto lengthObj = streamDict.GetKey("Length");
+            PdfReference lengthRef;
+            if (lengthObj != nullptr && lengthObj->TryGetReference(lengthRef))
+            {
+                int64_t streamLength;
+                if (lengthRef.ObjectNumber() >= m_entries.GetSize())
+                    PODOFO_RAISE_ERROR(PdfErrorCode::InvalidStream);
+
+                auto& lengthEntry = m_entries[lengthRef.ObjectNumber()];
+                if (!lengthEntry.Parsed || lengthEntry.Type != PdfXRefEntryType::InUse)
+                    PODOFO_RAISE_ERROR(PdfErrorCode::InvalidStream);
+
+                PdfParserObject lengthNumObj(m_Objects->GetDocument(), lengthRef, device, (ssize_t)lengthEntry.Offset);
+                if (!lengthNumObj.TryGetNumber(streamLength))
+                    PODOFO_RAISE_ERROR(PdfErrorCode::InvalidStream);
+
+                streamDict.AddKey("Length"_n, streamLength);
+            }
+
+            PdfObjectStreamParser parser(streamObj, *m_Objects, m_buffer);
+            parser.ReadObjectNumbers(objectNumbers);
+        }
+        catch (PdfError&)
+        {
+            PoDoFo::LogMessage(PdfLogSeverity::Warning, "Unable to read the object stream {} while rebuilding the xref table", streamNum);
+            continue;
+        }
+
+        for (unsigned i = 0; i < objectNumbers.size(); i++)
+        {
+            uint32_t objNum = objectNumbers[i];
+            if (objNum == 0 || objNum == streamNum || objNum >= PdfCommon::GetMaxObjectCount())
+                continue;
+
+            m_entries.Enlarge(objNum + 1);
+            auto& entry = m_entries[objNum];
+            if (entry.Parsed)
+            {
+                // Keep definitions that follow the object stream
+                uint64_t entryOffset = entry.Type == PdfXRefEntryType::Compressed
+                    ? m_entries[(unsigned)entry.ObjectNumber].Offset : entry.Offset;
+                if (entryOffset > streamOffset)
+                    continue;
+            }
+
+            entry = PdfXRefEntry::CreateCompressed(streamNum, i);
+            entry.Parsed = true;
+        }
+    }
+
+    m_recoveredObjectStreams.clear();
+}
+
+bool PdfParser::tryReadObjectType(InputStreamDevice& device, size_t offset, PdfName& type)
+{
+    try
+    {
+        int64_t num;
+        int64_t gen;
+        string_view token;
+        PdfVariant variant;
+        const PdfDictionary* dict;
+        const PdfName* typeName;
+        PdfTokenizer tokenizer(m_buffer);
+        device.Seek(offset);
+        if (!tokenizer.TryReadNextNumber(device, num)
+            || !tokenizer.TryReadNextNumber(device, gen)
+            || !tokenizer.TryReadNextToken(device, token) || token != "obj"
+            || !tokenizer.TryReadNextVariant(device, variant)
+            || !variant.TryGetDictionary(dict)
+            || !dict->TryFindKeyAs("Type", typeName))
+        {
+            return false;
+        }
+
+        type = *typeName;
+        return true;
+    }
+    catch (PdfError&)
+    {
+        return false;
+    }
+}
+
+bool PdfParser::isObjectHeaderValid(InputStreamDevice& device, const PdfReference& ref)
+{
+    if (ref.ObjectNumber() >= m_entries.GetSize())
+        return false;
+
+    auto& entry = m_entries[ref.ObjectNumber()];
+    if (!entry.Parsed)
+        return false;
+
+    switch (entry.Type)
+    {
+        case PdfXRefEntryType::InUse:
+        {
+            try
+            {
+                int64_t num;
+                int64_t gen;
+                string_view token;
+                PdfTokenizer tokenizer(m_buffer);
+                device.Seek((size_t)entry.Offset);
+                return tokenizer.TryReadNextNumber(device, num) && num == ref.ObjectNumber()
+                    && tokenizer.TryReadNextNumber(device, gen)
+                    && tokenizer.TryReadNextToken(device, token) && token == "obj";
+            }
+            catch (PdfError&)
+            {
+                return false;
+            }
+        }
+        case PdfXRefEntryType::Compressed:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Match backward "num gen" preceding the "obj" keyword
+bool tryReadObjectHeader(const char* buffer, size_t objPos, bool atFileStart,
+    uint32_t& objNum, uint32_t& generation, size_t& headerPos)
+{
+    size_t pos = objPos;
+    while (pos > 0 && PoDoFo::IsCharWhitespace(buffer[pos - 1]))
+        pos--;
+
+    size_t genEnd = pos;
+    uint64_t gen = 0;
+    uint64_t multiplier = 1;
+    while (pos > 0 && buffer[pos - 1] >= '0' && buffer[pos - 1] <= '9' && genEnd - pos < 5)
+    {
+        pos--;
+        gen += (uint64_t)(buffer[pos] - '0') * multiplier;
+        multiplier *= 10;
+    }
+
+    if (pos == genEnd || gen > numeric_limits<uint16_t>::max())
+        return false;
+
+    size_t numEnd = pos;
+    while (pos > 0 && PoDoFo::IsCharWhitespace(buffer[pos - 1]))
+        pos--;
+
+    if (pos == numEnd)
+        return false;
+
+    numEnd = pos;
+    uint64_t num = 0;
+    multiplier = 1;
+    while (pos > 0 && buffer[pos - 1] >= '0' && buffer[pos - 1] <= '9' && numEnd - pos < 10)
+    {
+        pos--;
+        num += (uint64_t)(buffer[pos] - '0') * multiplier;
+        multiplier *= 10;
+    }
+
+    if (pos == numEnd || num > numeric_limits<uint32_t>::max())
+        return false;
+
+    // The number must start after a delimiter. At the start of
+    // the buffer we can't know it, unless it's the file start
+    if (pos == 0)
+    {
+        if (!atFileStart)
+            return false;
+    }
+    else if (!PoDoFo::IsCharWhitespace(buffer[pos - 1]) && !PoDoFo::IsCharDelimiter(buffer[pos - 1]))
+    {
+        return false;
+    }
+
+    objNum = (uint32_t)num;
+    generation = (uint32_t)gen;
+    headerPos = pos;
+    return true;
+}
+
+bool isKeywordEnd(const char* buffer, size_t pos, size_t length, bool eof)
+{
+    if (pos == length)
+        return eof;
+
+    return PoDoFo::IsCharWhitespace(buffer[pos]) || PoDoFo::IsCharDelimiter(buffer[pos]);
+}
@@ -0,0 +1,238 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "PdfDeclarationsPrivate.h"
+#include "PdfPassthroughObjectStream.h"
+
+#include <podofo/auxiliary/StreamDevice.h>
+#include <podofo/main/PdfMemoryObjectStream.h>
+#include <podofo/main/PdfStatefulEncrypt.h>
+
+using namespace std;
+using namespace PoDoFo;
+
+// Input stream reading a range of a shared device. The
+// device is positioned before each read, since other
+// readers may have moved it in the meantime
+class PdfPassthroughObjectStream::SourceInputStream final : public InputStream
+{
+public:
+    SourceInputStream(InputStreamDevice& device, size_t offset, size_t length) :
+        m_device(&device),
+        m_Offset(offset),
+        m_Length(length),
+        m_Position(0)
+    {
+    }
+
+protected:
+    size_t readBuffer(char* buffer, size_t size, bool& eof) override
+    {
+        size_t count = std::min(size, m_Length - m_Position);
+        if (count == 0)
+        {
+            eof = true;
+            return 0;
+        }
+
+        m_device->Seek(m_Offset + m_Position);
+        bool deviceEof;
+        count = ReadBuffer(*m_device, buffer, count, deviceEof);
+        m_Position += count;
+        eof = deviceEof || m_Position == m_Length;
+        return count;
+    }
+
+private:
+    InputStreamDevice* m_device;
+    size_t m_Offset;
+    size_t m_Length;
+    size_t m_Position;
+};
+
+PdfPassthroughObjectStream::PdfPassthroughObjectStream(InputStreamDevice& device, size_t offset, size_t length) :
+    m_device(&device),
+    m_Offset(offset),
+    m_Length(length)
+{
+    // Prefer reading directly from memory when the device allows it
+    auto mapped = dynamic_cast<const MappedFileStreamDevice*>(&device);
+    if (mapped != nullptr)
+    {
+        m_view = mapped->GetView();
+    }
+    else
+    {
+        auto span = dynamic_cast<const SpanStreamDevice*>(&device);
+        if (span != nullptr)
+            m_view = span->GetView();
+    }
+}
+
+void PdfPassthroughObjectStream::Init(PdfObject& obj)
+{
+    (void)obj;
+}
+
+void PdfPassthroughObjectStream::Clear()
+{
+    reset();
+}
+
+bool PdfPassthroughObjectStream::TryCopyFrom(const PdfObjectStreamProvider& rhs)
+{
+    auto passthrough = dynamic_cast<const PdfPassthroughObjectStream*>(&rhs);
+    if (passthrough != nullptr)
+    {
+        // NOTE: The copy may outlive the source device
+        charbuff buffer;
+        passthrough->CopyTo(buffer);
+        reset();
+        m_buffer = std::move(buffer);
+        return true;
+    }
+
+    auto memstream = dynamic_cast<const PdfMemoryObjectStream*>(&rhs);
+    if (memstream == nullptr)
+        return false;
+
+    reset();
+    m_buffer = memstream->GetBuffer();
+    return true;
+}
+
+bool PdfPassthroughObjectStream::TryMoveFrom(PdfObjectStreamProvider&& rhs)
+{
+    auto passthrough = dynamic_cast<PdfPassthroughObjectStream*>(&rhs);
+    if (passthrough != nullptr)
+    {
+        passthrough->Detach();
+        reset();
+        m_buffer = std::move(passthrough->m_buffer);
+        passthrough->reset();
+        return true;
+    }
+
+    auto memstream = dynamic_cast<PdfMemoryObjectStream*>(&rhs);
+    if (memstream == nullptr)
+        return false;
+
+    reset();
+    m_buffer = std::move(memstream->m_buffer);
+    return true;
+}
+
+unique_ptr<InputStream> PdfPassthroughObjectStream::GetInputStream(PdfObject& obj)
+{
+    (void)obj;
+    if (m_device == nullptr)
+        return unique_ptr<InputStream>(new SpanStreamDevice(m_buffer));
+
+    return getSourceStream();
+}
+
+unique_ptr<OutputStream> PdfPassthroughObjectStream::GetOutputStream(PdfObject& obj)
+{
+    (void)obj;
+
+    // Writing detaches the stream from the source device
+    reset();
+    return unique_ptr<OutputStream>(new StringStreamDevice(m_buffer));
+}
+
+void PdfPassthroughObjectStream::Write(OutputStream& stream, const PdfStatefulEncrypt* encrypt)
+{
+    stream.Write("stream\n");
+    if (encrypt != nullptr)
+    {
+        // Encrypt while copying, so the source data is never
+        // loaded in memory as a whole
+        auto output = encrypt->CreateEncryptionOutputStream(stream);
+        if (m_device == nullptr)
+            output->Write(m_buffer.data(), m_buffer.size());
+        else if (m_view.size() != 0)
+            output->Write(m_view.data() + m_Offset, m_Length);
+        else
+            getSourceStream()->CopyTo(*output, m_Length);
+
+        output->Close();
+    }
+    else if (m_device == nullptr)
+    {
+        stream.Write(string_view(m_buffer.data(), m_buffer.size()));
+    }
+    else if (m_view.size() != 0)
+    {
+        stream.Write(string_view(m_view.data() + m_Offset, m_Length));
+    }
+    else
+    {
+        // Copy the raw data from the source device in chunks
+        auto input = getSourceStream();
+        input->CopyTo(stream, m_Length);
+    }
+
+    stream.Write("\nendstream\n");
+    stream.Flush();
+}
+
+size_t PdfPassthroughObjectStream::GetLength() const
+{
+    return m_device == nullptr ? m_buffer.size() : m_Length;
+}
+
+void PdfPassthroughObjectStream::CopyTo(charbuff& buffer) const
+{
+    if (m_device == nullptr)
+    {
+        buffer = m_buffer;
+        return;
+    }
+
+    buffer.resize(m_Length);
+    auto input = getSourceStream();
+    input->Read(buffer.data(), m_Length);
+}
+
+void PdfPassthroughObjectStream::EnsureConcurrentRead()
+{
+    if (m_device == nullptr || m_view.size() != 0)
+        return;
+
+    // Reading from the view doesn't touch the device position,
+    // otherwise load the data now
+    Detach();
+}
+
+void PdfPassthroughObjectStream::Detach()
+{
+    if (m_device == nullptr)
+        return;
+
+    // NOTE: It's still the unmodified source data,
+    // so the stream is written the same
+    charbuff buffer;
+    CopyTo(buffer);
+    reset();
+    m_buffer = std::move(buffer);
+}
+
+unique_ptr<InputStream> PdfPassthroughObjectStream::getSourceStream() const
+{
+    if (m_view.size() != 0)
+        return unique_ptr<InputStream>(new SpanStreamDevice(m_view.data() + m_Offset, m_Length));
+
+    return unique_ptr<InputStream>(new SourceInputStream(*m_device, m_Offset, m_Length));
+}
+
+void PdfPassthroughObjectStream::reset()
+{
+    m_device = nullptr;
+    m_view = { };
+    m_Offset = 0;
+    m_Length = 0;
+    m_buffer.clear();
+}
@@ -0,0 +1,92 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#ifndef PDF_PASSTHROUGH_OBJECT_STREAM_H
+#define PDF_PASSTHROUGH_OBJECT_STREAM_H
+
+#include <podofo/main/PdfObjectStreamProvider.h>
+
+namespace PoDoFo {
+
+class InputStreamDevice;
+
+/** A stream provider whose data is left in the source device
+ * the object was parsed from
+ *
+ * The raw data is read on demand and, when the stream is
+ * serialized unmodified, it's copied straight from the source.
+ * As soon as new data is written, or it's cleared, the stream
+ * switches to hold its data in memory, like PdfMemoryObjectStream
+ *
+ * \remarks The source device must outlive the stream, so the data
+ * is read in memory when the stream is copied or moved to another
+ * object. When the device exposes a contiguous view of its contents
+ * (eg. it's a MappedFileStreamDevice or a SpanStreamDevice) reading
+ * doesn't touch the device position
+ */
+class PdfPassthroughObjectStream final : public PdfObjectStreamProvider
+{
+    class SourceInputStream;
+
+public:
+    /**
+     * \param device the device the object was parsed from
+     * \param offset the offset of the raw stream data in the device
+     * \param length the length of the raw stream data
+     */
+    PdfPassthroughObjectStream(InputStreamDevice& device, size_t offset, size_t length);
+
+public:
+    void Init(PdfObject& obj) override;
+
+    void Clear() override;
+
+    bool TryCopyFrom(const PdfObjectStreamProvider& rhs) override;
+
+    bool TryMoveFrom(PdfObjectStreamProvider&& rhs) override;
+
+    std::unique_ptr<InputStream> GetInputStream(PdfObject& obj) override;
+
+    std::unique_ptr<OutputStream> GetOutputStream(PdfObject& obj) override;
+
+    void Write(OutputStream& stream, const PdfStatefulEncrypt* encrypt) override;
+
+    size_t GetLength() const override;
+
+    /** Copy the raw stream data to the given buffer
+     */
+    void CopyTo(charbuff& buffer) const;
+
+    /** True if the data is still backed by the source device
+     */
+    bool IsPassthrough() const { return m_device != nullptr; }
+
+    /** Read the raw data in memory if the source device doesn't
+     * expose a contiguous view, so the stream can be read
+     * concurrently with other streams from the same source
+     */
+    void EnsureConcurrentRead();
+
+    /** Read the raw data in memory, so the stream
+     * doesn't refer the source device anymore
+     */
+    void Detach();
+
+private:
+    std::unique_ptr<InputStream> getSourceStream() const;
+    void reset();
+
+private:
+    InputStreamDevice* m_device;
+    bufferview m_view;
+    size_t m_Offset;
+    size_t m_Length;
+    charbuff m_buffer;
+};
+
+}
+
+#endif // PDF_PASSTHROUGH_OBJECT_STREAM_H
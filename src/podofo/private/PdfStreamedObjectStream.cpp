@@ -23,15 +23,20 @@ public:
     {
     }
 
-    ObjectOutputStream(PdfStreamedObjectStream& stream, unique_ptr<OutputStream> outputStream) :
+    ObjectOutputStream(PdfStreamedObjectStream& stream, unique_ptr<PdfEncryptOutputStream> outputStream) :
         m_objectStream(&stream),
         m_outputStream(outputStream.get()),
-        m_outputStreamStore(std::move(outputStream))
+        m_encryptStream(std::move(outputStream))
     {
     }
 
     ~ObjectOutputStream()
     {
+        // Close the encryption stream, if any, so it writes its last
+        // block, unless it's being destroyed because of an exception
+        if (m_encryptStream != nullptr && std::uncaught_exceptions() == 0)
+            m_encryptStream->Close();
+
         Flush(*m_outputStream);
         m_objectStream->FinishOutput();
     }
@@ -51,7 +56,7 @@ protected:
 private:
     PdfStreamedObjectStream* m_objectStream;
     OutputStream* m_outputStream;
-    std::unique_ptr<OutputStream> m_outputStreamStore;
+    std::unique_ptr<PdfEncryptOutputStream> m_encryptStream;
 };
 
 PdfStreamedObjectStream::PdfStreamedObjectStream(OutputStreamDevice& device) :
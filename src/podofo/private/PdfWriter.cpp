@@ -7,9 +7,12 @@
 #include "PdfDeclarationsPrivate.h"
 #include "PdfWriter.h"
 
+#include <thread>
+
 #include <podofo/auxiliary/StreamDevice.h>
 #include <podofo/main/PdfDate.h>
 #include <podofo/main/PdfDictionary.h>
+#include <podofo/main/PdfMemoryObjectStream.h>
 #include "PdfParserObject.h"
 #include "PdfXRefStream.h"
 #include "OpenSSLInternal.h"
@@ -33,6 +36,7 @@ PdfWriter::PdfWriter(PdfIndirectObjectList* objects, const PdfObject& trailer) :
     m_EncryptObj(nullptr),
     m_SaveOptions(PdfSaveOptions::None),
     m_WriteFlags(PdfWriteFlags::None),
+    m_ObjectStreamSize(PdfObjectStreamSizeDefault),
     m_PrevXRefOffset(0),
     m_IncrementalUpdate(false),
     m_rewriteXRefTable(false)
@@ -79,26 +83,35 @@ void PdfWriter::Write(OutputStreamDevice& device)
         m_Encrypt->GetEncrypt().CreateEncryptionDictionary(m_EncryptObj->GetDictionary());
     }
 
+    // NOTE: The XRef is created only when not linearizing, since
+    // a XRef stream adds its object to the document
     unique_ptr<PdfXRef> xRef;
-    if (m_UseXRefStream)
-        xRef.reset(new PdfXRefStream(*this));
-    else
-        xRef.reset(new PdfXRef(*this));
-
     try
     {
-        if (!m_IncrementalUpdate)
-            WritePdfHeader(device);
+        if (m_IncrementalUpdate
+            || (m_SaveOptions & PdfSaveOptions::Linearize) == PdfSaveOptions::None
+            || !tryWriteLinearized(device))
+        {
+            if (m_UseXRefStream)
+                xRef.reset(new PdfXRefStream(*this));
+            else
+                xRef.reset(new PdfXRef(*this));
 
-        WritePdfObjects(device, *m_Objects, *xRef);
+            if (!m_IncrementalUpdate)
+                WritePdfHeader(device);
 
-        if (m_IncrementalUpdate)
-            xRef->SetFirstEmptyBlock();
+            WritePdfObjects(device, *m_Objects, *xRef);
 
-        xRef->Write(device, m_buffer);
+            if (m_IncrementalUpdate)
+                xRef->SetFirstEmptyBlock();
+
+            xRef->Write(device, m_buffer);
+        }
     }
     catch (PdfError& e)
     {
+        removeXRefStreamObject(xRef.get());
+
         // P.Zent: Delete Encryption dictionary (cannot be reused)
         if (m_EncryptObj != nullptr)
         {
@@ -110,6 +123,8 @@ void PdfWriter::Write(OutputStreamDevice& device)
         throw;
     }
 
+    removeXRefStreamObject(xRef.get());
+
     // P.Zent: Delete Encryption dictionary (cannot be reused)
     if (m_EncryptObj != nullptr)
     {
@@ -128,13 +143,29 @@ void PdfWriter::WritePdfHeader(OutputStreamDevice& device)
 
 void PdfWriter::WritePdfObjects(OutputStreamDevice& device, const PdfIndirectObjectList& objects, PdfXRef& xref)
 {
+    // Object streams require a XRef stream. They are not
+    // written in incremental updates, since the numbers of
+    // the object streams are not reserved in the document
+    bool compressObjects = m_UseXRefStream && !m_IncrementalUpdate
+        && (m_SaveOptions & PdfSaveOptions::CompressObjects) != PdfSaveOptions::None;
+    vector<PdfObject*> compressedObjects;
+
+    if ((m_SaveOptions & PdfSaveOptions::ParallelCompress) != PdfSaveOptions::None)
+        compressStreamsParallel(objects);
+
+    // The same encrypt instance is reused for all the objects
     unique_ptr<PdfStatefulEncrypt> encrypt;
+    if (m_Encrypt != nullptr)
+        encrypt.reset(new PdfStatefulEncrypt(m_Encrypt->GetEncrypt(), m_Encrypt->GetContext(), PdfReference()));
+
     for (PdfObject* obj : objects)
     {
-        if (m_Encrypt != nullptr && obj != m_EncryptObj)
-            encrypt.reset(new PdfStatefulEncrypt(m_Encrypt->GetEncrypt(), m_Encrypt->GetContext(), obj->GetIndirectReference()));
-        else
-            encrypt.reset();
+        const PdfStatefulEncrypt* objEncrypt = nullptr;
+        if (encrypt != nullptr && obj != m_EncryptObj)
+        {
+            encrypt->SetCurrentReference(obj->GetIndirectReference());
+            objEncrypt = encrypt.get();
+        }
 
         if (m_IncrementalUpdate && !obj->IsDirty())
         {
@@ -172,20 +203,161 @@ void PdfWriter::WritePdfObjects(OutputStreamDevice& device, const PdfIndirectObj
             // offset of the object and not retrieve it from the device
             xref.AddInUseObject(obj->GetIndirectReference(), 0xFFFFFFFF);
         }
+        else if (compressObjects && isCompressible(*obj, xref))
+        {
+            // The object will be written later in an object stream
+            compressedObjects.push_back(obj);
+        }
         else
         {
             xref.AddInUseObject(obj->GetIndirectReference(), device.GetPosition());
             // Also make sure that we do not encrypt the encryption dictionary!
-            obj->WriteFinal(device, m_WriteFlags, encrypt.get(), m_buffer);
+            obj->WriteFinal(device, m_WriteFlags, objEncrypt, m_buffer);
         }
     }
 
+    if (compressedObjects.size() != 0)
+        writeObjectStreams(device, compressedObjects, xref);
+
     for (auto& freeObjectRef : objects.GetFreeObjects())
     {
         xref.AddFreeObject(freeObjectRef);
     }
 }
 
+void PdfWriter::compressStreamsParallel(const PdfIndirectObjectList& objects)
+{
+    // Collect the streams that would be compressed while
+    // writing. Loading the streams and checking them is done
+    // on the current thread, since it may access the source
+    // device and other objects of the document
+    vector<PdfObject*> toCompress;
+    for (PdfObject* obj : objects)
+    {
+        if ((m_IncrementalUpdate && !obj->IsDirty()) || !obj->HasStream()
+            || !obj->ShouldCompressStream(m_WriteFlags))
+        {
+            continue;
+        }
+
+        // Only data held in memory can be safely read concurrently
+        const PdfObjectStream& stream = *obj->GetStream();
+        if (dynamic_cast<const PdfMemoryObjectStream*>(&stream.GetProvider()) != nullptr)
+            toCompress.push_back(obj);
+    }
+
+    unsigned threadCount = std::min((unsigned)toCompress.size(), std::max(1u, thread::hardware_concurrency()));
+    if (threadCount < 2)
+        return;
+
+    // The streams are compressed exactly as they would be while
+    // writing, which will then find them already filtered
+    vector<exception_ptr> errors(threadCount);
+    auto run = [&](unsigned threadIndex)
+    {
+        try
+        {
+            for (size_t i = threadIndex; i < toCompress.size(); i += threadCount)
+                toCompress[i]->CompressStream();
+        }
+        catch (...)
+        {
+            errors[threadIndex] = std::current_exception();
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; i++)
+        threads.emplace_back(run, i);
+
+    // Use also the current thread
+    run(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors)
+    {
+        if (error != nullptr)
+            std::rethrow_exception(error);
+    }
+}
+
+bool PdfWriter::isCompressible(const PdfObject& obj, PdfXRef& xref) const
+{
+    // ISO 32000-2:2020 7.5.7 "Object streams": streams, objects
+    // with a generation number other than zero and the encryption
+    // dictionary shall not be stored in an object stream
+    return obj.GetIndirectReference().GenerationNumber() == 0
+        && &obj != m_EncryptObj
+        && !obj.HasStream()
+        && !xref.ShouldSkipWrite(obj.GetIndirectReference());
+}
+
+void PdfWriter::removeXRefStreamObject(PdfXRef* xref)
+{
+    auto xrefStream = dynamic_cast<PdfXRefStream*>(xref);
+    if (xrefStream == nullptr)
+        return;
+
+    m_Objects->RemoveObject(xrefStream->m_xrefStreamObj->GetIndirectReference());
+}
+
+void PdfWriter::writeObjectStreams(OutputStreamDevice& device, const vector<PdfObject*>& objects, PdfXRef& xref)
+{
+    // The object streams are not added to the document: just
+    // take object numbers following the ones currently in use.
+    // NOTE: The generation of object streams must be 0
+    uint32_t objStreamNum = m_Objects->GetObjectCount();
+    unique_ptr<PdfStatefulEncrypt> encrypt;
+    if (m_Encrypt != nullptr)
+        encrypt.reset(new PdfStatefulEncrypt(m_Encrypt->GetEncrypt(), m_Encrypt->GetContext(), PdfReference()));
+
+    charbuff header;
+    charbuff data;
+    for (size_t i = 0; i < objects.size(); i += m_ObjectStreamSize)
+    {
+        size_t count = std::min((size_t)m_ObjectStreamSize, objects.size() - i);
+        objStreamNum++;
+        header.clear();
+        data.clear();
+
+        // Objects in object streams are not encrypted
+        // by themselves, the whole stream is encrypted
+        {
+            StringStreamDevice dataDevice(data);
+            for (size_t j = 0; j < count; j++)
+            {
+                auto& obj = *objects[i + j];
+                auto& ref = obj.GetIndirectReference();
+                header.append(utls::Format("{} {} ", ref.ObjectNumber(), dataDevice.GetPosition()));
+                obj.GetVariant().Write(dataDevice, m_WriteFlags, nullptr, m_buffer);
+                dataDevice.Write('\n');
+                obj.ResetDirty();
+                xref.AddCompressedObject(ref, objStreamNum, static_cast<uint32_t>(j));
+            }
+        }
+
+        PdfObject objStream;
+        objStream.SetIndirectReference(PdfReference(objStreamNum, 0));
+        auto& dict = objStream.GetDictionaryUnsafe();
+        dict.AddKey("Type"_n, "ObjStm"_n);
+        dict.AddKey("N"_n, static_cast<int64_t>(count));
+        dict.AddKey("First"_n, static_cast<int64_t>(header.size()));
+        header.append(data);
+
+        // Write the stream unfiltered: it will be flate
+        // compressed on write, unless it's disabled
+        objStream.GetOrCreateStream().SetData(header, true);
+
+        if (encrypt != nullptr)
+            encrypt->SetCurrentReference(objStream.GetIndirectReference());
+
+        xref.AddInUseObject(objStream.GetIndirectReference(), device.GetPosition());
+        objStream.WriteFinal(device, m_WriteFlags, encrypt.get(), m_buffer);
+    }
+}
+
 void PdfWriter::FillTrailerObject(PdfObject& trailer, size_t size, bool onlySizeKey) const
 {
     trailer.GetDictionary().AddKey("Size"_n, static_cast<int64_t>(size));
@@ -229,6 +401,12 @@ void PdfWriter::SetSaveOptions(PdfSaveOptions saveOptions)
     initWriteFlags();
 }
 
+void PdfWriter::SetObjectStreamSize(unsigned size)
+{
+    PODOFO_ASSERT(size != 0 && size <= numeric_limits<uint16_t>::max());
+    m_ObjectStreamSize = size;
+}
+
 void PdfWriter::SetPdfALevel(PdfALevel level)
 {
     m_PdfALevel = level;
@@ -88,6 +88,13 @@ public:
 
     void SetPdfALevel(PdfALevel level);
 
+    /** Set the maximum number of objects packed in a single
+     *  object stream, when writing with PdfSaveOptions::CompressObjects
+     */
+    void SetObjectStreamSize(unsigned size);
+
+    inline unsigned GetObjectStreamSize() const { return m_ObjectStreamSize; }
+
     inline PdfALevel GetPdfALevel() const { return m_PdfALevel; }
 
     /**
@@ -168,6 +175,44 @@ protected:
 private:
     void initWriteFlags();
 
+    bool isCompressible(const PdfObject& obj, PdfXRef& xref) const;
+
+    /** Remove from the document the object of a written XRef
+     * stream, if any, since a new one is created on every write
+     */
+    void removeXRefStreamObject(PdfXRef* xref);
+
+    /** Flate compress in advance the streams of the objects
+     * to be written, splitting them among multiple threads
+     */
+    void compressStreamsParallel(const PdfIndirectObjectList& objects);
+
+    void writeObjectStreams(OutputStreamDevice& device, const std::vector<PdfObject*>& objects, PdfXRef& xref);
+
+    // Linearized writing, see PdfWriter_Linearization.cpp
+    struct LinearizedLayout;
+    struct LinearizedOffsets;
+
+    /** Write a linearized document
+     * \returns false if the document can't be linearized and
+     * nothing was written
+     */
+    bool tryWriteLinearized(OutputStreamDevice& device);
+
+    bool tryCreateLinearizedLayout(LinearizedLayout& layout);
+
+    /** Write the objects in the linearized order
+     * \param hint the serialized hint stream, or nullptr
+     * when measuring the offsets as if it was absent
+     */
+    void writeLinearizedParts(OutputStreamDevice& device, const LinearizedLayout& layout,
+        const charbuff* hint, LinearizedOffsets& offsets);
+
+    void writeLinearizedObject(OutputStreamDevice& device, const LinearizedLayout& layout,
+        PdfObject& obj, PdfStatefulEncrypt* encrypt);
+
+    void createLinearizedHintStream(const LinearizedLayout& layout, charbuff& hint);
+
 protected:
     charbuff m_buffer;
 
@@ -185,6 +230,7 @@ private:
 
     PdfSaveOptions m_SaveOptions;
     PdfWriteFlags m_WriteFlags;
+    unsigned m_ObjectStreamSize;
 
     PdfString m_identifier;
     PdfString m_originalIdentifier; // used for incremental update
@@ -0,0 +1,723 @@
+/**
+ * SPDX-FileCopyrightText: (C) 2025 Francesco Pretto <ceztko@gmail.com>
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "PdfDeclarationsPrivate.h"
+#include "PdfWriter.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <podofo/auxiliary/StreamDevice.h>
+#include <podofo/main/PdfArray.h>
+#include <podofo/main/PdfDictionary.h>
+#include <podofo/main/PdfStatefulEncrypt.h>
+
+using namespace std;
+using namespace PoDoFo;
+
+// Value used to reserve the space of numbers that are written
+// before the offsets they refer to are known. Classic XRef
+// tables limit the offsets to 10 digits anyway
+static constexpr int64_t PlaceholderNumber = 9999999999;
+
+namespace
+{
+    struct ObjectUsage final
+    {
+        int Owner = -1;         // Index of the only page using the object, -2 if shared
+        int Stamp = -1;         // Index of the last page that reached the object
+        bool FirstPage = false; // True if used by the first page
+        bool Assigned = false;  // True if already assigned to a part of the file
+    };
+
+    // Writes the items of the hint tables, which are
+    // stored big-endian with the given count of bits
+    class HintWriter final
+    {
+    public:
+        HintWriter(charbuff& buffer)
+            : m_buffer(&buffer), m_byte(0), m_bitCount(0) { }
+
+        void Write(uint64_t value, unsigned bitCount)
+        {
+            for (unsigned i = bitCount; i > 0; i--)
+            {
+                m_byte = (uint8_t)((m_byte << 1) | ((value >> (i - 1)) & 1));
+                m_bitCount++;
+                if (m_bitCount == 8)
+                {
+                    m_buffer->push_back((char)m_byte);
+                    m_byte = 0;
+                    m_bitCount = 0;
+                }
+            }
+        }
+
+        // Pad the current byte with zeros
+        void Flush()
+        {
+            if (m_bitCount == 0)
+                return;
+
+            m_buffer->push_back((char)(m_byte << (8 - m_bitCount)));
+            m_byte = 0;
+            m_bitCount = 0;
+        }
+
+    private:
+        charbuff* m_buffer;
+        uint8_t m_byte;
+        unsigned m_bitCount;
+    };
+}
+
+static void collectPages(PdfIndirectObjectList& objects, PdfObject& node, vector<PdfObject*>& parents,
+    vector<PdfObject*>& firstPageParents, vector<PdfObject*>& pages, unordered_set<const PdfObject*>& treeNodes);
+template <typename TFunctor>
+static void visitReferences(const PdfObject& obj, const TFunctor& fn);
+static void remapReferences(PdfObject& obj, PdfIndirectObjectList& objects,
+    const unordered_map<const PdfObject*, uint32_t>& numbers);
+static void writePadded(OutputStreamDevice& device, const string_view& str, size_t length);
+static unsigned getBitCount(uint64_t value);
+
+struct PdfWriter::LinearizedOffsets
+{
+    vector<size_t> Objects;     // Offsets of the objects, by object number
+    size_t FirstXRef = 0;       // Offset of the first page XRef table
+    size_t Hint = 0;            // Offset of the primary hint stream
+    size_t FirstPageEnd = 0;    // End of the first page section
+    size_t MainXRef = 0;        // Offset of the main XRef table
+    size_t MainXRefEntries = 0; // Offset of the white-space before the first main XRef entry
+    size_t FileLength = 0;
+};
+
+// The parts of a linearized file, ISO 32000-2:2020 F.3
+struct PdfWriter::LinearizedLayout
+{
+    vector<PdfObject*> FirstPageSection;    // Part 4: catalog, first page ancestors and encryption dictionary
+    vector<PdfObject*> FirstPageObjects;    // Part 6: first page object and all objects it uses
+    vector<vector<PdfObject*>> OtherPages;  // Part 7: remaining pages and their private objects
+    vector<PdfObject*> SharedObjects;       // Part 8: objects shared by the remaining pages
+    vector<PdfObject*> OtherObjects;        // Part 9: everything else
+    vector<vector<unsigned>> SharedReferences; // Shared object hint identifiers, by page index
+    unordered_map<const PdfObject*, uint32_t> Numbers; // The new object numbers
+    uint32_t FirstPageNumber = 0;           // Number of the linearization dictionary
+    uint32_t HintNumber = 0;
+    uint32_t Size = 0;
+    LinearizedOffsets Measured;             // The offsets written as if the hint stream was absent
+    size_t HintLength = 0;
+};
+
+bool PdfWriter::tryWriteLinearized(OutputStreamDevice& device)
+{
+    LinearizedLayout layout;
+    if (!tryCreateLinearizedLayout(layout))
+        return false;
+
+    if ((m_SaveOptions & PdfSaveOptions::ParallelCompress) != PdfSaveOptions::None)
+        compressStreamsParallel(*m_Objects);
+
+    // Compress the streams in advance, since the objects are
+    // written twice and the /Metadata object can be identified
+    // only from the document objects
+    for (PdfObject* obj : *m_Objects)
+    {
+        if (obj->HasStream() && obj->ShouldCompressStream(m_WriteFlags))
+            obj->CompressStream();
+    }
+
+    // The hint tables refer to the offsets of the objects
+    // as if the hint stream was absent: measure them first
+    NullStreamDevice nullDevice;
+    writeLinearizedParts(nullDevice, layout, nullptr, layout.Measured);
+
+    charbuff hint;
+    createLinearizedHintStream(layout, hint);
+    layout.HintLength = hint.size();
+
+    LinearizedOffsets offsets;
+    writeLinearizedParts(device, layout, &hint, offsets);
+
+    // Verify the offsets already written in the linearization
+    // dictionary and in the first page XRef table
+    auto& measured = layout.Measured;
+    bool consistent = offsets.FileLength == measured.FileLength + layout.HintLength
+        && offsets.MainXRef == measured.MainXRef + layout.HintLength;
+    for (uint32_t i = 1; consistent && i < layout.Size; i++)
+    {
+        if (i == layout.HintNumber)
+            continue;
+
+        size_t expected = measured.Objects[i];
+        if (expected >= measured.Hint)
+            expected += layout.HintLength;
+
+        consistent = offsets.Objects[i] == expected;
+    }
+
+    if (!consistent)
+        PODOFO_RAISE_ERROR_INFO(PdfErrorCode::InternalLogic, "Inconsistent offsets while writing the linearized document");
+
+    return true;
+}
+
+bool PdfWriter::tryCreateLinearizedLayout(LinearizedLayout& layout)
+{
+    auto resolve = [&](const PdfObject* obj) -> PdfObject*
+    {
+        PdfReference ref;
+        if (obj == nullptr || !obj->TryGetReference(ref))
+            return nullptr;
+
+        return m_Objects->GetObject(ref);
+    };
+
+    auto catalog = resolve(m_Trailer->GetDictionary().GetKey("Root"));
+    if (catalog == nullptr || !catalog->IsDictionary())
+        return false;
+
+    auto pagesRoot = resolve(catalog->GetDictionary().GetKey("Pages"));
+    if (pagesRoot == nullptr || !pagesRoot->IsDictionary())
+        return false;
+
+    vector<PdfObject*> pages;
+    vector<PdfObject*> parents;
+    vector<PdfObject*> firstPageParents;
+    unordered_set<const PdfObject*> treeNodes;
+    collectPages(*m_Objects, *pagesRoot, parents, firstPageParents, pages, treeNodes);
+    if (pages.size() == 0)
+        return false;
+
+    unordered_map<const PdfObject*, ObjectUsage> usages;
+    usages.reserve(m_Objects->GetSize());
+    for (PdfObject* obj : *m_Objects)
+        usages[obj];
+
+    // Find the objects used by every page, not following /Parent
+    // keys and stopping at the page tree, so other pages are not
+    // reached through annotations or destinations
+    vector<vector<PdfObject*>> pageObjects(pages.size());
+    deque<PdfObject*> queue;
+    for (unsigned i = 0; i < pages.size(); i++)
+    {
+        auto& reached = pageObjects[i];
+        queue.push_back(pages[i]);
+        while (queue.size() != 0)
+        {
+            auto obj = queue.front();
+            queue.pop_front();
+            visitReferences(*obj, [&](const PdfReference& ref)
+            {
+                auto target = m_Objects->GetObject(ref);
+                if (target == nullptr || target == catalog || target == m_EncryptObj
+                    || treeNodes.find(target) != treeNodes.end())
+                {
+                    return;
+                }
+
+                auto found = usages.find(target);
+                if (found == usages.end() || found->second.Stamp == (int)i)
+                    return;
+
+                auto& usage = found->second;
+                usage.Stamp = (int)i;
+                if (usage.Owner == -1)
+                    usage.Owner = (int)i;
+                else if (usage.Owner != (int)i)
+                    usage.Owner = -2;
+
+                if (i == 0)
+                    usage.FirstPage = true;
+
+                reached.push_back(target);
+                queue.push_back(target);
+            });
+        }
+    }
+
+    auto assign = [&](vector<PdfObject*>& part, PdfObject* obj)
+    {
+        auto& usage = usages[obj];
+        if (usage.Assigned)
+            return;
+
+        usage.Assigned = true;
+        part.push_back(obj);
+    };
+
+    assign(layout.FirstPageSection, catalog);
+    for (auto parent : firstPageParents)
+        assign(layout.FirstPageSection, parent);
+
+    if (m_EncryptObj != nullptr)
+        assign(layout.FirstPageSection, m_EncryptObj);
+
+    assign(layout.FirstPageObjects, pages[0]);
+    for (auto obj : pageObjects[0])
+        assign(layout.FirstPageObjects, obj);
+
+    layout.OtherPages.resize(pages.size() - 1);
+    for (unsigned i = 1; i < pages.size(); i++)
+    {
+        auto& part = layout.OtherPages[i - 1];
+        assign(part, pages[i]);
+        for (auto obj : pageObjects[i])
+        {
+            if (usages[obj].Owner == (int)i)
+                assign(part, obj);
+        }
+    }
+
+    for (unsigned i = 1; i < pages.size(); i++)
+    {
+        for (auto obj : pageObjects[i])
+        {
+            if (usages[obj].Owner == -2)
+                assign(layout.SharedObjects, obj);
+        }
+    }
+
+    for (PdfObject* obj : *m_Objects)
+        assign(layout.OtherObjects, obj);
+
+    // The shared object hint table lists the objects of
+    // the first page first, then the shared objects
+    unordered_map<const PdfObject*, unsigned> sharedIds;
+    for (unsigned i = 0; i < layout.FirstPageObjects.size(); i++)
+        sharedIds[layout.FirstPageObjects[i]] = i;
+
+    for (unsigned i = 0; i < layout.SharedObjects.size(); i++)
+        sharedIds[layout.SharedObjects[i]] = (unsigned)layout.FirstPageObjects.size() + i;
+
+    layout.SharedReferences.resize(pages.size());
+    for (unsigned i = 1; i < pages.size(); i++)
+    {
+        for (auto obj : pageObjects[i])
+        {
+            if (usages[obj].Owner == -2)
+                layout.SharedReferences[i].push_back(sharedIds[obj]);
+        }
+    }
+
+    // The main section is numbered first, so the first page
+    // section has the highest numbers. All generations are 0
+    uint32_t num = 1;
+    auto number = [&](const vector<PdfObject*>& part)
+    {
+        for (auto obj : part)
+            layout.Numbers[obj] = num++;
+    };
+
+    for (auto& part : layout.OtherPages)
+        number(part);
+
+    number(layout.SharedObjects);
+    number(layout.OtherObjects);
+    layout.FirstPageNumber = num++;
+    number(layout.FirstPageSection);
+    number(layout.FirstPageObjects);
+    layout.HintNumber = num++;
+    layout.Size = num;
+    return true;
+}
+
+void PdfWriter::writeLinearizedParts(OutputStreamDevice& device, const LinearizedLayout& layout,
+    const charbuff* hint, LinearizedOffsets& offsets)
+{
+    // Offsets following the hint stream are shifted by its length
+    auto& measured = layout.Measured;
+    auto shift = [&](size_t offset) -> int64_t
+    {
+        return (int64_t)(offset < measured.Hint ? offset : offset + layout.HintLength);
+    };
+
+    unique_ptr<PdfStatefulEncrypt> encrypt;
+    if (m_Encrypt != nullptr)
+        encrypt.reset(new PdfStatefulEncrypt(m_Encrypt->GetEncrypt(), m_Encrypt->GetContext(), PdfReference()));
+
+    auto writeObjects = [&](const vector<PdfObject*>& part)
+    {
+        for (auto obj : part)
+        {
+            offsets.Objects[layout.Numbers.at(obj)] = device.GetPosition();
+            writeLinearizedObject(device, layout, *obj, encrypt.get());
+        }
+    };
+
+    offsets.Objects.assign(layout.Size, 0);
+    WritePdfHeader(device);
+
+    // Linearization dictionary
+    uint32_t firstPageNum = layout.Numbers.at(layout.FirstPageObjects[0]);
+    auto formatDictionary = [&](int64_t length, int64_t hintOffset, int64_t hintLength,
+        int64_t firstPageEnd, int64_t mainXRefEntries)
+    {
+        return utls::Format("{} 0 obj\n<</Linearized 1/L {}/H[{} {}]/O {}/E {}/N {}/T {}>>",
+            layout.FirstPageNumber, length, hintOffset, hintLength, firstPageNum,
+            firstPageEnd, layout.OtherPages.size() + 1, mainXRefEntries);
+    };
+    offsets.Objects[layout.FirstPageNumber] = device.GetPosition();
+    writePadded(device, formatDictionary(shift(measured.FileLength), (int64_t)measured.Hint,
+        (int64_t)layout.HintLength, shift(measured.FirstPageEnd), shift(measured.MainXRefEntries)),
+        formatDictionary(PlaceholderNumber, PlaceholderNumber, PlaceholderNumber,
+            PlaceholderNumber, PlaceholderNumber).size());
+    device.Write("\nendobj\n");
+
+    // First page XRef table and trailer
+    offsets.FirstXRef = device.GetPosition();
+    utls::FormatTo(m_buffer, "xref\n{} {}\n", layout.FirstPageNumber, layout.Size - layout.FirstPageNumber);
+    device.Write(m_buffer);
+    for (uint32_t i = layout.FirstPageNumber; i < layout.Size; i++)
+    {
+        int64_t offset = i == layout.HintNumber ? (int64_t)measured.Hint : shift(measured.Objects[i]);
+        utls::FormatTo(m_buffer, "{:010d} 00000 n \n", offset);
+        device.Write(m_buffer);
+    }
+
+    PdfObject trailer;
+    FillTrailerObject(trailer, layout.Size, false);
+    remapReferences(trailer, *m_Objects, layout.Numbers);
+    auto formatTrailer = [&](int64_t prevOffset)
+    {
+        trailer.GetDictionary().AddKey("Prev"_n, prevOffset);
+        string ret;
+        StringStreamDevice stream(ret);
+        // NOTE: Do not encrypt the trailer dictionary
+        trailer.Write(stream, m_WriteFlags, nullptr, m_buffer);
+        if (ret.size() != 0 && ret.back() == '\n')
+            ret.pop_back();
+
+        return ret;
+    };
+    size_t trailerLength = formatTrailer(PlaceholderNumber).size();
+    device.Write("trailer\n");
+    writePadded(device, formatTrailer(shift(measured.MainXRef)), trailerLength);
+    device.Write("\nstartxref\n0\n%%EOF\n");
+
+    writeObjects(layout.FirstPageSection);
+
+    offsets.Hint = device.GetPosition();
+    offsets.Objects[layout.HintNumber] = offsets.Hint;
+    if (hint != nullptr)
+        device.Write(string_view(hint->data(), hint->size()));
+
+    writeObjects(layout.FirstPageObjects);
+    offsets.FirstPageEnd = device.GetPosition();
+
+    for (auto& part : layout.OtherPages)
+        writeObjects(part);
+
+    writeObjects(layout.SharedObjects);
+    writeObjects(layout.OtherObjects);
+
+    // Main XRef table and trailer, where startxref
+    // points to the first page XRef table
+    offsets.MainXRef = device.GetPosition();
+    utls::FormatTo(m_buffer, "xref\n0 {}\n", layout.FirstPageNumber);
+    device.Write(m_buffer);
+    offsets.MainXRefEntries = device.GetPosition() - 1;
+    device.Write("0000000000 65535 f \n");
+    for (uint32_t i = 1; i < layout.FirstPageNumber; i++)
+    {
+        utls::FormatTo(m_buffer, "{:010d} 00000 n \n", offsets.Objects[i]);
+        device.Write(m_buffer);
+    }
+
+    utls::FormatTo(m_buffer, "trailer\n<</Size {}>>\nstartxref\n{}\n%%EOF\n", layout.Size, offsets.FirstXRef);
+    device.Write(m_buffer);
+    offsets.FileLength = device.GetPosition();
+}
+
+void PdfWriter::writeLinearizedObject(OutputStreamDevice& device, const LinearizedLayout& layout,
+    PdfObject& obj, PdfStatefulEncrypt* encrypt)
+{
+    // Remap the references on a copy of the object value only:
+    // the stream is written from the original object, so
+    // passthrough streams are never loaded in memory
+    PdfReference ref(layout.Numbers.at(&obj), 0);
+    PdfObject copy(obj.GetVariant());
+    remapReferences(copy, *m_Objects, layout.Numbers);
+    copy.SetIndirectReference(ref);
+
+    // Also make sure that we do not encrypt the encryption dictionary!
+    const PdfStatefulEncrypt* objEncrypt = nullptr;
+    if (encrypt != nullptr && &obj != m_EncryptObj)
+    {
+        encrypt->SetCurrentReference(ref);
+        objEncrypt = encrypt;
+    }
+
+    // The streams were already compressed, if needed. Encrypted
+    // strings are written in hexadecimal form, since the length
+    // of the escaped literal form is different on every pass
+    auto writeFlags = m_WriteFlags | PdfWriteFlags::NoFlateCompress;
+    if (objEncrypt != nullptr)
+        writeFlags |= PdfWriteFlags::HexStrings;
+
+    auto stream = obj.GetStream();
+    if (stream != nullptr)
+    {
+        size_t length = stream->GetLength();
+        if (objEncrypt != nullptr)
+            length = objEncrypt->CalculateStreamLength(length);
+
+        copy.GetDictionary().AddKey("Length"_n, static_cast<int64_t>(length));
+    }
+
+    copy.WriteHeader(device, writeFlags, m_buffer);
+    copy.GetVariant().Write(device, writeFlags, objEncrypt, m_buffer);
+    device.Write('\n');
+    if (stream != nullptr)
+        stream->Write(device, objEncrypt);
+
+    device.Write("endobj\n");
+    obj.ResetDirty();
+}
+
+void PdfWriter::createLinearizedHintStream(const LinearizedLayout& layout, charbuff& hint)
+{
+    auto& measured = layout.Measured;
+    auto getEnd = [&](const PdfObject& obj) -> size_t
+    {
+        uint32_t num = layout.Numbers.at(&obj);
+        if (num + 1 == layout.FirstPageNumber)
+            return measured.MainXRef;
+        else if (num + 1 == layout.HintNumber)
+            return measured.FirstPageEnd;
+        else
+            return measured.Objects[num + 1];
+    };
+    auto getOffset = [&](const PdfObject& obj)
+    {
+        return measured.Objects[layout.Numbers.at(&obj)];
+    };
+
+    // Page offset hint table, ISO 32000-2:2020 F.4.1. As
+    // other producers do, the content stream of a page is
+    // considered to span the whole page
+    vector<uint32_t> objectCounts;
+    vector<uint32_t> pageLengths;
+    objectCounts.push_back((uint32_t)layout.FirstPageObjects.size());
+    pageLengths.push_back((uint32_t)(measured.FirstPageEnd - getOffset(*layout.FirstPageObjects[0])));
+    for (auto& part : layout.OtherPages)
+    {
+        objectCounts.push_back((uint32_t)part.size());
+        pageLengths.push_back((uint32_t)(getEnd(*part.back()) - getOffset(*part[0])));
+    }
+
+    uint32_t minObjectCount = *std::min_element(objectCounts.begin(), objectCounts.end());
+    uint32_t maxObjectCount = *std::max_element(objectCounts.begin(), objectCounts.end());
+    uint32_t minPageLength = *std::min_element(pageLengths.begin(), pageLengths.end());
+    uint32_t maxPageLength = *std::max_element(pageLengths.begin(), pageLengths.end());
+    size_t maxSharedCount = 0;
+    unsigned maxSharedId = 0;
+    for (auto& references : layout.SharedReferences)
+    {
+        maxSharedCount = std::max(maxSharedCount, references.size());
+        for (unsigned id : references)
+            maxSharedId = std::max(maxSharedId, id);
+    }
+
+    unsigned objectCountBits = getBitCount(maxObjectCount - minObjectCount);
+    unsigned pageLengthBits = getBitCount(maxPageLength - minPageLength);
+    unsigned sharedCountBits = getBitCount(maxSharedCount);
+    unsigned sharedIdBits = getBitCount(maxSharedId);
+
+    charbuff data;
+    HintWriter writer(data);
+    writer.Write(minObjectCount, 32);
+    writer.Write(getOffset(*layout.FirstPageObjects[0]), 32);
+    writer.Write(objectCountBits, 16);
+    writer.Write(minPageLength, 32);
+    writer.Write(pageLengthBits, 16);
+    writer.Write(0, 32);                // Least content stream offset
+    writer.Write(0, 16);
+    writer.Write(minPageLength, 32);    // Least content stream length
+    writer.Write(pageLengthBits, 16);
+    writer.Write(sharedCountBits, 16);
+    writer.Write(sharedIdBits, 16);
+    writer.Write(0, 16);                // Fractional positions are not used
+    writer.Write(1, 16);
+
+    // Every item of the per-page entries starts at a byte boundary
+    for (uint32_t count : objectCounts)
+        writer.Write(count - minObjectCount, objectCountBits);
+    writer.Flush();
+    for (uint32_t length : pageLengths)
+        writer.Write(length - minPageLength, pageLengthBits);
+    writer.Flush();
+    for (auto& references : layout.SharedReferences)
+        writer.Write(references.size(), sharedCountBits);
+    writer.Flush();
+    for (auto& references : layout.SharedReferences)
+    {
+        for (unsigned id : references)
+            writer.Write(id, sharedIdBits);
+    }
+    writer.Flush();
+    for (uint32_t length : pageLengths)
+        writer.Write(length - minPageLength, pageLengthBits);
+    writer.Flush();
+
+    // Shared object hint table, F.4.2, with a group for every object
+    size_t sharedTableOffset = data.size();
+    vector<uint32_t> groupLengths;
+    for (auto obj : layout.FirstPageObjects)
+        groupLengths.push_back((uint32_t)(getEnd(*obj) - getOffset(*obj)));
+    for (auto obj : layout.SharedObjects)
+        groupLengths.push_back((uint32_t)(getEnd(*obj) - getOffset(*obj)));
+
+    uint32_t minGroupLength = *std::min_element(groupLengths.begin(), groupLengths.end());
+    uint32_t maxGroupLength = *std::max_element(groupLengths.begin(), groupLengths.end());
+    unsigned groupLengthBits = getBitCount(maxGroupLength - minGroupLength);
+    if (layout.SharedObjects.size() == 0)
+    {
+        writer.Write(0, 32);
+        writer.Write(0, 32);
+    }
+    else
+    {
+        writer.Write(layout.Numbers.at(layout.SharedObjects[0]), 32);
+        writer.Write(getOffset(*layout.SharedObjects[0]), 32);
+    }
+    writer.Write(layout.FirstPageObjects.size(), 32);
+    writer.Write(groupLengths.size(), 32);
+    writer.Write(0, 16);                // Groups have a single object
+    writer.Write(minGroupLength, 32);
+    writer.Write(groupLengthBits, 16);
+    for (uint32_t length : groupLengths)
+        writer.Write(length - minGroupLength, groupLengthBits);
+    writer.Flush();
+    for (size_t i = 0; i < groupLengths.size(); i++)
+        writer.Write(0, 1);             // No MD5 signatures
+    writer.Flush();
+
+    PdfReference ref(layout.HintNumber, 0);
+    PdfObject hintObj;
+    hintObj.SetIndirectReference(ref);
+    hintObj.GetDictionary().AddKey("S"_n, static_cast<int64_t>(sharedTableOffset));
+    // Write the data unfiltered, so it's compressed on write
+    hintObj.GetOrCreateStream().SetData(data, true);
+
+    unique_ptr<PdfStatefulEncrypt> encrypt;
+    if (m_Encrypt != nullptr)
+        encrypt.reset(new PdfStatefulEncrypt(m_Encrypt->GetEncrypt(), m_Encrypt->GetContext(), ref));
+
+    BufferStreamDevice device(hint);
+    hintObj.WriteFinal(device, m_WriteFlags, encrypt.get(), m_buffer);
+}
+
+void collectPages(PdfIndirectObjectList& objects, PdfObject& node, vector<PdfObject*>& parents,
+    vector<PdfObject*>& firstPageParents, vector<PdfObject*>& pages, unordered_set<const PdfObject*>& treeNodes)
+{
+    utls::RecursionGuard guard;
+    const PdfDictionary* dict;
+    const PdfName* type;
+    if (!treeNodes.insert(&node).second || !node.TryGetDictionary(dict)
+        || !dict->TryFindKeyAs("Type", type))
+    {
+        return;
+    }
+
+    if (*type == "Page")
+    {
+        if (pages.size() == 0)
+            firstPageParents = parents;
+
+        pages.push_back(&node);
+    }
+    else if (*type == "Pages")
+    {
+        const PdfArray* kids;
+        if (!dict->TryFindKeyAs("Kids", kids))
+            return;
+
+        parents.push_back(&node);
+        PdfReference ref;
+        for (auto& kid : *kids)
+        {
+            PdfObject* child;
+            if (kid.TryGetReference(ref) && (child = objects.GetObject(ref)) != nullptr)
+                collectPages(objects, *child, parents, firstPageParents, pages, treeNodes);
+        }
+        parents.pop_back();
+    }
+}
+
+template <typename TFunctor>
+void visitReferences(const PdfObject& obj, const TFunctor& fn)
+{
+    utls::RecursionGuard guard;
+    PdfReference ref;
+    const PdfDictionary* dict;
+    const PdfArray* arr;
+    if (obj.TryGetReference(ref))
+    {
+        fn(ref);
+    }
+    else if (obj.TryGetDictionary(dict))
+    {
+        for (auto& pair : *dict)
+        {
+            if (pair.first != "Parent")
+                visitReferences(pair.second, fn);
+        }
+    }
+    else if (obj.TryGetArray(arr))
+    {
+        for (auto& child : *arr)
+            visitReferences(child, fn);
+    }
+}
+
+void remapReferences(PdfObject& obj, PdfIndirectObjectList& objects,
+    const unordered_map<const PdfObject*, uint32_t>& numbers)
+{
+    utls::RecursionGuard guard;
+    PdfReference ref;
+    PdfDictionary* dict;
+    PdfArray* arr;
+    if (obj.TryGetReference(ref))
+    {
+        // Dangling references are replaced with null objects,
+        // since the object numbers are not preserved
+        auto target = objects.GetObject(ref);
+        auto found = target == nullptr ? numbers.end() : numbers.find(target);
+        if (found == numbers.end())
+            obj = PdfObject::Null;
+        else
+            obj.SetReference(PdfReference(found->second, 0));
+    }
+    else if (obj.TryGetDictionary(dict))
+    {
+        for (auto& pair : *dict)
+            remapReferences(pair.second, objects, numbers);
+    }
+    else if (obj.TryGetArray(arr))
+    {
+        for (auto& child : *arr)
+            remapReferences(child, objects, numbers);
+    }
+}
+
+void writePadded(OutputStreamDevice& device, const string_view& str, size_t length)
+{
+    device.Write(str);
+    for (size_t i = str.size(); i < length; i++)
+        device.Write(' ');
+}
+
+unsigned getBitCount(uint64_t value)
+{
+    unsigned ret = 0;
+    while (value != 0)
+    {
+        ret++;
+        value >>= 1;
+    }
+
+    return ret;
+}
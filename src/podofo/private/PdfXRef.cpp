@@ -27,31 +27,41 @@ PdfXRef::~PdfXRef() { }
 
 void PdfXRef::AddInUseObject(const PdfReference& ref, nullable<uint64_t> offset)
 {
-    addObject(ref, offset, true);
+    if (offset == nullptr)
+    {
+        // Objects with no offset provided will not be written
+        // in the entry list, but they are still accounted for /Size
+        if (ref.ObjectNumber() > m_maxObjCount)
+            m_maxObjCount = ref.ObjectNumber();
+
+        return;
+    }
+
+    XRefItem item(ref, *offset);
+    addObject(ref, &item);
 }
 
 void PdfXRef::AddFreeObject(const PdfReference& ref)
 {
-    addObject(ref, nullptr, false);
+    addObject(ref, nullptr);
 }
 
-void PdfXRef::addObject(const PdfReference& ref, nullable<uint64_t> offset, bool inUse)
+void PdfXRef::AddCompressedObject(const PdfReference& ref, uint32_t objStreamNum, uint32_t index)
+{
+    XRefItem item(ref, objStreamNum, index);
+    addObject(ref, &item);
+}
+
+void PdfXRef::addObject(const PdfReference& ref, const XRefItem* item)
 {
     if (ref.ObjectNumber() > m_maxObjCount)
         m_maxObjCount = ref.ObjectNumber();
 
-    if (inUse && offset == nullptr)
-    {
-        // Objects with no offset provided will not be written
-        // in the entry list
-        return;
-    }
-
     bool insertDone = false;
 
     for (auto& block : m_blocks)
     {
-        if (block.InsertItem(ref, offset, inUse))
+        if (block.InsertItem(ref, item))
         {
             insertDone = true;
             break;
@@ -63,10 +73,10 @@ void PdfXRef::addObject(const PdfReference& ref, nullable<uint64_t> offset, bool
         PdfXRefBlock block;
         block.First = ref.ObjectNumber();
         block.Count = 1;
-        if (inUse)
-            block.Items.push_back(XRefItem(ref, offset.value()));
-        else
+        if (item == nullptr)
             block.FreeItems.push_back(ref);
+        else
+            block.Items.push_back(*item);
 
         m_blocks.push_back(block);
         std::sort(m_blocks.begin(), m_blocks.end());
@@ -129,8 +139,16 @@ void PdfXRef::Write(OutputStreamDevice& device, charbuff& buffer)
                 itFree++;
             }
 
-            this->WriteXRefEntry(device, itItems->Reference,
-                PdfXRefEntry::CreateInUse(itItems->Offset, itItems->Reference.GenerationNumber()), buffer);
+            if (itItems->Compressed)
+            {
+                this->WriteXRefEntry(device, itItems->Reference,
+                    PdfXRefEntry::CreateCompressed(static_cast<uint32_t>(itItems->Offset), itItems->Index), buffer);
+            }
+            else
+            {
+                this->WriteXRefEntry(device, itItems->Reference,
+                    PdfXRefEntry::CreateInUse(itItems->Offset, itItems->Reference.GenerationNumber()), buffer);
+            }
             itItems++;
         }
 
@@ -318,18 +336,17 @@ bool PdfXRef::ShouldSkipWrite(const PdfReference& ref)
     return false;
 }
 
-bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, nullable<uint64_t> offset, bool inUse)
+bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, const XRefItem* item)
 {
-    PODOFO_ASSERT(!inUse || offset.has_value());
     if (ref.ObjectNumber() == First + Count)
     {
         // Insert at back
         Count++;
 
-        if (inUse)
-            Items.push_back(XRefItem(ref, offset.value()));
-        else
+        if (item == nullptr)
             FreeItems.push_back(ref);
+        else
+            Items.push_back(*item);
 
         return true; // no sorting required
     }
@@ -340,10 +357,10 @@ bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, nullable<uint64_
         Count++;
 
         // This is known to be slow, but should not occur actually
-        if (inUse)
-            Items.insert(Items.begin(), XRefItem(ref, offset.value()));
-        else
+        if (item == nullptr)
             FreeItems.insert(FreeItems.begin(), ref);
+        else
+            Items.insert(Items.begin(), *item);
 
         return true; // no sorting required
     }
@@ -353,15 +370,15 @@ bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, nullable<uint64_
         // Insert at back
         Count++;
 
-        if (inUse)
+        if (item == nullptr)
         {
-            Items.push_back(XRefItem(ref, offset.value()));
-            std::sort(Items.begin(), Items.end());
+            FreeItems.push_back(ref);
+            std::sort(FreeItems.begin(), FreeItems.end());
         }
         else
         {
-            FreeItems.push_back(ref);
-            std::sort(FreeItems.begin(), FreeItems.end());
+            Items.push_back(*item);
+            std::sort(Items.begin(), Items.end());
         }
 
         return true;
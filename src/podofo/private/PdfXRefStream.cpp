@@ -66,6 +66,7 @@ void PdfXRefStream::WriteXRefEntry(OutputStreamDevice& device, const PdfReferenc
     switch (entry.Type)
     {
         case PdfXRefEntryType::Free:
+        case PdfXRefEntryType::Compressed:
             stmEntry.Variant = AS_BIG_ENDIAN(static_cast<uint32_t>(entry.ObjectNumber));
             break;
         case PdfXRefEntryType::InUse:
@@ -75,6 +76,7 @@ void PdfXRefStream::WriteXRefEntry(OutputStreamDevice& device, const PdfReferenc
             PODOFO_RAISE_ERROR(PdfErrorCode::InvalidEnumValue);
     }
 
+    // NOTE: For compressed entries this is the index in the object stream
     stmEntry.Generation = AS_BIG_ENDIAN(static_cast<uint16_t>(entry.Generation));
     m_rawEntries.push_back(stmEntry);
 }
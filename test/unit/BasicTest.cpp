@@ -105,6 +105,60 @@ TEST_CASE("TestIterations2")
     REQUIRE(fields.size() == 23);
 }
 
+TEST_CASE("TestObjectListLookup")
+{
+    PdfMemDocument doc;
+    auto& objects = doc.GetObjects();
+    auto& obj1 = objects.CreateDictionaryObject();
+    auto& obj2 = objects.CreateDictionaryObject();
+    auto ref1 = obj1.GetIndirectReference();
+    auto ref2 = obj2.GetIndirectReference();
+    REQUIRE(objects.GetObject(ref1) == &obj1);
+    REQUIRE(objects.GetObject(ref2) == &obj2);
+    REQUIRE(objects.GetObject(PdfReference(ref1.ObjectNumber(), 1)) == nullptr);
+    REQUIRE(objects.GetObject(PdfReference(ref2.ObjectNumber() + 100, 0)) == nullptr);
+
+    // Keep only the first object, the second is freed and
+    // its number is reused with an incremented generation
+    doc.GetCatalog().GetDictionary().AddKeyIndirect("Test"_n, obj1);
+    objects.CollectGarbage();
+    REQUIRE(objects.GetObject(ref1) == &obj1);
+    REQUIRE(objects.GetObject(ref2) == nullptr);
+
+    auto& obj3 = objects.CreateDictionaryObject();
+    REQUIRE(obj3.GetIndirectReference() == PdfReference(ref2.ObjectNumber(), 1));
+    REQUIRE(objects.GetObject(ref2) == nullptr);
+    REQUIRE(objects.GetObject(obj3.GetIndirectReference()) == &obj3);
+}
+
+TEST_CASE("TestObjectListSparseLookup")
+{
+    // Sparse object numbers are found without being indexed
+    string buffer = "%PDF-1.4\n";
+    vector<size_t> offsets;
+    auto writeObject = [&](unsigned num, const string_view& value)
+    {
+        offsets.push_back(buffer.size());
+        buffer.append(utls::Format("{} 0 obj\n{}\nendobj\n", num, value));
+    };
+    writeObject(1, "<</Type/Catalog/Pages 2 0 R/Sparse 5000000 0 R>>");
+    writeObject(2, "<</Type/Pages/Kids[]/Count 0>>");
+    writeObject(5000000, "(Sparse)");
+    size_t xrefOffset = buffer.size();
+    buffer.append("xref\n0 3\n0000000000 65535 f \n");
+    buffer.append(utls::Format("{:010d} 00000 n \n{:010d} 00000 n \n", offsets[0], offsets[1]));
+    buffer.append(utls::Format("5000000 1\n{:010d} 00000 n \n", offsets[2]));
+    buffer.append(utls::Format("trailer\n<</Size 5000001/Root 1 0 R>>\nstartxref\n{}\n%%EOF\n", xrefOffset));
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(buffer);
+    auto& objects = doc.GetObjects();
+    REQUIRE(objects.MustGetObject(PdfReference(5000000, 0)).GetString() == "Sparse");
+    REQUIRE(objects.GetObject(PdfReference(5000000, 1)) == nullptr);
+    REQUIRE(objects.GetObject(PdfReference(4999999, 0)) == nullptr);
+    REQUIRE(doc.GetCatalog().GetDictionary().MustFindKey("Sparse").GetString() == "Sparse");
+}
+
 TEST_CASE("ErrorFilePath")
 {
     try
@@ -263,3 +317,21 @@ TEST_CASE("TestObjectAdapter")
     REQUIRE(info.FindKeyParentAs<PdfString>("Producer") == "PoDoFo - http://podofo.sf.net");
     REQUIRE(info.FindKeyParentAsSafe<PdfString>("Prod", "fallback") == "fallback");
 }
+
+TEST_CASE("TestOperatorConversion")
+{
+    for (unsigned i = (unsigned)PdfOperator::w; i <= (unsigned)PdfOperator::EX; i++)
+    {
+        auto op = (PdfOperator)i;
+        PdfOperator parsed;
+        REQUIRE(TryConvertTo(ToString(op), parsed));
+        REQUIRE(parsed == op);
+    }
+
+    PdfOperator parsed;
+    for (string_view str : { ""sv, "x"sv, "Tx"sv, "ww"sv, "BDCX"sv, "BD"sv, string_view("w\0", 2) })
+    {
+        REQUIRE(!TryConvertTo(str, parsed));
+        REQUIRE(parsed == PdfOperator::Unknown);
+    }
+}
@@ -25,6 +25,114 @@ TEST_CASE("TestDevices")
         FAIL(utls::Format("Buffer1 size is wrong after 100 attaches: {}", buffer1.size()));
 }
 
+TEST_CASE("TestMappedFileDevice")
+{
+    auto testPath = TestUtils::GetTestOutputFilePath("TestMappedFileDevice.txt");
+    {
+        FileStreamDevice output(testPath, FileMode::Create);
+        output.Write("Hello World Mapped!");
+    }
+
+    MappedFileStreamDevice device(testPath);
+    REQUIRE(device.GetLength() == 19);
+    REQUIRE(device.GetView().size() == 19);
+
+    char ch;
+    REQUIRE(device.Peek(ch));
+    REQUIRE(ch == 'H');
+    REQUIRE(device.ReadChar() == 'H');
+    REQUIRE(device.GetPosition() == 1);
+
+    char buffer[5];
+    device.Read(buffer, 5);
+    REQUIRE(string_view(buffer, 5) == "ello ");
+
+    device.Seek(-7, SeekDirection::End);
+    bool eof;
+    char buffer2[10];
+    REQUIRE(device.Read(buffer2, 10, eof) == 7);
+    REQUIRE(eof);
+    REQUIRE(string_view(buffer2, 7) == "Mapped!");
+    REQUIRE(device.Eof());
+    REQUIRE(!device.Peek(ch));
+
+    {
+        FileStreamDevice output(testPath, FileMode::Create);
+    }
+
+    MappedFileStreamDevice empty(testPath);
+    REQUIRE(empty.GetLength() == 0);
+    REQUIRE(empty.Eof());
+    REQUIRE(!empty.Peek(ch));
+    REQUIRE(empty.Read(buffer2, 10, eof) == 0);
+    REQUIRE(eof);
+}
+
+TEST_CASE("TestBlockCacheDevice")
+{
+    string source;
+    for (unsigned i = 0; i < 1000; i++)
+        source.append(utls::Format("{:08d}", i));
+
+    auto read = [&source](size_t offset, char* buffer, size_t size) {
+        size = std::min(size, source.size() - offset);
+        std::memcpy(buffer, source.data() + offset, size);
+        return size;
+    };
+
+    // Use small blocks and a tiny cache to stress eviction
+    BlockCacheStreamDevice device(source.size(), read, 100, 3, 1);
+    REQUIRE(device.GetLength() == source.size());
+
+    char ch;
+    REQUIRE(device.Peek(ch));
+    REQUIRE(ch == '0');
+
+    size_t offsets[] = { 7950, 120, 3999, 0, 7700, 150, 4005, 7999 };
+    char buffer[256];
+    for (size_t offset : offsets)
+    {
+        device.Seek(offset);
+        bool eof;
+        size_t read = device.Read(buffer, sizeof(buffer), eof);
+        REQUIRE(read == std::min(sizeof(buffer), source.size() - offset));
+        REQUIRE(string_view(buffer, read) == string_view(source).substr(offset, read));
+    }
+    REQUIRE(device.Eof());
+    REQUIRE(!device.Peek(ch));
+
+    device.Seek(4321);
+    string text;
+    while (device.Read(ch) && text.size() < 16)
+        text.push_back(ch);
+    REQUIRE(text == source.substr(4321, 16));
+
+    // Open a document reading only the needed parts of the file
+    charbuff pdf;
+    {
+        PdfMemDocument doc;
+        doc.GetPages().CreatePage(PdfPageSize::A4);
+        auto& obj = doc.GetObjects().CreateDictionaryObject();
+        doc.GetCatalog().GetDictionary().AddKeyIndirect("Unused"_n, obj);
+        obj.GetOrCreateStream().SetData(string(200000, 'x'), true);
+        StringStreamDevice output(pdf);
+        doc.Save(output, PdfSaveOptions::NoFlateCompress);
+    }
+
+    auto pdfDevice = std::make_shared<BlockCacheStreamDevice>(pdf.size(),
+        [&pdf](size_t offset, char* buffer, size_t size) {
+            size = std::min(size, pdf.size() - offset);
+            std::memcpy(buffer, pdf.data() + offset, size);
+            return size;
+        }, 4096, 8);
+    PdfMemDocument doc;
+    doc.Load(pdfDevice);
+    REQUIRE(doc.GetPages().GetCount() == 1);
+    REQUIRE(pdfDevice->GetReadLength() < pdf.size() / 2);
+    REQUIRE(doc.GetCatalog().GetDictionary().MustFindKey("Unused").GetStream()->GetCopy().size() == 200000);
+    REQUIRE(pdfDevice->GetReadLength() >= 200000);
+}
+
 TEST_CASE("TestSaveIncremental")
 {
     PdfMemDocument doc;
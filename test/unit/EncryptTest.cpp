@@ -15,6 +15,7 @@ using namespace PoDoFo;
 
 static void testAuthenticate(PdfEncrypt& encrypt, PdfEncryptContext& context);
 static void testEncrypt(PdfEncrypt& encrypt, PdfEncryptContext& context);
+static void testEncryptStreams(PdfEncrypt& encrypt, PdfEncryptContext& context);
 static void createEncryptedPdf(const string_view& filename);
 
 charbuff s_encBuffer;
@@ -229,9 +230,42 @@ TEST_CASE("TestAESV2")
 
     PdfEncryptContext context;
     testAuthenticate(*encrypt, context);
-    // AES decryption is not yet implemented.
-    // Therefore we have to disable this test.
-    //TestEncrypt(encrypt, context);
+    testEncrypt(*encrypt, context);
+    testEncryptStreams(*encrypt, context);
+}
+
+TEST_CASE("TestObjKeyCache")
+{
+    // Encrypting objects in interleaved order with the same
+    // context must give the same results of a fresh context
+    auto test = [](PdfEncryptionAlgorithm algorithm, PdfKeyLength keyLength)
+    {
+        auto encrypt = PdfEncrypt::Create(PDF_USER_PASSWORD, PDF_OWNER_PASSWORD, s_protection,
+            algorithm, keyLength);
+
+        PdfEncryptContext context;
+        testAuthenticate(*encrypt, context);
+
+        PdfReference refs[] = { PdfReference(7, 0), PdfReference(8, 0), PdfReference(7, 0), PdfReference(7, 1) };
+        for (auto& ref : refs)
+        {
+            charbuff encrypted;
+            encrypt->EncryptTo(encrypted, s_encBuffer, context, ref);
+
+            // The copy doesn't share the cached object key
+            PdfEncryptContext fresh(context);
+            charbuff expected;
+            encrypt->EncryptTo(expected, s_encBuffer, fresh, ref);
+            REQUIRE(encrypted == expected);
+
+            charbuff decrypted;
+            encrypt->DecryptTo(decrypted, encrypted, context, ref);
+            REQUIRE(decrypted == s_encBuffer);
+        }
+    };
+
+    test(PdfEncryptionAlgorithm::RC4V2, PdfKeyLength::L128);
+    test(PdfEncryptionAlgorithm::AESV2, PdfKeyLength::L128);
 }
 
 TEST_CASE("TestAESV3R5")
@@ -242,9 +276,8 @@ TEST_CASE("TestAESV3R5")
 
     PdfEncryptContext context;
     testAuthenticate(*encrypt, context);
-    // AES decryption is not yet implemented.
-    // Therefore we have to disable this test.
-    //TestEncrypt(encrypt, context);
+    testEncrypt(*encrypt, context);
+    testEncryptStreams(*encrypt, context);
 }
 
 TEST_CASE("TestAESV3R6")
@@ -255,9 +288,8 @@ TEST_CASE("TestAESV3R6")
 
     PdfEncryptContext context;
     testAuthenticate(*encrypt, context);
-    // AES decryption is not yet implemented.
-    // Therefore we have to disable this test.
-    //TestEncrypt(encrypt, context);
+    testEncrypt(*encrypt, context);
+    testEncryptStreams(*encrypt, context);
 }
 
 TEST_CASE("TestEnableAlgorithms")
@@ -359,6 +391,38 @@ TEST_CASE("TestEncryptBigBuffer")
     }
 }
 
+TEST_CASE("TestStreamedDocumentAES")
+{
+    auto algorithms = { PdfEncryptionAlgorithm::AESV2, PdfEncryptionAlgorithm::AESV3R6 };
+    for (auto algorithm : algorithms)
+    {
+        string tempFile = TestUtils::GetTestOutputFilePath("TestStreamedDocumentAES.pdf");
+        constexpr unsigned BufferSize = 100000;
+        charbuff testBuff(BufferSize);
+        for (unsigned i = 0; i < BufferSize; i++)
+            testBuff[i] = (char)(i % 253);
+
+        PdfReference bufferRef;
+        {
+            // Streams of a streamed document are encrypted
+            // while being written to the device
+            auto encrypt = PdfEncrypt::Create(PDF_USER_PASSWORD, PDF_OWNER_PASSWORD, s_protection,
+                algorithm, algorithm == PdfEncryptionAlgorithm::AESV2 ? PdfKeyLength::L128 : PdfKeyLength::L256);
+            PdfStreamedDocument doc(tempFile, PdfVersion::V1_7, std::move(encrypt));
+            (void)doc.GetPages().CreatePage(PdfPageSize::A4);
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            doc.GetCatalog().GetDictionary().AddKeyIndirect("TestBuffer"_n, obj);
+            bufferRef = obj.GetIndirectReference();
+            obj.GetOrCreateStream().SetData(testBuff);
+        }
+
+        PdfMemDocument doc;
+        doc.Load(tempFile, PDF_USER_PASSWORD);
+        REQUIRE(doc.GetEncrypt()->GetEncryptAlgorithm() == algorithm);
+        REQUIRE(doc.GetObjects().MustGetObject(bufferRef).MustGetStream().GetCopy() == testBuff);
+    }
+}
+
 TEST_CASE("TestEncryptMetadataFalse")
 {
     PdfMemDocument doc;
@@ -472,6 +536,44 @@ void testEncrypt(PdfEncrypt& encrypt, PdfEncryptContext& context)
     REQUIRE(memcmp(s_encBuffer.data(), decrypted.data(), s_encBuffer.size()) == 0);
 }
 
+void testEncryptStreams(PdfEncrypt& encrypt, PdfEncryptContext& context)
+{
+    // Use a buffer spanning multiple encryption chunks
+    charbuff buffer;
+    for (unsigned i = 0; i < 200; i++)
+        buffer.append(s_encBuffer.data(), s_encBuffer.size());
+
+    // Encrypt with unaligned writes
+    charbuff encrypted;
+    {
+        BufferStreamDevice device(encrypted);
+        auto output = encrypt.CreateEncryptionOutputStream(device, context, PdfReference(7, 0));
+        for (size_t i = 0; i < buffer.size(); i += 1000)
+            output->Write(buffer.data() + i, std::min<size_t>(1000, buffer.size() - i));
+
+        output->Close();
+        ASSERT_THROW_WITH_ERROR_CODE(output->Write("data"), PdfErrorCode::InternalLogic);
+    }
+    REQUIRE(encrypted.size() == encrypt.CalculateStreamLength(buffer.size()));
+
+    charbuff decrypted;
+    encrypt.DecryptTo(decrypted, encrypted, context, PdfReference(7, 0));
+    REQUIRE(decrypted == buffer);
+
+    // Decrypt with reads smaller than a block
+    SpanStreamDevice device(encrypted);
+    auto input = encrypt.CreateEncryptionInputStream(device, encrypted.size(), context, PdfReference(7, 0));
+    decrypted.clear();
+    char readBuffer[5];
+    bool eof;
+    do
+    {
+        size_t read = input->Read(readBuffer, std::size(readBuffer), eof);
+        decrypted.append(readBuffer, read);
+    } while (!eof);
+    REQUIRE(decrypted == buffer);
+}
+
 void createEncryptedPdf(const string_view& filename)
 {
     PdfMemDocument doc;
@@ -8,6 +8,7 @@
 
 #include <PdfTest.h>
 #include <podofo/private/PdfFilterFactory.h>
+#include <podofo/private/PdfFiltersImpl.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -34,6 +35,145 @@ TEST_CASE("TestFilters")
     }
 }
 
+TEST_CASE("TestFlateParams")
+{
+    string buffer;
+    for (unsigned i = 0; i < 100; i++)
+        buffer.append(s_testBuffer1);
+
+    PdfMemDocument doc;
+    PdfFlateParams params;
+    params.Level = 0;
+    doc.SetFlateParams(params);
+
+    auto& obj1 = doc.GetObjects().CreateDictionaryObject();
+    auto& stream1 = obj1.GetOrCreateStream();
+    stream1.SetData(buffer);
+    REQUIRE(stream1.GetFlateParams().Level == 0);
+
+    // Override the document parameters for a single stream
+    auto& obj2 = doc.GetObjects().CreateDictionaryObject();
+    auto& stream2 = obj2.GetOrCreateStream();
+    params.Level = 9;
+    params.Strategy = PdfFlateStrategy::Filtered;
+    params.MemLevel = 9;
+    stream2.SetFlateParams(params);
+    stream2.SetData(buffer);
+    REQUIRE(stream2.GetFlateParams().Level == 9);
+
+    REQUIRE(stream1.GetLength() > buffer.size());
+    REQUIRE(stream2.GetLength() < buffer.size() / 10);
+    REQUIRE(stream1.GetCopy() == buffer);
+    REQUIRE(stream2.GetCopy() == buffer);
+
+    stream2.SetFlateParams(nullptr);
+    REQUIRE(stream2.GetFlateParams().Level == 0);
+
+    // Whole buffer compression, as done when saving
+    params = { };
+    params.Strategy = PdfFlateStrategy::HuffmanOnly;
+    params.WindowBits = 9;
+    charbuff encoded;
+    charbuff decoded;
+    PdfFlateFilter::EncodeBuffer(encoded, buffer, params);
+    PdfFilterFactory::Create(PdfFilterType::FlateDecode)->DecodeTo(decoded, encoded);
+    REQUIRE(decoded == buffer);
+
+    params = { };
+    params.Level = 10;
+    ASSERT_THROW_WITH_ERROR_CODE(doc.SetFlateParams(params), PdfErrorCode::ValueOutOfRange);
+    params = { };
+    params.WindowBits = 16;
+    ASSERT_THROW_WITH_ERROR_CODE(stream1.SetFlateParams(params), PdfErrorCode::ValueOutOfRange);
+    params = { };
+    params.MemLevel = 0;
+    ASSERT_THROW_WITH_ERROR_CODE(doc.SetFlateParams(params), PdfErrorCode::ValueOutOfRange);
+}
+
+TEST_CASE("TestPngPredictors")
+{
+    // Layouts covering the scalar and the vectorized decoders:
+    // { Colors, BitsPerComponent }
+    const unsigned layouts[][2] = { { 1, 8 }, { 2, 8 }, { 3, 8 }, { 4, 8 },
+        { 1, 16 }, { 3, 16 }, { 4, 16 }, { 1, 1 }, { 3, 4 } };
+    constexpr unsigned columns = 37;
+    constexpr unsigned rows = 120;
+
+    for (auto& layout : layouts)
+    {
+        unsigned colors = layout[0];
+        unsigned bitsPerComponent = layout[1];
+        unsigned bpp = std::max(1u, (colors * bitsPerComponent + 7) / 8);
+        unsigned rowLength = (columns * colors * bitsPerComponent + 7) / 8;
+
+        // Generate a smooth image, with some noise
+        charbuff image(rowLength * rows);
+        unsigned seed = 1;
+        for (unsigned i = 0; i < image.size(); i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            image[i] = (char)(i / 7 + (seed >> 16) % 8);
+        }
+
+        // Filter every row with a different PNG predictor
+        charbuff filtered;
+        for (unsigned row = 0; row < rows; row++)
+        {
+            unsigned char type = (unsigned char)(row % 5);
+            filtered.push_back((char)type);
+            auto curr = reinterpret_cast<const unsigned char*>(image.data()) + row * rowLength;
+            auto prev = row == 0 ? nullptr : curr - rowLength;
+            for (unsigned i = 0; i < rowLength; i++)
+            {
+                int a = i < bpp ? 0 : curr[i - bpp];
+                int b = prev == nullptr ? 0 : prev[i];
+                int c = i < bpp || prev == nullptr ? 0 : prev[i - bpp];
+                int predicted;
+                switch (type)
+                {
+                    case 1:
+                        predicted = a;
+                        break;
+                    case 2:
+                        predicted = b;
+                        break;
+                    case 3:
+                        predicted = (a + b) / 2;
+                        break;
+                    case 4:
+                    {
+                        int p = a + b - c;
+                        int pa = std::abs(p - a);
+                        int pb = std::abs(p - b);
+                        int pc = std::abs(p - c);
+                        predicted = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                        break;
+                    }
+                    default:
+                        predicted = 0;
+                        break;
+                }
+
+                filtered.push_back((char)(curr[i] - predicted));
+            }
+        }
+
+        PdfDictionary decodeParms;
+        decodeParms.AddKey("Predictor"_n, (int64_t)15);
+        decodeParms.AddKey("Colors"_n, (int64_t)colors);
+        decodeParms.AddKey("BitsPerComponent"_n, (int64_t)bitsPerComponent);
+        decodeParms.AddKey("Columns"_n, (int64_t)columns);
+
+        auto filter = PdfFilterFactory::Create(PdfFilterType::FlateDecode);
+        charbuff encoded;
+        charbuff decoded;
+        filter->EncodeTo(encoded, filtered);
+        filter->DecodeTo(decoded, encoded, &decodeParms);
+        INFO(utls::Format("Colors {}, BitsPerComponent {}", colors, bitsPerComponent));
+        REQUIRE(decoded == image);
+    }
+}
+
 void testFilter(PdfFilterType filterType, const bufferview& view)
 {
     charbuff encoded;
@@ -303,3 +303,102 @@ bool getFontInfo(FcPattern* font, string& fontFamily, string& fontPath,
 }
 
 #endif // PODOFO_HAVE_FONTCONFIG
+
+TEST_CASE("TestScanEncodedStringTwoBytes")
+{
+    // A font with a 2 bytes /Identity-H encoding loaded from objects
+    // decodes strings with a table. Strings with a trailing partial
+    // code are scanned as usual
+    string_view toUnicode =
+        "/CIDInit /ProcSet findresource begin\n"
+        "12 dict begin\n"
+        "begincmap\n"
+        "/CMapName /Test def\n"
+        "/CMapType 2 def\n"
+        "1 begincodespacerange\n"
+        "<0000> <FFFF>\n"
+        "endcodespacerange\n"
+        "2 beginbfchar\n"
+        "<0041> <0041>\n"
+        "<0042> <00E8>\n"
+        "endbfchar\n"
+        "endcmap\n"
+        "CMapName currentdict /CMap defineresource pop\n"
+        "end\n"
+        "end\n";
+
+    PdfMemDocument doc;
+    auto& objects = doc.GetObjects();
+    auto& toUnicodeObj = objects.CreateDictionaryObject();
+    toUnicodeObj.GetOrCreateStream().SetData(toUnicode);
+
+    auto& descriptorObj = objects.CreateDictionaryObject("FontDescriptor");
+    auto& descriptor = descriptorObj.GetDictionary();
+    descriptor.AddKey("FontName"_n, PdfName("Test"));
+    descriptor.AddKey("Flags"_n, PdfObject(static_cast<int64_t>(32)));
+    PdfArray bbox;
+    bbox.Add(PdfObject(0.0));
+    bbox.Add(PdfObject(-200.0));
+    bbox.Add(PdfObject(1000.0));
+    bbox.Add(PdfObject(800.0));
+    descriptor.AddKey("FontBBox"_n, bbox);
+    descriptor.AddKey("ItalicAngle"_n, PdfObject(0.0));
+    descriptor.AddKey("Ascent"_n, PdfObject(800.0));
+    descriptor.AddKey("Descent"_n, PdfObject(-200.0));
+    descriptor.AddKey("CapHeight"_n, PdfObject(700.0));
+    descriptor.AddKey("StemV"_n, PdfObject(80.0));
+
+    auto& cidFontObj = objects.CreateDictionaryObject("Font", "CIDFontType2");
+    auto& cidFont = cidFontObj.GetDictionary();
+    cidFont.AddKey("BaseFont"_n, PdfName("Test"));
+    PdfDictionary cidInfo;
+    cidInfo.AddKey("Registry"_n, PdfString("Adobe"));
+    cidInfo.AddKey("Ordering"_n, PdfString("Identity"));
+    cidInfo.AddKey("Supplement"_n, PdfObject(static_cast<int64_t>(0)));
+    cidFont.AddKey("CIDSystemInfo"_n, cidInfo);
+    cidFont.AddKeyIndirect("FontDescriptor"_n, descriptorObj);
+    cidFont.AddKey("DW"_n, PdfObject(static_cast<int64_t>(1000)));
+    PdfArray widths;
+    widths.Add(PdfObject(static_cast<int64_t>(500)));
+    widths.Add(PdfObject(static_cast<int64_t>(600)));
+    PdfArray w;
+    w.Add(PdfObject(static_cast<int64_t>(0x41)));
+    w.Add(widths);
+    cidFont.AddKey("W"_n, w);
+
+    auto& fontObj = objects.CreateDictionaryObject("Font", "Type0");
+    auto& fontDict = fontObj.GetDictionary();
+    fontDict.AddKey("BaseFont"_n, PdfName("Test"));
+    fontDict.AddKey("Encoding"_n, PdfName("Identity-H"));
+    PdfArray descendants;
+    descendants.Add(cidFontObj.GetIndirectReference());
+    fontDict.AddKey("DescendantFonts"_n, descendants);
+    fontDict.AddKeyIndirect("ToUnicode"_n, toUnicodeObj);
+
+    unique_ptr<PdfFont> font;
+    REQUIRE(PdfFont::TryCreateFromObject(fontObj, font));
+
+    PdfTextState state;
+    state.Font = font.get();
+    state.FontSize = 10;
+    string utf8;
+    vector<double> lengths;
+    vector<unsigned> positions;
+    REQUIRE(font->TryScanEncodedString(PdfString::FromRaw("\x00\x41\x00\x42\x00\x41"sv), state, utf8, lengths, positions));
+    REQUIRE(utf8 == "AèA");
+    REQUIRE(positions == vector<unsigned>{ 0, 1, 3 });
+    REQUIRE(lengths == vector<double>{ 5, 6, 5 });
+
+    // A code without unicode mapping
+    REQUIRE(!font->TryScanEncodedString(PdfString::FromRaw("\x00\x43\x00\x41"sv), state, utf8, lengths, positions));
+    REQUIRE(utf8 == "A");
+    REQUIRE(positions == vector<unsigned>{ 0, 0 });
+    REQUIRE(lengths == vector<double>{ 10, 5 });
+
+    // A partial code at the end
+    (void)font->TryScanEncodedString(PdfString::FromRaw("\x00\x42\x00\x41\x00"sv), state, utf8, lengths, positions);
+    REQUIRE(utf8.substr(0, 3) == "èA");
+    REQUIRE(lengths.size() == 3);
+    REQUIRE(lengths[0] == 6);
+    REQUIRE(lengths[1] == 5);
+}
@@ -37,6 +37,23 @@ TEST_CASE("TestEmptyContentsStream")
     REQUIRE(!pageObj.GetDictionary().HasKey("Contents"));
 }
 
+TEST_CASE("TestDirectResources")
+{
+    PdfMemDocument doc;
+    auto& page = doc.GetPages().CreatePage(PdfPageSize::A4);
+    auto& resources = static_cast<PdfCanvas&>(page).GetOrCreateResources();
+    REQUIRE(!resources.GetObject().IsIndirect());
+
+    // Adding keys to the page must not move the direct
+    // /Resources dictionary the element refers to
+    for (unsigned i = 0; i < 100; i++)
+        page.GetDictionary().AddKey(PdfName(utls::Format("K{}", i)), static_cast<int64_t>(i));
+
+    resources.GetDictionary().AddKey("ProcSet"_n, PdfArray());
+    REQUIRE(&resources.GetObject() == page.GetDictionary().GetKey("Resources"));
+    REQUIRE(page.GetDictionary().MustFindKey("Resources").GetDictionary().HasKey("ProcSet"));
+}
+
 TEST_CASE("TestRotations")
 {
     // The two documents are rotated but still portrait
@@ -23,11 +23,13 @@
 
 #include <PdfTest.h>
 #include <podofo/private/PdfParser.h>
+#include <podofo/private/PdfPassthroughObjectStream.h>
 
 using namespace std;
 using namespace PoDoFo;
 
 static string generateXRefEntries(size_t count);
+static string generateObjectStreamDocument(bool duplicateInfo = false);
 static bool canOutOfMemoryKillUnitTests();
 static size_t getStackOverflowDepth();
 
@@ -47,6 +49,7 @@ namespace PoDoFo
         }
 
         static void TestReadXRefContents();
+        static void TestReadXRefSubsectionFallback();
         static void TestMaxObjectCount();
         static void TestMaxObjectCount2();
         static void TestReadXRefStreamContents();
@@ -87,6 +90,8 @@ namespace PoDoFo
 
         const shared_ptr<InputStreamDevice>& GetDevice() { return m_device; }
 
+        const PdfXRefEntries& GetEntries() const { return m_entries; }
+
     private:
         static void testReadXRefSubsection();
 
@@ -97,6 +102,7 @@ namespace PoDoFo
 }
 
 METHOD_AS_TEST_CASE(PdfParserTest::TestReadXRefContents, "TestReadXRefContents");
+METHOD_AS_TEST_CASE(PdfParserTest::TestReadXRefSubsectionFallback, "TestReadXRefSubsectionFallback");
 METHOD_AS_TEST_CASE(PdfParserTest::TestMaxObjectCount, "TestMaxObjectCount");
 METHOD_AS_TEST_CASE(PdfParserTest::TestMaxObjectCount2, "TestMaxObjectCount2", "[.]");
 METHOD_AS_TEST_CASE(PdfParserTest::TestReadXRefStreamContents, "TestReadXRefStreamContents");
@@ -459,6 +465,61 @@ void PdfParserTest::TestReadXRefContents()
     }
 }
 
+void PdfParserTest::TestReadXRefSubsectionFallback()
+{
+    // Span more than a chunk of the bulk parser and put an entry
+    // only the tolerant parser accepts in the middle of the section
+    ostringstream oss;
+    for (unsigned i = 0; i < 3000; i++)
+    {
+        if (i == 1500)
+            oss << "000001500  00000 n\r\n";
+        else if (i % 2 == 0)
+            oss << utls::Format("{:010d} {:05d} n\r\n", i, i % 7);
+        else
+            oss << utls::Format("{:010d} 65535 f \n", i + 1);
+    }
+    oss << "trailer";
+
+    PdfIndirectObjectList objects;
+    PdfParserTest parser(objects, oss.str());
+    parser.ReadXRefSubsection(10, 3000);
+    auto& entries = parser.GetEntries();
+    REQUIRE(entries.GetSize() == 3010);
+    for (unsigned i = 0; i < 3000; i++)
+    {
+        auto& entry = entries[10 + i];
+        REQUIRE(entry.Parsed);
+        if (i % 2 == 0)
+        {
+            REQUIRE(entry.Type == PdfXRefEntryType::InUse);
+            REQUIRE(entry.Offset == i);
+            REQUIRE(entry.Generation == (i == 1500 ? 0 : i % 7));
+        }
+        else
+        {
+            REQUIRE(entry.Type == PdfXRefEntryType::Free);
+            REQUIRE(entry.ObjectNumber == i + 1);
+            REQUIRE(entry.Generation == 65535);
+        }
+    }
+
+    string_view token;
+    PdfTokenizer tokenizer;
+    REQUIRE(tokenizer.TryReadNextToken(*parser.GetDevice(), token));
+    REQUIRE(token == "trailer");
+
+    // A malformed entry stops the section as before
+    oss.str({ });
+    oss << "0000000010 00000 n\r\n";
+    oss << "00000000x0 00000 n\r\n";
+    PdfIndirectObjectList objects2;
+    PdfParserTest parser2(objects2, oss.str());
+    REQUIRE_THROWS_AS(parser2.ReadXRefSubsection(0, 2), PdfError);
+    REQUIRE(parser2.GetEntries()[0].Parsed);
+    REQUIRE(!parser2.GetEntries()[1].Parsed);
+}
+
 void PdfParserTest::testReadXRefSubsection()
 {
     int64_t firstObject = 0;
@@ -2804,6 +2865,718 @@ TEST_CASE("TestReclaimObjectMemory")
     REQUIRE(!imageObj->TryUnload());
 }
 
+TEST_CASE("TestLazyCompressedObjects")
+{
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(generateObjectStreamDocument());
+
+    auto& objects = doc.GetObjects();
+    auto pageObj = objects.GetObject(PdfReference(5, 0));
+    REQUIRE(pageObj != nullptr);
+    REQUIRE(!pageObj->IsDelayedLoadDone());
+
+    auto& page = doc.GetPages().GetPageAt(0);
+    REQUIRE(pageObj->IsDelayedLoadDone());
+    REQUIRE(page.GetRect().Width == 200);
+
+    // The object 6 is not found at the index reported by the
+    // xref, but it's still found in the stream by its number
+    auto infoObj = objects.GetObject(PdfReference(6, 0));
+    REQUIRE(infoObj != nullptr);
+    REQUIRE(infoObj->GetDictionary().MustFindKey("Title").GetString() == "Lazy");
+
+    // The object 7 is not present in the stream at all
+    auto missingObj = objects.GetObject(PdfReference(7, 0));
+    REQUIRE(missingObj != nullptr);
+    REQUIRE(missingObj->IsNull());
+}
+
+TEST_CASE("TestArenaObjectLifetime")
+{
+    // Objects data is allocated in the arena of the document
+    // while loading, check it stays valid after the document
+    // is destroyed if it's moved out of it
+    PdfObject infoObj;
+    PdfObject pageObj;
+    {
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(generateObjectStreamDocument());
+        infoObj = std::move(doc.GetObjects().MustGetObject(PdfReference(6, 0)));
+        pageObj = std::move(doc.GetObjects().MustGetObject(PdfReference(5, 0)));
+    }
+
+    REQUIRE(infoObj.GetDictionary().MustFindKey("Title").GetString() == "Lazy");
+    REQUIRE(pageObj.GetDictionary().MustFindKey("MediaBox").GetArray().size() == 4);
+}
+
+TEST_CASE("TestEagerCompressedObjects")
+{
+    auto buffer = generateObjectStreamDocument();
+    for (bool parallel : { false, true })
+    {
+        SpanStreamDevice device(buffer);
+        PdfMemDocument doc;
+        auto& objects = doc.GetObjects();
+        PdfParser parser(objects);
+        parser.SetParallelLoad(parallel);
+        parser.Parse(device, false);
+
+        REQUIRE(objects.GetObject(PdfReference(3, 0))->GetDictionary().MustFindKey("Type").GetName() == "Catalog");
+        REQUIRE(objects.GetObject(PdfReference(5, 0))->GetDictionary().MustFindKey("Type").GetName() == "Page");
+        REQUIRE(objects.GetObject(PdfReference(6, 0))->GetDictionary().MustFindKey("Title").GetString() == "Lazy");
+        REQUIRE(objects.GetObject(PdfReference(7, 0)) == nullptr);
+    }
+}
+
+TEST_CASE("TestDuplicatedCompressedObjects")
+{
+    // When an object is duplicated in an object stream, the
+    // last occurrence is used, both when loading lazily...
+    auto buffer = generateObjectStreamDocument(true);
+    {
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(buffer);
+        auto& infoObj = doc.GetObjects().MustGetObject(PdfReference(6, 0));
+        REQUIRE(infoObj.GetDictionary().MustFindKey("Title").GetString() == "Duplicated");
+    }
+
+    // ...and eagerly
+    for (bool parallel : { false, true })
+    {
+        SpanStreamDevice device(buffer);
+        PdfMemDocument doc;
+        auto& objects = doc.GetObjects();
+        PdfParser parser(objects);
+        parser.SetParallelLoad(parallel);
+        parser.Parse(device, false);
+        REQUIRE(objects.MustGetObject(PdfReference(6, 0)).GetDictionary().MustFindKey("Title").GetString() == "Duplicated");
+    }
+}
+
+TEST_CASE("TestParallelLoad")
+{
+    // Create a document with enough objects to be
+    // split among several threads, some with streams
+    charbuff buffer;
+    {
+        PdfMemDocument doc;
+        for (unsigned i = 0; i < 3000; i++)
+        {
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            obj.GetDictionary().AddKey("Index"_n, (int64_t)i);
+            if (i % 3 == 0)
+                obj.GetOrCreateStream().SetData(utls::Format("Stream data {}", i));
+        }
+
+        BufferStreamDevice device(buffer);
+        doc.Save(device, PdfSaveOptions::NoCollectGarbage);
+    }
+
+    SpanStreamDevice serialDevice(buffer);
+    PdfMemDocument serialDoc;
+    PdfParser serialParser(serialDoc.GetObjects());
+    serialParser.Parse(serialDevice, false);
+
+    SpanStreamDevice parallelDevice(buffer);
+    PdfMemDocument parallelDoc;
+    PdfParser parallelParser(parallelDoc.GetObjects());
+    parallelParser.SetParallelLoad(true);
+    parallelParser.Parse(parallelDevice, false);
+
+    auto& serialObjects = serialDoc.GetObjects();
+    auto& parallelObjects = parallelDoc.GetObjects();
+    REQUIRE(serialObjects.GetSize() == parallelObjects.GetSize());
+    for (auto serialObj : serialObjects)
+    {
+        auto parallelObj = parallelObjects.GetObject(serialObj->GetIndirectReference());
+        REQUIRE(parallelObj != nullptr);
+        REQUIRE(parallelObj->ToString() == serialObj->ToString());
+        REQUIRE(parallelObj->HasStream() == serialObj->HasStream());
+        if (serialObj->HasStream())
+            REQUIRE(parallelObj->MustGetStream().GetCopy() == serialObj->MustGetStream().GetCopy());
+    }
+
+    // Streams written by PdfStreamedDocument have an indirect /Length
+    charbuff streamedBuffer;
+    {
+        PdfStreamedDocument doc(std::make_shared<BufferStreamDevice>(streamedBuffer));
+        (void)doc.GetPages().CreatePage(PdfPageSize::A4);
+        for (unsigned i = 0; i < 3000; i++)
+        {
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            doc.GetCatalog().GetDictionary().AddKeyIndirect(PdfName(utls::Format("Obj{}", i)), obj);
+            obj.GetOrCreateStream().SetData(utls::Format("Stream data {}", i));
+        }
+    }
+
+    PdfMemDocument streamedDoc;
+    streamedDoc.SetParallelLoad(true);
+    streamedDoc.LoadFromBuffer(streamedBuffer);
+    auto& catalog = streamedDoc.GetCatalog().GetDictionary();
+    for (unsigned i = 0; i < 3000; i++)
+    {
+        auto& obj = catalog.MustFindKey(utls::Format("Obj{}", i));
+        REQUIRE(obj.GetDictionary().MustGetKey("Length").IsReference());
+        REQUIRE(obj.MustGetStream().GetCopy() == utls::Format("Stream data {}", i));
+    }
+}
+
+TEST_CASE("TestPassthroughStreams")
+{
+    auto filepath = TestUtils::GetTestOutputFilePath("TestPassthroughStreams.pdf");
+    PdfReference streamRef;
+    {
+        PdfMemDocument doc;
+        doc.GetPages().CreatePage(PdfPageSize::A4);
+        for (unsigned i = 0; i < 20; i++)
+        {
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            obj.GetOrCreateStream().SetData(utls::Format("Stream data {}", i));
+            streamRef = obj.GetIndirectReference();
+        }
+        doc.Save(filepath, PdfSaveOptions::NoCollectGarbage);
+    }
+
+    // Streams parsed eagerly are read in memory
+    FileStreamDevice eagerDevice(filepath);
+    PdfMemDocument eagerDoc;
+    PdfParser parser(eagerDoc.GetObjects());
+    parser.Parse(eagerDevice, false);
+
+    // Streams loaded on demand are left in the source device,
+    // either memory mapped or read through seeking
+    PdfMemDocument mappedDoc;
+    mappedDoc.Load(std::make_shared<MappedFileStreamDevice>(filepath));
+    PdfMemDocument fileDoc;
+    fileDoc.Load(std::make_shared<FileStreamDevice>(filepath));
+
+    unsigned streamCount = 0;
+    for (auto eagerObj : eagerDoc.GetObjects())
+    {
+        if (!eagerObj->HasStream())
+            continue;
+
+        auto eagerData = eagerObj->MustGetStream().GetCopy(true);
+        REQUIRE(dynamic_cast<const PdfMemoryObjectStream*>(&std::as_const(eagerObj->MustGetStream()).GetProvider()) != nullptr);
+        for (auto doc : { &mappedDoc, &fileDoc })
+        {
+            auto& stream = doc->GetObjects().MustGetObject(eagerObj->GetIndirectReference()).MustGetStream();
+            auto provider = dynamic_cast<const PdfPassthroughObjectStream*>(&std::as_const(stream).GetProvider());
+            REQUIRE(provider != nullptr);
+            REQUIRE(provider->IsPassthrough());
+            REQUIRE(stream.GetCopy(true) == eagerData);
+            REQUIRE(stream.GetCopy() == eagerObj->MustGetStream().GetCopy());
+        }
+        streamCount++;
+    }
+    REQUIRE(streamCount != 0);
+
+    // Unmodified streams are copied from the source on save
+    charbuff buffer;
+    {
+        BufferStreamDevice device(buffer);
+        fileDoc.Save(device, PdfSaveOptions::NoCollectGarbage);
+    }
+
+    PdfMemDocument savedDoc;
+    savedDoc.LoadFromBuffer(buffer);
+    for (auto eagerObj : eagerDoc.GetObjects())
+    {
+        if (!eagerObj->HasStream())
+            continue;
+
+        auto& stream = savedDoc.GetObjects().MustGetObject(eagerObj->GetIndirectReference()).MustGetStream();
+        REQUIRE(stream.GetCopy(true) == eagerObj->MustGetStream().GetCopy(true));
+    }
+
+    // Copying to another document reads the data in memory
+    auto& sourceObj = mappedDoc.GetObjects().MustGetObject(streamRef);
+    PdfMemDocument otherDoc;
+    auto& copiedObj = otherDoc.GetObjects().CreateDictionaryObject();
+    copiedObj = sourceObj;
+    REQUIRE(dynamic_cast<const PdfMemoryObjectStream*>(&std::as_const(copiedObj.MustGetStream()).GetProvider()) != nullptr);
+    REQUIRE(copiedObj.MustGetStream().GetCopy(true) == sourceObj.MustGetStream().GetCopy(true));
+
+    // Writing new data detaches the stream from the source
+    auto& sourceStream = sourceObj.MustGetStream();
+    sourceStream.SetData("Modified"sv);
+    auto provider = dynamic_cast<const PdfPassthroughObjectStream*>(&std::as_const(sourceStream).GetProvider());
+    REQUIRE(provider != nullptr);
+    REQUIRE(!provider->IsPassthrough());
+    REQUIRE(sourceStream.GetCopy() == "Modified");
+
+    // Streams copied or moved out of a document don't refer
+    // the source device, which may be destroyed first
+    PdfObject movedObj;
+    {
+        PdfMemDocument doc;
+        doc.Load(std::make_shared<FileStreamDevice>(filepath));
+        auto& obj = doc.GetObjects().MustGetObject(streamRef);
+        fileDoc.GetObjects().MustGetObject(streamRef) = obj;
+        movedObj = std::move(obj);
+    }
+    auto& copiedStream = fileDoc.GetObjects().MustGetObject(streamRef).MustGetStream();
+    provider = dynamic_cast<const PdfPassthroughObjectStream*>(&std::as_const(copiedStream).GetProvider());
+    REQUIRE(provider != nullptr);
+    REQUIRE(!provider->IsPassthrough());
+    REQUIRE(copiedStream.GetCopy() == "Stream data 19");
+    REQUIRE(movedObj.MustGetStream().GetCopy() == "Stream data 19");
+}
+
+TEST_CASE("TestCompressObjects")
+{
+    auto createDocument = []()
+    {
+        auto doc = std::make_unique<PdfMemDocument>();
+        for (unsigned i = 0; i < 10; i++)
+            doc->GetPages().CreatePage(PdfPageSize::A4);
+
+        for (unsigned i = 0; i < 30; i++)
+        {
+            auto& obj = doc->GetObjects().CreateDictionaryObject();
+            obj.GetDictionary().AddKey("Title"_n, PdfString(utls::Format("Object {}", i)));
+            doc->GetCatalog().GetDictionary().AddKey(PdfName(utls::Format("Obj{}", i)), obj.GetIndirectReference());
+        }
+        return doc;
+    };
+
+    charbuff plain;
+    {
+        auto doc = createDocument();
+        BufferStreamDevice device(plain);
+        doc->Save(device, PdfSaveOptions::NoMetadataUpdate);
+    }
+
+    for (bool encrypt : { false, true })
+    {
+        charbuff compressed;
+        {
+            auto doc = createDocument();
+            if (encrypt)
+                doc->SetEncrypted("user", "owner");
+
+            doc->SetObjectStreamSize(8);
+            unsigned objectCount = doc->GetObjects().GetSize();
+            BufferStreamDevice device(compressed);
+            doc->Save(device, PdfSaveOptions::NoMetadataUpdate | PdfSaveOptions::NoCollectGarbage
+                | PdfSaveOptions::CompressObjects);
+
+            // The XRef stream and encryption objects are not left in the document
+            REQUIRE(doc->GetObjects().GetSize() == objectCount);
+        }
+
+        REQUIRE(std::string_view(compressed).find("/ObjStm") != string_view::npos);
+        if (!encrypt)
+            REQUIRE(compressed.size() < plain.size());
+
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(compressed, encrypt ? "user" : "");
+        REQUIRE(doc.GetPages().GetCount() == 10);
+        for (unsigned i = 0; i < 30; i++)
+        {
+            auto& obj = doc.GetCatalog().GetDictionary().MustFindKey(PdfName(utls::Format("Obj{}", i)));
+            REQUIRE(obj.GetDictionary().MustFindKey("Title").GetString().GetString() == utls::Format("Object {}", i));
+        }
+    }
+
+    PdfMemDocument doc;
+    REQUIRE(doc.GetObjectStreamSize() == PdfObjectStreamSizeDefault);
+    ASSERT_THROW_WITH_ERROR_CODE(doc.SetObjectStreamSize(0), PdfErrorCode::ValueOutOfRange);
+}
+
+TEST_CASE("TestParallelCompress")
+{
+    auto save = [](PdfSaveOptions opts)
+    {
+        PdfMemDocument doc;
+        doc.GetMetadata().SetCreationDate(nullptr);
+        for (unsigned i = 0; i < 200; i++)
+        {
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            obj.GetDictionary().AddKey("Index"_n, (int64_t)i);
+            string data;
+            for (unsigned j = 0; j < 100; j++)
+                data.append(utls::Format("{} {} m {} {} l S\n", i, j, j, i));
+
+            // Write the data unfiltered, so it's compressed on save
+            obj.GetOrCreateStream().SetData(data, true);
+        }
+
+        charbuff buffer;
+        BufferStreamDevice device(buffer);
+        doc.Save(device, PdfSaveOptions::NoCollectGarbage | PdfSaveOptions::NoMetadataUpdate | opts);
+        return buffer;
+    };
+
+    auto serial = save(PdfSaveOptions::None);
+    auto parallel = save(PdfSaveOptions::ParallelCompress);
+    REQUIRE(parallel == serial);
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(parallel);
+    unsigned count = 0;
+    for (auto obj : doc.GetObjects())
+    {
+        if (!obj->HasStream())
+            continue;
+
+        auto& stream = obj->MustGetStream();
+        REQUIRE(stream.GetFilters().size() == 1);
+        REQUIRE(stream.GetCopy().size() != 0);
+        count++;
+    }
+    REQUIRE(count == 200);
+}
+
+TEST_CASE("TestLinearize")
+{
+    auto save = [](bool encrypt, PdfSaveOptions opts)
+    {
+        PdfMemDocument doc;
+        auto& shared = doc.GetObjects().CreateDictionaryObject();
+        PdfArray procSet;
+        procSet.Add("PDF"_n);
+        procSet.Add("Text"_n);
+        shared.GetDictionary().AddKey("ProcSet"_n, procSet);
+        for (unsigned i = 0; i < 5; i++)
+        {
+            auto& page = doc.GetPages().CreatePage(PdfPageSize::A4);
+            auto& contents = doc.GetObjects().CreateDictionaryObject();
+            contents.GetOrCreateStream().SetData(utls::Format("BT (Page {}) Tj ET", i));
+            page.GetDictionary().AddKeyIndirect("Contents"_n, contents);
+            page.GetDictionary().AddKeyIndirect("Resources"_n, shared);
+        }
+
+        // Referenced only by the document
+        auto& other = doc.GetObjects().CreateDictionaryObject();
+        other.GetDictionary().AddKey("Title"_n, PdfString("Other"));
+        doc.GetCatalog().GetDictionary().AddKeyIndirect("Other"_n, other);
+        if (encrypt)
+            doc.SetEncrypted("user", "owner");
+
+        charbuff buffer;
+        BufferStreamDevice device(buffer);
+        doc.Save(device, PdfSaveOptions::NoMetadataUpdate | PdfSaveOptions::Linearize | opts);
+        return buffer;
+    };
+
+    // Object streams are not written when linearizing, and
+    // neither is the object of a XRef stream
+    {
+        auto buffer = save(false, PdfSaveOptions::CompressObjects);
+        REQUIRE(string_view(buffer).find("/XRef") == string_view::npos);
+    }
+
+    for (bool encrypt : { false, true })
+    {
+        auto buffer = save(encrypt, PdfSaveOptions::None);
+        string_view view(buffer);
+
+        // The linearization dictionary is the first object
+        REQUIRE(view.find("/Linearized 1") < view.find("endobj"));
+        REQUIRE(view.find(utls::Format("/L {}", buffer.size())) != string_view::npos);
+        REQUIRE(view.find("/N 5") != string_view::npos);
+
+        // Both xref tables are written, the last one being the main one
+        REQUIRE(view.find("\nxref\n0 ") == view.rfind("\nxref\n"));
+
+        {
+            PdfMemDocument doc;
+            PdfParser parser(doc.GetObjects());
+            parser.SetPassword(encrypt ? "user" : "");
+            SpanStreamDevice device(buffer);
+            parser.Parse(device, true);
+            PdfReference ref;
+            unsigned pageCount;
+            REQUIRE(parser.TryGetLinearizedFirstPage(ref, pageCount));
+            REQUIRE(pageCount == 5);
+        }
+
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(buffer, encrypt ? "user" : "");
+        auto& pages = doc.GetPages();
+
+        // The first page is available before the page tree is loaded
+        auto& firstPage = pages.GetPageAt(0);
+        REQUIRE(firstPage.GetIndex() == 0);
+        REQUIRE(firstPage.MustGetContents().GetCopy() == "BT (Page 0) Tj ET");
+
+        REQUIRE(pages.GetCount() == 5);
+        REQUIRE(&pages.GetPageAt(0) == &firstPage);
+        for (unsigned i = 0; i < 5; i++)
+        {
+            auto& page = pages.GetPageAt(i);
+            REQUIRE(page.MustGetContents().GetCopy() == utls::Format("BT (Page {}) Tj ET", i));
+            REQUIRE(page.GetDictionary().MustFindKey("Resources").GetDictionary().HasKey("ProcSet"));
+        }
+
+        auto& other = doc.GetCatalog().GetDictionary().MustFindKey("Other");
+        REQUIRE(other.GetDictionary().MustFindKey("Title").GetString().GetString() == "Other");
+
+        // Every XRef entry points to the object with the same number
+        for (auto obj : doc.GetObjects())
+        {
+            auto parserObj = dynamic_cast<PdfParserObject*>(obj);
+            REQUIRE(parserObj != nullptr);
+            auto& ref = obj->GetIndirectReference();
+            REQUIRE(view.substr(parserObj->GetOffset()).find(utls::Format("{} 0 obj", ref.ObjectNumber())) == 0);
+        }
+
+        // Decode the page offset hint table and compare it with the actual layout
+        size_t hintPos = view.find("/H[") + 3;
+        size_t hintLengthPos = view.find(' ', hintPos) + 1;
+        auto hintOffset = (ssize_t)std::stoll(string(view.substr(hintPos, hintLengthPos - 1 - hintPos)));
+        auto hintLength = (ssize_t)std::stoll(string(view.substr(hintLengthPos, view.find(']', hintLengthPos) - hintLengthPos)));
+        const PdfObject* hintObj = nullptr;
+        for (auto obj : doc.GetObjects())
+        {
+            if (static_cast<PdfParserObject*>(obj)->GetOffset() == hintOffset)
+                hintObj = obj;
+        }
+        REQUIRE(hintObj != nullptr);
+        REQUIRE(hintObj->GetDictionary().HasKey("S"));
+        auto hint = hintObj->MustGetStream().GetCopy();
+
+        size_t bitPos = 0;
+        auto read = [&](unsigned bitCount)
+        {
+            uint64_t value = 0;
+            for (unsigned i = 0; i < bitCount; i++, bitPos++)
+                value = (value << 1) | (((uint8_t)hint[bitPos / 8] >> (7 - bitPos % 8)) & 1);
+            return value;
+        };
+        auto align = [&]()
+        {
+            bitPos = (bitPos + 7) / 8 * 8;
+        };
+
+        uint64_t minObjectCount = read(32);
+        uint64_t pageOffset = read(32);
+        unsigned objectCountBits = (unsigned)read(16);
+        uint64_t minPageLength = read(32);
+        unsigned pageLengthBits = (unsigned)read(16);
+        bitPos += 32 + 16 + 32 + 16 + 16 + 16 + 16 + 16;
+        vector<uint64_t> objectCounts;
+        for (unsigned i = 0; i < 5; i++)
+            objectCounts.push_back(minObjectCount + read(objectCountBits));
+        align();
+        vector<uint64_t> pageLengths;
+        for (unsigned i = 0; i < 5; i++)
+            pageLengths.push_back(minPageLength + read(pageLengthBits));
+
+        // The first page also has the shared resources. The offsets
+        // in the hint tables are as if the hint stream was absent
+        REQUIRE(objectCounts[0] == 3);
+        if ((ssize_t)pageOffset >= hintOffset)
+            pageOffset += hintLength;
+
+        for (unsigned i = 0; i < 5; i++)
+        {
+            // Pages are written one after the other, starting
+            // with the page object, followed by its objects
+            auto& pageObj = static_cast<const PdfParserObject&>(pages.GetPageAt(i).GetObject());
+            REQUIRE((uint64_t)pageObj.GetOffset() == pageOffset);
+            unsigned count = 0;
+            for (auto obj : doc.GetObjects())
+            {
+                auto offset = (uint64_t)static_cast<PdfParserObject*>(obj)->GetOffset();
+                if (offset >= pageOffset && offset < pageOffset + pageLengths[i])
+                    count++;
+            }
+            REQUIRE(count == objectCounts[i]);
+            pageOffset += pageLengths[i];
+        }
+    }
+}
+
+TEST_CASE("TestLinearizationProbe")
+{
+    // The xref table of a document that doesn't start with an
+    // indirect object must still be found after the probe for
+    // the linearization dictionary failed, without rebuilding it
+    charbuff buffer;
+    {
+        PdfMemDocument doc;
+        doc.GetPages().CreatePage(PdfPageSize::A4);
+        BufferStreamDevice device(buffer);
+        doc.Save(device, PdfSaveOptions::NoMetadataUpdate);
+    }
+
+    // Turn the binary comment after the header into a token
+    size_t pos = buffer.find('\n') + 1;
+    REQUIRE(buffer[pos] == '%');
+    buffer[pos] = 'X';
+
+    SpanStreamDevice device(buffer);
+    PdfMemDocument doc;
+    PdfParser parser(doc.GetObjects());
+    parser.Parse(device, true);
+    REQUIRE(parser.GetXRefOffset() != 0);
+    REQUIRE(parser.GetTrailer().GetDictionary().MustGetKey("Root").IsReference());
+}
+
+TEST_CASE("TestXRefRecovery")
+{
+    auto createDocument = [](bool compress, bool encrypt)
+    {
+        PdfMemDocument doc;
+        for (unsigned i = 0; i < 10; i++)
+            doc.GetPages().CreatePage(PdfPageSize::A4);
+
+        for (unsigned i = 0; i < 30; i++)
+        {
+            auto& obj = doc.GetObjects().CreateDictionaryObject();
+            obj.GetDictionary().AddKey("Title"_n, PdfString(utls::Format("Object {}", i)));
+            doc.GetCatalog().GetDictionary().AddKey(PdfName(utls::Format("Obj{}", i)), obj.GetIndirectReference());
+        }
+
+        if (encrypt)
+            doc.SetEncrypted("user", "owner");
+
+        charbuff buffer;
+        BufferStreamDevice device(buffer);
+        doc.Save(device, PdfSaveOptions::NoMetadataUpdate
+            | (compress ? PdfSaveOptions::CompressObjects : PdfSaveOptions::None));
+        return buffer;
+    };
+
+    auto checkDocument = [](const charbuff& buffer, bool encrypt)
+    {
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(buffer, encrypt ? "user" : "");
+        REQUIRE(doc.GetPages().GetCount() == 10);
+        for (unsigned i = 0; i < 30; i++)
+        {
+            auto& obj = doc.GetCatalog().GetDictionary().MustFindKey(PdfName(utls::Format("Obj{}", i)));
+            REQUIRE(obj.GetDictionary().MustFindKey("Title").GetString().GetString() == utls::Format("Object {}", i));
+        }
+    };
+
+    // Point startxref to a wrong offset
+    auto breakStartXRef = [](charbuff buffer)
+    {
+        size_t pos = buffer.rfind("startxref") + 9;
+        while (PoDoFo::IsCharWhitespace(buffer[pos]))
+            pos++;
+
+        size_t end = pos;
+        while (std::isdigit((unsigned char)buffer[end]))
+            end++;
+
+        buffer.replace(pos, end - pos, "10");
+        return buffer;
+    };
+
+    for (bool compress : { false, true })
+    {
+        for (bool encrypt : { false, true })
+            checkDocument(breakStartXRef(createDocument(compress, encrypt)), encrypt);
+    }
+
+    auto buffer = createDocument(false, false);
+
+    // Shift all the offsets in the xref table, but not the table itself
+    auto shifted = buffer;
+    string_view garbage = "% Some garbage inserted after the header\n";
+    shifted.insert(shifted.find('\n') + 1, garbage);
+    size_t startXRef = shifted.rfind("startxref") + 10;
+    size_t xrefOffset = std::stoul(shifted.substr(startXRef));
+    shifted.replace(startXRef, std::to_string(xrefOffset).size(), std::to_string(xrefOffset + garbage.size()));
+    checkDocument(shifted, false);
+
+    // Remove the xref table and the trailer, so
+    // the catalog must be found by its type
+    auto truncated = buffer;
+    truncated.resize(truncated.rfind("\nxref") + 1);
+    checkDocument(truncated, false);
+
+    // Not a recoverable file
+    PdfMemDocument doc;
+    ASSERT_THROW_WITH_ERROR_CODE(doc.LoadFromBuffer(buffer.substr(0, 200)), PdfErrorCode::InvalidEOFToken);
+}
+
+TEST_CASE("TestXRefRecoveryObjectStreamLength")
+{
+    // An object stream with an indirect /Length and no xref table
+    string header = "3 0 4 30 5 66 6 116 ";
+    string body = "<</Type/Catalog/Pages 4 0 R>> <</Type/Pages/Kids[5 0 R]/Count 1>> "
+        "<</Type/Page/Parent 4 0 R/MediaBox[0 0 200 200]>> <</Title(Lazy)>>";
+    string buffer = "%PDF-1.5\n";
+    buffer.append(utls::Format("1 0 obj\n<</Type/ObjStm/N 4/First {}/Length 2 0 R>>\nstream\n", header.size()));
+    buffer.append(header);
+    buffer.append(body);
+    buffer.append(utls::Format("\nendstream\nendobj\n2 0 obj\n{}\nendobj\n", header.size() + body.size()));
+    buffer.append("trailer\n<</Root 3 0 R/Info 6 0 R>>\n%%EOF\n");
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(buffer);
+    REQUIRE(doc.GetPages().GetCount() == 1);
+    REQUIRE(doc.GetObjects().MustGetObject(PdfReference(6, 0)).GetDictionary().MustFindKey("Title").GetString() == "Lazy");
+
+    // The xref table was rebuilt, so it can't be updated incrementally
+    charbuff output;
+    BufferStreamDevice device(output);
+    ASSERT_THROW_WITH_ERROR_CODE(doc.SaveUpdate(device), PdfErrorCode::InvalidXRef);
+}
+
+string generateObjectStreamDocument(bool duplicateInfo)
+{
+    // Generate a document with objects 3-6 compressed in
+    // the object stream 1 0 R and a XRef stream 2 0 R
+    vector<pair<unsigned, string>> compressed = {
+        { 3, "<</Type/Catalog/Pages 4 0 R>>" },
+        { 4, "<</Type/Pages/Kids[5 0 R]/Count 1>>" },
+        { 5, "<</Type/Page/Parent 4 0 R/MediaBox[0 0 200 200]>>" },
+        { 6, "<</Title(Lazy)>>" },
+    };
+
+    // Optionally append a second occurrence of the object 6
+    if (duplicateInfo)
+        compressed.push_back({ 6, "<</Title(Duplicated)>>" });
+
+    string header;
+    string body;
+    for (auto& pair : compressed)
+    {
+        header.append(utls::Format("{} {} ", pair.first, body.size()));
+        body.append(pair.second);
+        body.push_back(' ');
+    }
+
+    string ret = "%PDF-1.5\n";
+    size_t objStmOffset = ret.size();
+    ret.append(utls::Format("1 0 obj\n<</Type/ObjStm/N {}/First {}/Length {}>>\nstream\n",
+        compressed.size(), header.size(), header.size() + body.size()));
+    ret.append(header);
+    ret.append(body);
+    ret.append("\nendstream\nendobj\n");
+
+    // Entries for objects 0-7 with /W [1 4 2]. Object 6 has a wrong
+    // index in the stream, object 7 is missing from the stream
+    size_t xrefOffset = ret.size();
+    string xref;
+    auto writeEntry = [&xref](unsigned type, unsigned field2, unsigned field3) {
+        xref.push_back((char)type);
+        for (int i = 3; i >= 0; i--)
+            xref.push_back((char)((field2 >> (i * 8)) & 0xFF));
+        xref.push_back((char)((field3 >> 8) & 0xFF));
+        xref.push_back((char)(field3 & 0xFF));
+    };
+    writeEntry(0, 0, 65535);
+    writeEntry(1, (unsigned)objStmOffset, 0);
+    writeEntry(1, (unsigned)xrefOffset, 0);
+    writeEntry(2, 1, 0);
+    writeEntry(2, 1, 1);
+    writeEntry(2, 1, 2);
+    writeEntry(2, 1, 0);
+    writeEntry(2, 1, 4);
+
+    ret.append(utls::Format("2 0 obj\n<</Type/XRef/Size 8/W[1 4 2]/Root 3 0 R/Info 6 0 R/Length {}>>\nstream\n", xref.size()));
+    ret.append(xref);
+    ret.append("\nendstream\nendobj\n");
+    ret.append(utls::Format("startxref\n{}\n%%EOF\n", xrefOffset));
+    return ret;
+}
 
 string generateXRefEntries(size_t count)
 {
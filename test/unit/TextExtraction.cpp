@@ -93,3 +93,167 @@ TEST_CASE("TextExtraction4")
 
     REQUIRE(abort);
 }
+
+TEST_CASE("TextExtractionMultiPage")
+{
+    charbuff buffer;
+    {
+        PdfMemDocument doc;
+        auto font = doc.GetFonts().SearchFont("LiberationSans");
+        if (font == nullptr)
+            FAIL("Could not find LiberationSans font");
+
+        PdfPainter painter;
+        for (unsigned i = 0; i < 12; i++)
+        {
+            auto& page = doc.GetPages().CreatePage(PdfPageSize::A4);
+            painter.SetCanvas(page);
+            painter.TextState.SetFont(*font, 12);
+            painter.DrawText(utls::Format("Page {} first line", i + 1), 100, 700);
+            painter.DrawText(utls::Format("Page {} second line", i + 1), 100, 600);
+            painter.FinishDrawing();
+        }
+
+        BufferStreamDevice device(buffer);
+        doc.Save(device);
+        doc.Save(TestUtils::GetTestOutputFilePath("TextExtractionMultiPage.pdf"));
+    }
+
+    vector<PdfTextEntry> expected;
+    {
+        PdfMemDocument doc;
+        doc.LoadFromBuffer(buffer);
+        for (unsigned i = 0; i < doc.GetPages().GetCount(); i++)
+            doc.GetPages().GetPageAt(i).ExtractTextTo(expected);
+    }
+    REQUIRE(expected.size() == 24);
+    REQUIRE(expected[23].Text == "Page 12 second line");
+
+    // Load from file, so the streams are read from a shared file device
+    PdfMemDocument doc;
+    doc.Load(TestUtils::GetTestOutputFilePath("TextExtractionMultiPage.pdf"));
+    vector<PdfTextEntry> entries;
+    doc.ExtractTextTo(entries, 0, numeric_limits<unsigned>::max(), { }, 4);
+    REQUIRE(entries.size() == expected.size());
+    for (unsigned i = 0; i < entries.size(); i++)
+    {
+        REQUIRE(entries[i].Text == expected[i].Text);
+        REQUIRE(entries[i].Page == expected[i].Page);
+        ASSERT_EQUAL(entries[i].X, expected[i].X);
+        ASSERT_EQUAL(entries[i].Y, expected[i].Y);
+    }
+
+    // Streams can be read by more readers at once, and
+    // written only when all the readers are done
+    auto& contents = doc.GetPages().GetPageAt(0).MustGetContents().GetObject();
+    auto& contentsStream = (contents.IsArray() ? *contents.GetArray().FindAt(0) : contents).MustGetStream();
+    {
+        auto input1 = contentsStream.GetInputStream();
+        {
+            auto input2 = contentsStream.GetInputStream();
+        }
+        ASSERT_THROW_WITH_ERROR_CODE(contentsStream.SetData("q Q"sv), PdfErrorCode::InternalLogic);
+    }
+    contentsStream.SetData("q Q"sv);
+    REQUIRE(contentsStream.GetCopy() == "q Q");
+
+    // Extract a range, running on the current thread only
+    entries.clear();
+    doc.ExtractTextTo(entries, 10, 5, { }, 1);
+    REQUIRE(entries.size() == 4);
+    REQUIRE(entries[0].Text == "Page 11 first line");
+}
+
+TEST_CASE("TextExtractionCallback")
+{
+    charbuff buffer;
+    {
+        PdfMemDocument doc;
+        auto font = doc.GetFonts().SearchFont("LiberationSans");
+        if (font == nullptr)
+            FAIL("Could not find LiberationSans font");
+
+        auto& page = doc.GetPages().CreatePage(PdfPageSize::A4);
+        PdfPainter painter;
+        painter.SetCanvas(page);
+        painter.TextState.SetFont(*font, 12);
+        for (unsigned i = 0; i < 20; i++)
+            painter.DrawText(utls::Format("Line {} of the test text", i + 1), 100, 750 - i * 20.0);
+
+        painter.FinishDrawing();
+        BufferStreamDevice device(buffer);
+        doc.Save(device);
+    }
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(buffer);
+    auto& page = doc.GetPages().GetPageAt(0);
+    vector<PdfTextEntry> expected;
+    page.ExtractTextTo(expected);
+    REQUIRE(expected.size() == 20);
+
+    unsigned count = 0;
+    page.ExtractTextTo([&](const PdfTextEntryView& entry) {
+        REQUIRE(count < expected.size());
+        REQUIRE(entry.Text == expected[count].Text);
+        REQUIRE(entry.Page == expected[count].Page);
+        ASSERT_EQUAL(entry.X, expected[count].X);
+        ASSERT_EQUAL(entry.Y, expected[count].Y);
+        ASSERT_EQUAL(entry.Length, expected[count].Length);
+        count++;
+    });
+    REQUIRE(count == expected.size());
+
+    // Search a pattern
+    count = 0;
+    page.ExtractTextTo([&](const PdfTextEntryView& entry) {
+        REQUIRE(entry.Text == "Line 7 of the test text");
+        count++;
+    }, "Line 7 of", { { }, PdfTextExtractFlags::None });
+    REQUIRE(count == 1);
+}
+
+TEST_CASE("TextExtractionDecodeTable")
+{
+    // Fonts loaded from the document decode strings with a
+    // table, both for 1 byte and 2 bytes encodings
+    charbuff buffer;
+    double simpleLength;
+    double cidLength;
+    {
+        PdfMemDocument doc;
+        auto& simpleFont = doc.GetFonts().GetStandard14Font(PdfStandard14FontType::Helvetica);
+        auto cidFont = doc.GetFonts().SearchFont("LiberationSans");
+        if (cidFont == nullptr)
+            FAIL("Could not find LiberationSans font");
+
+        auto& page = doc.GetPages().CreatePage(PdfPageSize::A4);
+        PdfPainter painter;
+        painter.SetCanvas(page);
+        painter.TextState.SetFont(simpleFont, 12);
+        painter.DrawText("Simple font àèìòù", 100, 700);
+        painter.TextState.SetFont(*cidFont, 12);
+        painter.DrawText("CID font àèìòù €", 100, 600);
+        painter.FinishDrawing();
+
+        PdfTextState state;
+        state.FontSize = 12;
+        state.Font = &simpleFont;
+        simpleLength = simpleFont.GetStringLength("Simple font àèìòù", state);
+        state.Font = cidFont;
+        cidLength = cidFont->GetStringLength("CID font àèìòù €", state);
+
+        BufferStreamDevice device(buffer);
+        doc.Save(device);
+    }
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(buffer);
+    vector<PdfTextEntry> entries;
+    doc.GetPages().GetPageAt(0).ExtractTextTo(entries);
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].Text == "Simple font àèìòù");
+    ASSERT_EQUAL(entries[0].Length, simpleLength);
+    REQUIRE(entries[1].Text == "CID font àèìòù €");
+    ASSERT_EQUAL(entries[1].Length, cidLength);
+}
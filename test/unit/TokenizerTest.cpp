@@ -7,6 +7,7 @@
  */
 
 #include <PdfTest.h>
+#include <podofo/main/PdfVariantStack.h>
 
 using namespace std;
 using namespace PoDoFo;
@@ -102,6 +103,44 @@ TEST_CASE("TestReference")
     Test("4 1 R", PdfDataType::Reference);
 }
 
+TEST_CASE("TestNumbersAndReferences")
+{
+    SpanStreamDevice device("1 2 3 0 R 4 5 RG 6\n0 R%comment\n7 8 R 9 10 11 %comment\n0 R 12 0 %comment\nR");
+    PdfTokenizer tokenizer;
+    PdfVariant variant;
+    string_view token;
+    auto readNumber = [&](int64_t expected) {
+        REQUIRE(tokenizer.TryReadNextVariant(device, variant));
+        REQUIRE(variant.GetDataType() == PdfDataType::Number);
+        REQUIRE(variant.GetNumber() == expected);
+    };
+    auto readReference = [&](const PdfReference& expected) {
+        REQUIRE(tokenizer.TryReadNextVariant(device, variant));
+        REQUIRE(variant.GetDataType() == PdfDataType::Reference);
+        REQUIRE(variant.GetReference() == expected);
+    };
+
+    readNumber(1);
+    readNumber(2);
+    readReference(PdfReference(3, 0));
+    readNumber(4);
+    readNumber(5);
+    REQUIRE(tokenizer.TryPeekNextToken(device, token));
+    REQUIRE(token == "RG");
+    REQUIRE(tokenizer.TryReadNextToken(device, token));
+    REQUIRE(token == "RG");
+    readReference(PdfReference(6, 0));
+    readReference(PdfReference(7, 8));
+    REQUIRE(tokenizer.TryPeekNextToken(device, token));
+    REQUIRE(token == "9");
+    readNumber(9);
+    readNumber(10);
+    // Comments inside references are skipped
+    readReference(PdfReference(11, 0));
+    readReference(PdfReference(12, 0));
+    REQUIRE(!tokenizer.TryReadNextToken(device, token));
+}
+
 TEST_CASE("TestString")
 {
     // testing strings
@@ -181,6 +220,78 @@ TEST_CASE("TestLocale")
     setlocale(LC_ALL, old);
 }
 
+TEST_CASE("TestContentStreamOperands")
+{
+    string_view buffer =
+        "/F#31 12 Tf 1 0 0 1 72.5 700 Tm (Hello \\(world\\)) Tj <48656C6C6F2> Tj [(A) -120 (B)] TJ "
+        "/P <</MCID 0>> BDC true null 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 scn";
+    PdfContentStreamReader reader(std::make_shared<SpanStreamDevice>(buffer));
+    PdfContent content;
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::Tf);
+    REQUIRE(content.Stack.GetSize() == 2);
+    REQUIRE(content.Stack[0].GetNumber() == 12);
+    REQUIRE(content.Stack[0].GetReal() == 12);
+    REQUIRE(content.Stack[1].GetNameRaw() == "F#31");
+    REQUIRE(content.Stack[1].GetName() == "F1");
+    REQUIRE(!content.Stack[1].IsNumberOrReal());
+    PdfOperandStack tfCopy = content.Stack;
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::Tm);
+    REQUIRE(content.Stack.GetSize() == 6);
+    REQUIRE(content.Stack[0].GetNumber() == 700);
+    REQUIRE(content.Stack[1].GetDataType() == PdfDataType::Real);
+    REQUIRE(content.Stack[1].GetReal() == 72.5);
+    REQUIRE(content.Stack[5].GetReal() == 1);
+
+    // Operands of a copied stack refer to the copied buffers
+    REQUIRE(tfCopy[1].GetNameRaw() == "F#31");
+
+    // The deprecated variant stack can still be created from the operands
+    PdfVariantStack tfVariants = tfCopy;
+    REQUIRE(tfVariants.GetSize() == 2);
+    REQUIRE(tfVariants[0].GetNumber() == 12);
+    REQUIRE(tfVariants[1].GetName() == "F1");
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::Tj);
+    REQUIRE(content.Stack[0].GetStringRaw() == "Hello (world)");
+    REQUIRE(!content.Stack[0].IsHexString());
+    REQUIRE(content.Stack[0].GetString() == "Hello (world)");
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::Tj);
+    REQUIRE(content.Stack[0].IsHexString());
+    REQUIRE(content.Stack[0].GetStringRaw() == string_view("Hello ", 6));
+    REQUIRE(content.Stack[0].ToVariant().GetString().IsHex());
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::TJ);
+    auto& arr = content.Stack[0].GetArray();
+    REQUIRE(arr.GetSize() == 3);
+    REQUIRE(arr[1].GetNumber() == -120);
+
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::BDC);
+    REQUIRE(content.Stack[0].GetDictionary().MustFindKey("MCID").GetNumber() == 0);
+    REQUIRE(content.Stack.GetVariant(1).GetName() == "P");
+    ASSERT_THROW_WITH_ERROR_CODE(content.Stack[0].GetReal(), PdfErrorCode::InvalidDataType);
+
+    // Exceed the inline capacity of the stack
+    REQUIRE(reader.TryReadNext(content));
+    REQUIRE(content.Operator == PdfOperator::scn);
+    REQUIRE(content.Stack.GetSize() == 20);
+    for (unsigned i = 0; i < 18; i++)
+        REQUIRE(content.Stack[i].GetNumber() == 19 - i);
+    REQUIRE(content.Stack[18].GetDataType() == PdfDataType::Null);
+    REQUIRE(content.Stack[19].GetBool());
+
+    REQUIRE(!reader.TryReadNext(content));
+    REQUIRE(content.Stack.GetSize() == 0);
+}
+
 void Test(const string_view& buffer, PdfDataType dataType, string_view expected)
 {
     expected = expected.empty() ? buffer : expected;
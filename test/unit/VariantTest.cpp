@@ -170,6 +170,61 @@ TEST_CASE("TestIsDirtyFalse")
     TestObjectsDirty(objBool, objNum, objReal, objStr, objRef, objArray, objDict, objStream, objVariant, false);
 }
 
+TEST_CASE("TestDictionaryEntries")
+{
+    auto device = std::make_shared<SpanStreamDevice>(
+        "10 0 obj<</Type/Test/Z 1/A 2/M<</X 1>>/B[1 2]/Y 4/C 5/Length 0>>endobj\n"sv);
+    PdfParserObject parserObj(*device);
+    auto& dict = parserObj.GetDictionary();
+    REQUIRE(!parserObj.IsDirty());
+    REQUIRE(dict.GetSize() == 8);
+
+    // Entries are iterated sorted by key
+    string keys;
+    for (auto& pair : dict)
+    {
+        keys.append(pair.first.GetString());
+        REQUIRE(pair.second.GetParent() == &dict);
+    }
+    REQUIRE(keys == "ABCLengthMTypeYZ");
+
+    // Values must keep their address when other keys are added
+    PdfDictionary dict2;
+    auto& first = dict2.AddKey("K"_n, PdfDictionary());
+    for (unsigned i = 0; i < 100; i++)
+    {
+        auto& obj = dict2.AddKey(PdfName(utls::Format("K{}", 99 - i)), PdfDictionary());
+        obj.GetDictionary().AddKey("N"_n, static_cast<int64_t>(99 - i));
+    }
+    REQUIRE(dict2.GetSize() == 101);
+    REQUIRE(dict2.GetKey("K") == &first);
+    REQUIRE(first.GetDictionary().GetOwner() == &first);
+    for (unsigned i = 0; i < 100; i++)
+    {
+        auto& obj = dict2.MustGetKey(utls::Format("K{}", i));
+        REQUIRE(obj.GetParent() == &dict2);
+        REQUIRE(obj.GetDictionary().GetOwner() == &obj);
+        REQUIRE(obj.GetDictionary().MustGetKey("N").GetNumber() == (int64_t)i);
+    }
+
+    REQUIRE(dict2.RemoveKey("K50"));
+    REQUIRE(!dict2.RemoveKey("K50"));
+    REQUIRE(!dict2.HasKey("K50"));
+    REQUIRE(dict2.HasKey("K51"));
+    REQUIRE(dict2.GetSize() == 100);
+    REQUIRE(dict2.GetKey("K") == &first);
+
+    PdfDictionary dict3(dict2);
+    REQUIRE(dict3 == dict2);
+    dict3.AddKey("K50"_n, PdfObject());
+    REQUIRE(dict3.GetSize() == 101);
+    REQUIRE(dict3 != dict2);
+    dict3 = dict2;
+    REQUIRE(dict3.GetSize() == 100);
+    for (auto& pair : dict3)
+        REQUIRE(pair.second.GetParent() == &dict3);
+}
+
 void TestObjectsDirty(
     const PdfObject& objBool,
     const PdfObject& objNum,